@@ -0,0 +1,184 @@
+/**
+ * @file Calibration.c
+ *
+ * @brief Source code for the stimulus-to-capture latency calibration.
+ *
+ * This file contains the function definitions for the latency calibration.
+ *
+ * @note The pair results are kept as 16-bit tick counts (4 KB for CALIBRATION_PAIRS), so
+ * the median and the jitter histogram are exact rather than estimated. The offset is
+ * saved in the low 16 bits of its setting, which can never read back as an erased word.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Calibration.h"
+#include "GPIO.h"
+#include "Power.h"
+#include "Session_Log.h"
+#include "Statistics.h"
+#include "SysTick_Delay.h"
+#include "Timer_2A_Capture.h"
+#include "Timer_3A_Capture.h"
+
+// Polls of the capture status before the loopback wire is taken to be missing (the edge
+// is latched a few clock cycles after the store)
+#define CALIBRATION_CAPTURE_POLLS    100
+
+// Setting value when no offset has been saved (an erased EEPROM word)
+#define CALIBRATION_NOT_SAVED        0xFFFFFFFF
+
+static int16_t calibration_samples[CALIBRATION_PAIRS];
+static Calibration_Stats calibration_stats;
+static uint8_t calibration_valid = 0;
+
+// Shell sort (Ciura gaps), small and fast enough for a few thousand samples
+static void Calibration_Sort(int16_t *samples, uint16_t count)
+{
+    static const uint16_t gaps[] = { 701, 301, 132, 57, 23, 10, 4, 1 };
+    
+    for (uint8_t g = 0; g < (sizeof(gaps) / sizeof(gaps[0])); g++)
+    {
+        uint16_t gap = gaps[g];
+        
+        for (uint16_t i = gap; i < count; i++)
+        {
+            int16_t value = samples[i];
+            uint16_t j = i;
+            
+            while ((j >= gap) && (samples[j - gap] > value))
+            {
+                samples[j] = samples[j - gap];
+                j -= gap;
+            }
+            samples[j] = value;
+        }
+    }
+}
+
+static uint8_t Calibration_Histogram_Bin(uint32_t distance_ticks)
+{
+    uint8_t bin = 0;
+    
+    // Bin n holds distances from 2^(n-1) to 2^n - 1
+    while ((distance_ticks > 0) && (bin < (CALIBRATION_HISTOGRAM_BINS - 1)))
+    {
+        distance_ticks >>= 1;
+        bin++;
+    }
+    
+    return bin;
+}
+
+static void Calibration_Summarize(uint16_t count)
+{
+    Calibration_Stats *stats = &calibration_stats;
+    int64_t sum = 0;
+    uint64_t squares = 0;
+    
+    Calibration_Sort(calibration_samples, count);
+    
+    stats->pairs = count;
+    stats->min_ticks = calibration_samples[0];
+    stats->max_ticks = calibration_samples[count - 1];
+    stats->offset_ticks = calibration_samples[count / 2];
+    
+    for (uint16_t i = 0; i < count; i++)
+    {
+        sum += calibration_samples[i];
+    }
+    stats->mean_ticks_x100 = (int32_t)((sum * 100) / count);
+    
+    // Second pass around the mean, in hundredths of a tick, so the sum of squares fits in 64 bits
+    for (uint8_t bin = 0; bin < CALIBRATION_HISTOGRAM_BINS; bin++)
+    {
+        stats->histogram[bin] = 0;
+    }
+    for (uint16_t i = 0; i < count; i++)
+    {
+        int64_t deviation = ((int64_t)calibration_samples[i] * 100) - stats->mean_ticks_x100;
+        int32_t distance = calibration_samples[i] - stats->offset_ticks;
+        
+        squares += (uint64_t)(deviation * deviation);
+        stats->histogram[Calibration_Histogram_Bin((distance < 0) ? -distance : distance)]++;
+    }
+    stats->std_dev_ticks_x100 = (count > 1) ? Statistics_Square_Root(squares / (count - 1)) : 0;
+}
+
+void Calibration_Init(void)
+{
+    uint32_t saved = Session_Log_Load_Setting(SESSION_LOG_SETTING_LATENCY_OFFSET, CALIBRATION_NOT_SAVED);
+    
+    calibration_stats.pairs = 0;
+    if (saved != CALIBRATION_NOT_SAVED)
+    {
+        calibration_stats.offset_ticks = (int16_t)(saved & 0xFFFF);
+        calibration_valid = 1;
+        Set_Latency_Offset(calibration_stats.offset_ticks);
+    }
+}
+
+uint8_t Calibration_Run(void)
+{
+    uint32_t counter_value;
+    uint8_t level = 0;
+    uint32_t last_tick = SysTick_Get_Current_Time();
+    
+    // Starts from a low output and discards any edge latched before
+    Loopback_Set(0);
+    Timer_3A_Capture_Read(&counter_value);
+    
+    for (uint16_t pair = 0; pair < CALIBRATION_PAIRS; pair++)
+    {
+        // Drives each stimulus just after a SysTick tick, where the game's timers expire
+        while (SysTick_Get_Current_Time() == last_tick)
+        {
+            Power_Sleep();
+        }
+        last_tick = SysTick_Get_Current_Time();
+        
+        // The same two steps as a game's stimulus onset: the masked store, then the stamp
+        level = !level;
+        Loopback_Set(level);
+        Mark_Start_Time();
+        
+        uint8_t polls = 0;
+        while (!Timer_3A_Capture_Read(&counter_value))
+        {
+            polls++;
+            if (polls >= CALIBRATION_CAPTURE_POLLS)
+            {
+                // No loopback edge: the previous offset stays in effect
+                Loopback_Set(0);
+                return 0;
+            }
+        }
+        
+        int64_t offset = (int64_t)(Timer_2A_Get_Time_Ticks_At(counter_value) - Get_Start_Time_Ticks());
+        if (offset > CALIBRATION_MAX_OFFSET_TICKS)
+        {
+            offset = CALIBRATION_MAX_OFFSET_TICKS;
+        }
+        else if (offset < -CALIBRATION_MAX_OFFSET_TICKS)
+        {
+            offset = -CALIBRATION_MAX_OFFSET_TICKS;
+        }
+        calibration_samples[pair] = (int16_t)offset;
+    }
+    
+    Calibration_Summarize(CALIBRATION_PAIRS);
+    calibration_valid = 1;
+    Set_Latency_Offset(calibration_stats.offset_ticks);
+    Session_Log_Save_Setting(SESSION_LOG_SETTING_LATENCY_OFFSET, (uint32_t)calibration_stats.offset_ticks & 0xFFFF);
+    return 1;
+}
+
+uint8_t Calibration_Is_Calibrated(void)
+{
+    return calibration_valid;
+}
+
+void Calibration_Get_Stats(Calibration_Stats *stats)
+{
+    *stats = calibration_stats;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file Calibration.h
+ *
+ * @brief Header file for the stimulus-to-capture latency calibration.
+ *
+ * This file contains the function prototypes and definitions for the latency calibration.
+ * A reported reaction time is the press capture minus the stimulus onset stamp, so it also
+ * contains the time from the LED store to the onset stamp (taken in software just after it)
+ * and from the button edge to its capture (the input synchronizer and the timer's edge
+ * detector). The calibration measures that fixed offset with a loopback wire from PB3 to
+ * PB2 and subtracts it from every reaction time.
+ *
+ * Procedure:
+ *  - CALIBRATION_PAIRS synthetic stimulus/response pairs, one per SysTick tick, so each
+ *    stimulus is driven from the same point in the main loop as a game's stimulus onset
+ *  - Each pair toggles PB3 with the same masked store as LED_Set, stamps the onset with
+ *    Mark_Start_Time, and reads the PB2 edge latched by Timer 3A (see Timer_3A_Capture.h)
+ *  - The offset is the median of capture minus onset in timer ticks, so interrupts that
+ *    land between the store and the stamp only show up in the jitter figures
+ *  - The offset is applied to the press timestamps and saved in the EEPROM settings
+ *
+ * Jitter Histogram:
+ *  - Bin 0 counts pairs at exactly the offset, and bin n (n >= 1) pairs between 2^(n-1)
+ *    and 2^n - 1 ticks from it, with the last bin open-ended
+ *
+ * @note On the host simulator the loopback is modeled: code runs in zero virtual time and
+ * the capture is delayed by the modeled input synchronizer, so the offset is that delay
+ * and the jitter is zero.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Stimulus/response pairs per calibration (one per millisecond)
+#define CALIBRATION_PAIRS             2000
+
+// Jitter histogram bins (powers of two in ticks, see above)
+#define CALIBRATION_HISTOGRAM_BINS    9
+
+// Largest offset accepted and stored, in ticks (16-bit signed)
+#define CALIBRATION_MAX_OFFSET_TICKS  32767
+
+// Calibration results
+typedef struct
+{
+    uint16_t pairs;                 // 0 when no calibration has run since reset
+    int32_t offset_ticks;           // Median, subtracted from reaction times
+    int32_t min_ticks;
+    int32_t max_ticks;
+    int32_t mean_ticks_x100;        // In hundredths of a tick
+    uint32_t std_dev_ticks_x100;    // Sample standard deviation, in hundredths of a tick
+    uint16_t histogram[CALIBRATION_HISTOGRAM_BINS];
+} Calibration_Stats;
+
+// Function Prototypes
+void Calibration_Init(void);                  // Applies the saved offset (Session_Log_Init first)
+uint8_t Calibration_Run(void);                 // Returns 0 when the loopback wire is missing
+uint8_t Calibration_Is_Calibrated(void);
+void Calibration_Get_Stats(Calibration_Stats *stats);
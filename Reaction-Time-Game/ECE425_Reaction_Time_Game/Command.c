@@ -0,0 +1,183 @@
+/**
+ * @file Command.c
+ *
+ * @brief Source code for the command line.
+ *
+ * This file contains the function definitions for the command line.
+ *
+ * @note The line is tokenized in place: the spaces after each word are overwritten with
+ * nulls, so the handlers receive pointers into the line buffer.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+#include "Command.h"
+#include "UART.h"
+
+// ASCII Character Definitions
+#define COMMAND_DEL    0x7F    // Delete, sent for backspace by most terminals
+
+static char command_line[COMMAND_LINE_SIZE];
+static uint8_t command_length = 0;
+static uint8_t command_complete = 0;
+static char command_previous = 0;
+
+uint8_t Command_Strings_Equal(const char *a, const char *b)
+{
+    while (*a && (*a == *b))
+    {
+        a++;
+        b++;
+    }
+    
+    return *a == *b;
+}
+
+uint8_t Command_Edit(char character)
+{
+    char previous = command_previous;
+    
+    command_previous = character;
+    
+    // The first character after a completed line starts the next one
+    if (command_complete)
+    {
+        command_complete = 0;
+        command_length = 0;
+    }
+    
+    // A line feed right after a carriage return is the second half of a CRLF ending
+    if ((character == UART0_CR) || ((character == UART0_LF) && (previous != UART0_CR)))
+    {
+        command_line[command_length] = 0;
+        command_complete = 1;
+        return 1;
+    }
+    
+    if ((character == UART0_BS) || (character == COMMAND_DEL))
+    {
+        if (command_length > 0)
+        {
+            command_length--;
+            UART0_Output_String("\b \b");
+        }
+    }
+    else if ((character >= ' ') && (character <= '~') && (command_length < (COMMAND_LINE_SIZE - 1)))
+    {
+        command_line[command_length] = character;
+        command_length++;
+        UART0_Output_Character(character);
+    }
+    
+    return 0;
+}
+
+uint8_t Command_Line_Pending(void)
+{
+    return !command_complete && (command_length > 0);
+}
+
+char *Command_Get_Line(void)
+{
+    return command_line;
+}
+
+uint8_t Command_Execute(const Command *table, uint8_t count)
+{
+    char *argv[COMMAND_MAX_ARGUMENTS];
+    uint8_t argc = 0;
+    char *pt = command_line;
+    
+    // Splits the line into words, counting any words past the limit so they are rejected
+    while (*pt)
+    {
+        if (*pt == ' ')
+        {
+            *pt = 0;
+            pt++;
+            continue;
+        }
+        
+        if (argc < COMMAND_MAX_ARGUMENTS)
+        {
+            argv[argc] = pt;
+        }
+        argc++;
+        
+        while (*pt && (*pt != ' '))
+        {
+            pt++;
+        }
+    }
+    
+    if (argc == 0)
+    {
+        return COMMAND_EMPTY;
+    }
+    
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (Command_Strings_Equal(argv[0], table[i].name))
+        {
+            if ((argc < (table[i].min_arguments + 1)) || (argc > (table[i].max_arguments + 1)))
+            {
+                UART0_Printf("Usage: %s\r\n", table[i].usage);
+                return COMMAND_BAD_ARGUMENTS;
+            }
+            
+            (*table[i].handler)(argc, argv);
+            return COMMAND_DONE;
+        }
+    }
+    
+    UART0_Printf("Unknown command: %s (type help for a list)\r\n", argv[0]);
+    return COMMAND_UNKNOWN;
+}
+
+uint8_t Command_Parse_Unsigned(const char *text, uint32_t *value)
+{
+    uint32_t number = 0;
+    
+    if (*text == 0)
+    {
+        return 0;
+    }
+    
+    // Rejects anything but digits, and any number above 4,294,967,295
+    while (*text)
+    {
+        if ((*text < '0') || (*text > '9'))
+        {
+            return 0;
+        }
+        
+        uint32_t digit = (uint32_t)(*text - '0');
+        if (number > ((UINT32_MAX - digit) / 10))
+        {
+            return 0;
+        }
+        
+        number = (10 * number) + digit;
+        text++;
+    }
+    
+    *value = number;
+    return 1;
+}
+
+uint8_t Command_Parse_On_Off(const char *text, uint8_t *value)
+{
+    if (Command_Strings_Equal(text, "on"))
+    {
+        *value = 1;
+        return 1;
+    }
+    if (Command_Strings_Equal(text, "off"))
+    {
+        *value = 0;
+        return 1;
+    }
+    
+    return 0;
+}
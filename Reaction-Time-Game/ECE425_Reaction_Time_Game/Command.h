@@ -0,0 +1,55 @@
+/**
+ * @file Command.h
+ *
+ * @brief Header file for the command line.
+ *
+ * This file contains the function prototypes and definitions for the command line, an
+ * incremental line editor and a tokenizing command parser. The main loop feeds it one
+ * received character at a time with Command_Edit, which never waits, and runs the line
+ * against a command table with Command_Execute once it is complete.
+ *
+ * Line Editing:
+ *  - Printable characters are appended and echoed, up to COMMAND_LINE_SIZE - 1 of them
+ *  - Backspace or delete erases the last character on the terminal as well
+ *  - Carriage return, line feed or both end the line, so scripts with any line ending work
+ *
+ * Parsing:
+ *  - The line is split into at most COMMAND_MAX_ARGUMENTS words at spaces
+ *  - The first word selects the command, and the argument count is checked against the
+ *    table before the handler is called
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Longest line, including the terminating null
+#define COMMAND_LINE_SIZE        64
+
+// Most words on a line, including the command name
+#define COMMAND_MAX_ARGUMENTS    4
+
+// Command_Execute results
+#define COMMAND_DONE             0
+#define COMMAND_EMPTY            1    // Blank line
+#define COMMAND_UNKNOWN          2
+#define COMMAND_BAD_ARGUMENTS    3
+
+// Command table entry
+typedef struct
+{
+    const char *name;
+    const char *usage;                  // Shown by the help command and after a bad argument count
+    uint8_t min_arguments;              // Not counting the command name
+    uint8_t max_arguments;
+    void (*handler)(uint8_t argc, char *argv[]);
+} Command;
+
+// Function Prototypes
+uint8_t Command_Edit(char character);    // Returns 1 when the line is complete
+uint8_t Command_Line_Pending(void);
+char *Command_Get_Line(void);
+uint8_t Command_Execute(const Command *table, uint8_t count);
+uint8_t Command_Parse_Unsigned(const char *text, uint32_t *value);
+uint8_t Command_Parse_On_Off(const char *text, uint8_t *value);    // "on" or "off"
+uint8_t Command_Strings_Equal(const char *a, const char *b);
@@ -0,0 +1,204 @@
+/**
+ * @file Dashboard.c
+ *
+ * @brief Source code for the diff-based ANSI terminal dashboard.
+ *
+ * This file contains the function definitions for the dashboard.
+ *
+ * @note The next frame and the shadow copy take DASHBOARD_ROWS * DASHBOARD_COLUMNS bytes
+ * each. Updates are built in a buffer the size of a uDMA staging buffer and sent in
+ * pieces only if a redraw does not fit.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdarg.h>
+#include "Dashboard.h"
+#include "Format.h"
+#include "UART.h"
+
+// Unchanged cells between two runs that are re-sent rather than skipped with a cursor move
+// ("\033[r;cH" is 6 to 8 bytes)
+#define DASHBOARD_MERGE_GAP    6
+
+// Next frame, and what the terminal shows
+static char dashboard_frame[DASHBOARD_ROWS][DASHBOARD_COLUMNS];
+static char dashboard_shown[DASHBOARD_ROWS][DASHBOARD_COLUMNS];
+
+// Output buffer for one update
+static char dashboard_output[UART0_DMA_STAGE_SIZE];
+static uint16_t dashboard_output_length = 0;
+static uint16_t dashboard_update_bytes = 0;
+
+static Dashboard_Stats dashboard_stats;
+static uint8_t dashboard_redraw = 0;
+
+static void Dashboard_Send(void)
+{
+    if (dashboard_output_length > 0)
+    {
+        UART0_Write_DMA(dashboard_output, dashboard_output_length);
+        dashboard_output_length = 0;
+    }
+}
+
+static void Dashboard_Emit(const char *data, uint16_t length)
+{
+    if ((dashboard_output_length + length) > sizeof(dashboard_output))
+    {
+        Dashboard_Send();
+    }
+    
+    for (uint16_t i = 0; i < length; i++)
+    {
+        dashboard_output[dashboard_output_length++] = data[i];
+    }
+    dashboard_update_bytes += length;
+}
+
+static void Dashboard_Move_Cursor(uint8_t row, uint8_t column)
+{
+    char sequence[12];
+    uint16_t length = Format_String(sequence, sizeof(sequence), "\033[%u;%uH", row + 1, column + 1);
+    
+    Dashboard_Emit(sequence, length);
+}
+
+void Dashboard_Begin(void)
+{
+    UART0_Clear_Screen();
+    
+    for (uint8_t row = 0; row < DASHBOARD_ROWS; row++)
+    {
+        for (uint8_t column = 0; column < DASHBOARD_COLUMNS; column++)
+        {
+            dashboard_shown[row][column] = ' ';
+            dashboard_frame[row][column] = ' ';
+        }
+    }
+    dashboard_redraw = 1;
+}
+
+void Dashboard_Clear(void)
+{
+    for (uint8_t row = 0; row < DASHBOARD_ROWS; row++)
+    {
+        for (uint8_t column = 0; column < DASHBOARD_COLUMNS; column++)
+        {
+            dashboard_frame[row][column] = ' ';
+        }
+    }
+}
+
+void Dashboard_Printf(uint8_t row, uint8_t column, const char *format, ...)
+{
+    char text[DASHBOARD_COLUMNS + 1];
+    va_list args;
+    
+    if ((row >= DASHBOARD_ROWS) || (column >= DASHBOARD_COLUMNS))
+    {
+        return;
+    }
+    
+    va_start(args, format);
+    Format_Vector(text, sizeof(text), format, args);
+    va_end(args);
+    
+    // Text past the right edge of the grid is cut off
+    for (uint8_t i = 0; (text[i] != '\0') && (column < DASHBOARD_COLUMNS); i++, column++)
+    {
+        dashboard_frame[row][column] = text[i];
+    }
+}
+
+void Dashboard_Put(uint8_t row, uint8_t column, char character)
+{
+    if ((row < DASHBOARD_ROWS) && (column < DASHBOARD_COLUMNS))
+    {
+        dashboard_frame[row][column] = character;
+    }
+}
+
+uint16_t Dashboard_Update(void)
+{
+    uint8_t cursor_row = 0xFF;    // Unknown: other output may have moved it since the last update
+    uint8_t cursor_column = 0xFF;
+    
+    for (uint8_t row = 0; row < DASHBOARD_ROWS; row++)
+    {
+        uint8_t column = 0;
+        
+        while (column < DASHBOARD_COLUMNS)
+        {
+            if (dashboard_frame[row][column] == dashboard_shown[row][column])
+            {
+                column++;
+                continue;
+            }
+            
+            // Extends the run over later changes, across gaps shorter than a cursor move
+            uint8_t start = column;
+            uint8_t end = column + 1;
+            for (uint8_t next = end; next < DASHBOARD_COLUMNS; next++)
+            {
+                if (dashboard_frame[row][next] == dashboard_shown[row][next])
+                {
+                    if ((next - end) >= DASHBOARD_MERGE_GAP)
+                    {
+                        break;
+                    }
+                    continue;
+                }
+                end = next + 1;
+            }
+            
+            if ((cursor_row != row) || (cursor_column != start))
+            {
+                Dashboard_Move_Cursor(row, start);
+            }
+            Dashboard_Emit(&dashboard_frame[row][start], end - start);
+            
+            for (uint8_t i = start; i < end; i++)
+            {
+                dashboard_shown[row][i] = dashboard_frame[row][i];
+            }
+            cursor_row = row;
+            cursor_column = end;
+            column = end;
+        }
+    }
+    
+    if (cursor_row == 0xFF)
+    {
+        return 0;
+    }
+    
+    // Parks the cursor below the grid
+    Dashboard_Move_Cursor(DASHBOARD_ROWS, 0);
+    Dashboard_Send();
+    
+    uint16_t bytes = dashboard_update_bytes;
+    dashboard_update_bytes = 0;
+    
+    // The first frame after Dashboard_Begin is a redraw, counted on its own
+    if (dashboard_redraw)
+    {
+        dashboard_redraw = 0;
+        dashboard_stats.redraws++;
+        dashboard_stats.redraw_bytes += bytes;
+        return bytes;
+    }
+    
+    dashboard_stats.updates++;
+    dashboard_stats.total_bytes += bytes;
+    if (bytes > dashboard_stats.max_bytes)
+    {
+        dashboard_stats.max_bytes = bytes;
+    }
+    return bytes;
+}
+
+void Dashboard_Get_Stats(Dashboard_Stats *stats)
+{
+    *stats = dashboard_stats;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file Dashboard.h
+ *
+ * @brief Header file for the diff-based ANSI terminal dashboard.
+ *
+ * This file contains the function prototypes and definitions for the dashboard. The
+ * dashboard is a fixed grid of character cells at the top of the terminal. The caller
+ * draws the next frame into the grid, and Dashboard_Update compares it with a shadow copy
+ * of what the terminal already shows and sends only the cursor moves and changed cells.
+ *
+ * Update Encoding:
+ *  - Changed cells are sent in runs, each run after an ANSI cursor position sequence
+ *    ("\033[row;columnH") unless the cursor is already there
+ *  - Unchanged cells shorter than a cursor move between two runs are re-sent instead,
+ *    so the runs of a row are merged when that is cheaper
+ *  - The cursor is left below the grid, so other output never lands inside it
+ *
+ * A frame that changes a few fields costs a few dozen bytes, against several hundred
+ * for a redraw, and is handed to UART0_Write_DMA in one operation.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Grid size in character cells (a full redraw must fit in one uDMA staging buffer)
+#define DASHBOARD_ROWS       11
+#define DASHBOARD_COLUMNS    48
+
+// Update counters
+typedef struct
+{
+    uint32_t redraws;          // First frames after Dashboard_Begin
+    uint32_t redraw_bytes;
+    uint32_t updates;          // Later Dashboard_Update calls that sent anything
+    uint32_t total_bytes;
+    uint16_t max_bytes;
+} Dashboard_Stats;
+
+// Function Prototypes
+void Dashboard_Begin(void);        // Clears the terminal and the shadow copy, and the next frame
+void Dashboard_Clear(void);        // Blanks the next frame
+void Dashboard_Printf(uint8_t row, uint8_t column, const char *format, ...);    // Row and column from 0
+void Dashboard_Put(uint8_t row, uint8_t column, char character);
+uint16_t Dashboard_Update(void);   // Sends the changed cells, returns the bytes sent
+void Dashboard_Get_Stats(Dashboard_Stats *stats);
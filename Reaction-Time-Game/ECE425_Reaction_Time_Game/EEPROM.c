@@ -0,0 +1,74 @@
+/**
+ * @file EEPROM.c
+ *
+ * @brief Source code for the EEPROM driver.
+ *
+ * This file contains the function definitions for the on-chip EEPROM driver.
+ *
+ * @note The EEPROM controller only accepts a new access once the previous write has
+ * finished (WORKING bit in EEDONE). Reads are immediate.
+ *
+ * EEPROM Configuration:
+ *  - Clock: RCGCEEPROM R0 (Bit 0)
+ *  - Addressing: EEBLOCK selects the 16-word block, EEOFFSET the word within it
+ *  - Data: EERDWR (accessed through the HAL_EEPROM_Read_Data and HAL_EEPROM_Write_Data accessors)
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "EEPROM.h"
+#include "HAL.h"
+
+// EEPROM Bit Masks
+#define EEPROM_EEDONE_WORKING_BIT_MASK    0x01
+#define EEPROM_EESUPP_ERROR_BIT_MASK      0x0C    // PRETRY (Bit 3) and ERETRY (Bit 2)
+
+static void EEPROM_Select(uint16_t address)
+{
+    EEPROM->EEBLOCK = address / EEPROM_WORDS_PER_BLOCK;
+    EEPROM->EEOFFSET = address % EEPROM_WORDS_PER_BLOCK;
+}
+
+uint8_t EEPROM_Init(void)
+{
+    // Enables the clock to the EEPROM module by setting the R0 bit (Bit 0) in the RCGCEEPROM register
+    SYSCTL->RCGCEEPROM |= 0x01;
+    
+    // Waits for the clock to stabilize
+    while ((SYSCTL->PREEPROM & 0x01) == 0);
+    
+    // Waits for the power-on initialization of the EEPROM controller to finish
+    while (EEPROM_Busy());
+    
+    // A failed program or erase retry at power-on leaves the EEPROM unusable
+    if (EEPROM->EESUPP & EEPROM_EESUPP_ERROR_BIT_MASK)
+    {
+        return EEPROM_ERROR;
+    }
+    
+    // Checks the size reported in EESIZE (Bits 15 to 0, in words)
+    if ((EEPROM->EESIZE & 0xFFFF) < EEPROM_WORD_COUNT)
+    {
+        return EEPROM_ERROR;
+    }
+    
+    return EEPROM_OK;
+}
+
+uint32_t EEPROM_Read_Word(uint16_t address)
+{
+    EEPROM_Select(address);
+    return HAL_EEPROM_Read_Data();
+}
+
+void EEPROM_Write_Word(uint16_t address, uint32_t data)
+{
+    // The caller checks EEPROM_Busy first, the write then proceeds in the background
+    EEPROM_Select(address);
+    HAL_EEPROM_Write_Data(data);
+}
+
+uint8_t EEPROM_Busy(void)
+{
+    return (EEPROM->EEDONE & EEPROM_EEDONE_WORKING_BIT_MASK) != 0;
+}
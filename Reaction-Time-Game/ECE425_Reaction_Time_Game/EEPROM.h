@@ -0,0 +1,32 @@
+/**
+ * @file EEPROM.h
+ *
+ * @brief Header file for the EEPROM driver.
+ *
+ * This file contains the function prototypes and definitions for the on-chip EEPROM driver.
+ * The 2 KB EEPROM is addressed here as 512 32-bit words (32 blocks of 16 words).
+ *
+ * @note Writes are started by EEPROM_Write_Word and complete in the background. The caller
+ * polls EEPROM_Busy instead of waiting, so a write never holds up the main loop.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// EEPROM geometry
+#define EEPROM_WORD_COUNT          512
+#define EEPROM_WORDS_PER_BLOCK     16
+
+// Value of a word that has never been written
+#define EEPROM_ERASED_WORD         0xFFFFFFFF
+
+// EEPROM_Init results
+#define EEPROM_OK                  0
+#define EEPROM_ERROR               1
+
+// Function Prototypes
+uint8_t EEPROM_Init(void);
+uint32_t EEPROM_Read_Word(uint16_t address);
+void EEPROM_Write_Word(uint16_t address, uint32_t data);
+uint8_t EEPROM_Busy(void);
@@ -0,0 +1,105 @@
+/**
+ * @file Event_Queue.c
+ *
+ * @brief Source code for the interrupt-to-main-loop event queues.
+ *
+ * This file contains the function definitions for the event queues.
+ *
+ * @note Each ring is indexed by free-running 32-bit counters, like the UART0 ring buffers:
+ * the head is written only by the producer and the tail only by the consumer, the number
+ * of events waiting is head - tail, and each side publishes its counter after the slot it
+ * has written or read, so both sides are wait-free.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Event_Queue.h"
+#include "Timer_2A_Capture.h"
+
+#define EVENT_QUEUE_MASK    (EVENT_QUEUE_SIZE - 1)
+
+typedef struct
+{
+    volatile Event events[EVENT_QUEUE_SIZE];
+    volatile uint32_t head;         // Written only by the producer
+    volatile uint32_t tail;         // Written only by the consumer
+    volatile uint32_t dropped;      // Written only by the producer
+    volatile uint16_t peak_depth;   // Written only by the producer
+} Event_Ring;
+
+static Event_Ring event_rings[EVENT_SOURCE_COUNT];
+
+uint8_t Event_Queue_Post(uint8_t source, uint8_t type, uint8_t data, uint64_t ticks)
+{
+    Event_Ring *ring = &event_rings[source];
+    uint32_t head = ring->head;
+    uint32_t depth = head - ring->tail;
+    
+    if (depth >= EVENT_QUEUE_SIZE)
+    {
+        ring->dropped++;
+        return 0;
+    }
+    
+    volatile Event *slot = &ring->events[head & EVENT_QUEUE_MASK];
+    slot->ticks = ticks;
+    slot->type = type;
+    slot->data = data;
+    
+    // Publishes the event only once the slot is complete
+    ring->head = head + 1;
+    
+    if ((depth + 1) > ring->peak_depth)
+    {
+        ring->peak_depth = (uint16_t)(depth + 1);
+    }
+    return 1;
+}
+
+uint8_t Event_Queue_Post_Now(uint8_t source, uint8_t type, uint8_t data)
+{
+    return Event_Queue_Post(source, type, data, Timer_2A_Get_Time_Ticks());
+}
+
+uint8_t Event_Queue_Take(uint8_t source, Event *event)
+{
+    Event_Ring *ring = &event_rings[source];
+    uint32_t tail = ring->tail;
+    
+    if (tail == ring->head)
+    {
+        return 0;
+    }
+    
+    volatile Event *slot = &ring->events[tail & EVENT_QUEUE_MASK];
+    event->ticks = slot->ticks;
+    event->type = slot->type;
+    event->data = slot->data;
+    
+    // Frees the slot only once it has been copied
+    ring->tail = tail + 1;
+    return 1;
+}
+
+uint16_t Event_Queue_Drain(uint8_t source, void (*handler)(const Event *event))
+{
+    Event event;
+    uint16_t count = 0;
+    
+    // Takes at most one ring's worth, so a producer that keeps posting cannot hold the main loop
+    while ((count < EVENT_QUEUE_SIZE) && Event_Queue_Take(source, &event))
+    {
+        (*handler)(&event);
+        count++;
+    }
+    return count;
+}
+
+void Event_Queue_Get_Stats(uint8_t source, Event_Queue_Stats *stats)
+{
+    Event_Ring *ring = &event_rings[source];
+    
+    stats->dropped = ring->dropped;
+    stats->posted = ring->head;
+    stats->peak_depth = ring->peak_depth;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file Event_Queue.h
+ *
+ * @brief Header file for the interrupt-to-main-loop event queues.
+ *
+ * This file contains the function prototypes and definitions for the event queues. Each
+ * interrupt source has its own single-producer, single-consumer ring of timestamped events:
+ * the source's interrupt handlers are the only producer and the main loop is the only
+ * consumer, so neither side disables interrupts or waits for the other.
+ *
+ * Sources:
+ *  - EVENT_SOURCE_BUTTON: every SW1 and SW2 capture edge while the buttons are armed, in
+ *    order, including contact bounce, and the press or release that each debounce window
+ *    settles to (posted by the Timer 2A, Timer 0A and Timer 1A handlers, which share one
+ *    priority level and so never preempt each other)
+ *  - EVENT_SOURCE_SYSTICK: one event per 1 ms tick outside deep sleep, with the low 8 bits
+ *    of the millisecond count, so the consumer can tell consecutive ticks from lost ones
+ *  - EVENT_SOURCE_UART_RX: one event per receive interrupt, with the number of characters
+ *    moved into the receive ring buffer (the characters themselves stay in that buffer)
+ *
+ * Timestamps are Timer 2A ticks (one per system clock cycle), the timebase of the stimulus
+ * onset and the press captures, so events from every source can be ordered against each other.
+ *
+ * @note A post to a full queue drops the new event and counts it, so a consumer that falls
+ * behind loses the newest events, never ones it has not read yet.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Event sources, one queue each
+#define EVENT_SOURCE_BUTTON     0
+#define EVENT_SOURCE_SYSTICK    1
+#define EVENT_SOURCE_UART_RX    2
+#define EVENT_SOURCE_COUNT      3
+
+// Events per queue (must be a power of two)
+#define EVENT_QUEUE_SIZE        32
+
+// Event types (the data byte is the player for the button events)
+#define EVENT_BUTTON_EDGE       0    // First edge after a quiet period, opens a debounce window
+#define EVENT_BUTTON_BOUNCE     1    // Edge inside an open debounce window, ignored
+#define EVENT_BUTTON_PRESS      2    // Window closed with the button down, stamped at its first edge
+#define EVENT_BUTTON_RELEASE    3    // Window closed with the button up, stamped at its first edge
+#define EVENT_BUTTON_GLITCH     4    // Window closed at the level it opened from
+#define EVENT_SYSTICK_TICK      5    // Data: low 8 bits of the millisecond count
+#define EVENT_UART_RX           6    // Data: characters received (up to 255)
+
+// Timestamped event
+typedef struct
+{
+    uint64_t ticks;    // Timer 2A timebase
+    uint8_t type;
+    uint8_t data;
+} Event;
+
+// Queue counters
+typedef struct
+{
+    uint32_t posted;       // Events accepted since reset
+    uint32_t dropped;      // Events lost to a full queue
+    uint16_t peak_depth;   // Most events waiting at once
+} Event_Queue_Stats;
+
+// Function Prototypes
+uint8_t Event_Queue_Post(uint8_t source, uint8_t type, uint8_t data, uint64_t ticks);  // Producer only
+uint8_t Event_Queue_Post_Now(uint8_t source, uint8_t type, uint8_t data);              // Stamped on entry
+uint8_t Event_Queue_Take(uint8_t source, Event *event);                                // Consumer only
+uint16_t Event_Queue_Drain(uint8_t source, void (*handler)(const Event *event));       // Consumer only
+void Event_Queue_Get_Stats(uint8_t source, Event_Queue_Stats *stats);
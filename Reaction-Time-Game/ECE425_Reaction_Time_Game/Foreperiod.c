@@ -0,0 +1,115 @@
+/**
+ * @file Foreperiod.c
+ *
+ * @brief Source code for the foreperiod distributions.
+ *
+ * This file contains the function definitions for the foreperiod distributions.
+ *
+ * Inverse-CDF Tables:
+ *  - Entry i is the foreperiod F^-1(i / 256) in milliseconds, for i = 0 to 256
+ *  - A draw takes a 32-bit random number u, uses the top 8 bits as the table index and
+ *    the next 8 bits to interpolate between the entry and the one after it
+ *  - The exponential table was generated offline with
+ *    1000 - 750 ln(1 - (i / 256)(1 - e^-4)), rounded to the nearest millisecond
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Foreperiod.h"
+#include "Random.h"
+
+#define FOREPERIOD_TABLE_SIZE    257
+
+static const uint16_t foreperiod_tables[FOREPERIOD_COUNT][FOREPERIOD_TABLE_SIZE] =
+{
+    // FOREPERIOD_UNIFORM
+    {
+        1000, 1008, 1016, 1023, 1031, 1039, 1047, 1055,
+        1062, 1070, 1078, 1086, 1094, 1102, 1109, 1117,
+        1125, 1133, 1141, 1148, 1156, 1164, 1172, 1180,
+        1188, 1195, 1203, 1211, 1219, 1227, 1234, 1242,
+        1250, 1258, 1266, 1273, 1281, 1289, 1297, 1305,
+        1312, 1320, 1328, 1336, 1344, 1352, 1359, 1367,
+        1375, 1383, 1391, 1398, 1406, 1414, 1422, 1430,
+        1438, 1445, 1453, 1461, 1469, 1477, 1484, 1492,
+        1500, 1508, 1516, 1523, 1531, 1539, 1547, 1555,
+        1562, 1570, 1578, 1586, 1594, 1602, 1609, 1617,
+        1625, 1633, 1641, 1648, 1656, 1664, 1672, 1680,
+        1688, 1695, 1703, 1711, 1719, 1727, 1734, 1742,
+        1750, 1758, 1766, 1773, 1781, 1789, 1797, 1805,
+        1812, 1820, 1828, 1836, 1844, 1852, 1859, 1867,
+        1875, 1883, 1891, 1898, 1906, 1914, 1922, 1930,
+        1938, 1945, 1953, 1961, 1969, 1977, 1984, 1992,
+        2000, 2008, 2016, 2023, 2031, 2039, 2047, 2055,
+        2062, 2070, 2078, 2086, 2094, 2102, 2109, 2117,
+        2125, 2133, 2141, 2148, 2156, 2164, 2172, 2180,
+        2188, 2195, 2203, 2211, 2219, 2227, 2234, 2242,
+        2250, 2258, 2266, 2273, 2281, 2289, 2297, 2305,
+        2312, 2320, 2328, 2336, 2344, 2352, 2359, 2367,
+        2375, 2383, 2391, 2398, 2406, 2414, 2422, 2430,
+        2438, 2445, 2453, 2461, 2469, 2477, 2484, 2492,
+        2500, 2508, 2516, 2523, 2531, 2539, 2547, 2555,
+        2562, 2570, 2578, 2586, 2594, 2602, 2609, 2617,
+        2625, 2633, 2641, 2648, 2656, 2664, 2672, 2680,
+        2688, 2695, 2703, 2711, 2719, 2727, 2734, 2742,
+        2750, 2758, 2766, 2773, 2781, 2789, 2797, 2805,
+        2812, 2820, 2828, 2836, 2844, 2852, 2859, 2867,
+        2875, 2883, 2891, 2898, 2906, 2914, 2922, 2930,
+        2938, 2945, 2953, 2961, 2969, 2977, 2984, 2992,
+        3000
+    },
+    
+    // FOREPERIOD_EXPONENTIAL
+    {
+        1000, 1003, 1006, 1009, 1012, 1015, 1017, 1020,
+        1023, 1026, 1029, 1032, 1035, 1038, 1041, 1044,
+        1047, 1051, 1054, 1057, 1060, 1063, 1066, 1069,
+        1072, 1076, 1079, 1082, 1085, 1088, 1092, 1095,
+        1098, 1101, 1105, 1108, 1111, 1115, 1118, 1121,
+        1125, 1128, 1132, 1135, 1139, 1142, 1146, 1149,
+        1153, 1156, 1160, 1163, 1167, 1170, 1174, 1178,
+        1181, 1185, 1189, 1192, 1196, 1200, 1204, 1207,
+        1211, 1215, 1219, 1223, 1227, 1231, 1234, 1238,
+        1242, 1246, 1250, 1254, 1258, 1262, 1267, 1271,
+        1275, 1279, 1283, 1287, 1292, 1296, 1300, 1304,
+        1309, 1313, 1317, 1322, 1326, 1331, 1335, 1340,
+        1344, 1349, 1353, 1358, 1363, 1367, 1372, 1377,
+        1382, 1386, 1391, 1396, 1401, 1406, 1411, 1416,
+        1421, 1426, 1431, 1436, 1441, 1447, 1452, 1457,
+        1462, 1468, 1473, 1479, 1484, 1489, 1495, 1501,
+        1506, 1512, 1518, 1523, 1529, 1535, 1541, 1547,
+        1553, 1559, 1565, 1571, 1577, 1584, 1590, 1596,
+        1603, 1609, 1616, 1622, 1629, 1635, 1642, 1649,
+        1656, 1663, 1670, 1677, 1684, 1691, 1698, 1706,
+        1713, 1721, 1728, 1736, 1743, 1751, 1759, 1767,
+        1775, 1783, 1791, 1800, 1808, 1817, 1825, 1834,
+        1843, 1852, 1861, 1870, 1879, 1888, 1898, 1907,
+        1917, 1927, 1937, 1947, 1957, 1968, 1978, 1989,
+        2000, 2011, 2022, 2033, 2045, 2056, 2068, 2080,
+        2092, 2105, 2117, 2130, 2143, 2157, 2170, 2184,
+        2198, 2213, 2227, 2242, 2257, 2273, 2289, 2305,
+        2321, 2338, 2356, 2374, 2392, 2410, 2429, 2449,
+        2469, 2490, 2511, 2533, 2555, 2579, 2603, 2627,
+        2653, 2680, 2707, 2736, 2765, 2796, 2828, 2862,
+        2897, 2934, 2973, 3014, 3058, 3104, 3153, 3206,
+        3262, 3323, 3390, 3463, 3544, 3634, 3738, 3857,
+        4000
+    }
+};
+
+static const char *foreperiod_names[FOREPERIOD_COUNT] = {"Uniform", "Exponential"};
+
+uint32_t Foreperiod_Draw(uint8_t distribution)
+{
+    const uint16_t *table = foreperiod_tables[(distribution < FOREPERIOD_COUNT) ? distribution : FOREPERIOD_UNIFORM];
+    uint32_t u = Random_Next();
+    uint32_t index = u >> 24;
+    uint32_t fraction = (u >> 16) & 0xFF;
+    
+    return table[index] + (((uint32_t)(table[index + 1] - table[index]) * fraction) >> 8);
+}
+
+const char *Foreperiod_Get_Name(uint8_t distribution)
+{
+    return (distribution < FOREPERIOD_COUNT) ? foreperiod_names[distribution] : "Unknown";
+}
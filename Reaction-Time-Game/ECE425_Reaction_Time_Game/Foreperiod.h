@@ -0,0 +1,35 @@
+/**
+ * @file Foreperiod.h
+ *
+ * @brief Header file for the foreperiod distributions.
+ *
+ * This file contains the distribution codes and function prototypes for the foreperiod,
+ * the random wait between the countdown and the stimulus.
+ *
+ * Distributions:
+ *  - FOREPERIOD_UNIFORM: uniform between 1 and 3 s. The stimulus becomes more likely the
+ *    longer the wait, so players can anticipate late stimuli.
+ *  - FOREPERIOD_EXPONENTIAL: 1 s plus an exponential wait (mean 750 ms, truncated at 4 s).
+ *    The chance of the stimulus in the next moment does not depend on the time already
+ *    waited (non-aging), so waiting gives the player no information.
+ *
+ * @note Draws use a precomputed inverse-CDF table, so each draw takes one generator call,
+ * two table reads and a multiply, with no division.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Distribution codes (also stored as a setting in the session log)
+#define FOREPERIOD_UNIFORM        0
+#define FOREPERIOD_EXPONENTIAL    1
+#define FOREPERIOD_COUNT          2
+
+// Range of every distribution in milliseconds
+#define FOREPERIOD_MIN_MS         1000
+#define FOREPERIOD_MAX_MS         4000
+
+// Function Prototypes
+uint32_t Foreperiod_Draw(uint8_t distribution);    // Returns the foreperiod in milliseconds
+const char *Foreperiod_Get_Name(uint8_t distribution);
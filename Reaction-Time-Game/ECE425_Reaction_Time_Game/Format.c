@@ -0,0 +1,260 @@
+/**
+ * @file Format.c
+ *
+ * @brief Source code for the formatted output engine.
+ *
+ * This file contains the function definitions for the formatted output engine.
+ *
+ * Both functions write at most size - 1 characters followed by a terminating zero, and
+ * return the length the complete output would have had (like snprintf), so the caller can
+ * detect truncation and retry with more space.
+ *
+ * Decimal digits are produced least significant first into a 10-character scratch array:
+ * the quotient n / 10 is the upper bits of n * 0xCCCCCCCD (exact for every 32-bit n), so
+ * each digit costs a multiply and a shift instead of a hardware divide.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Format.h"
+
+// Longest 32-bit number in decimal
+#define FORMAT_MAX_DIGITS    10
+
+typedef struct
+{
+    char *next;         // Next character to write
+    char *end;          // Last character of the buffer, kept for the terminating zero
+    uint16_t dropped;   // Characters that did not fit
+} Format_Output;
+
+static void Format_Copy(Format_Output *output, const char *text, uint16_t length, uint8_t reversed)
+{
+    uint16_t space = (uint16_t)(output->end - output->next);
+    
+    if (length > space)
+    {
+        output->dropped += length - space;
+        length = space;
+    }
+    
+    // Reversed text (digits generated least significant first) is copied from its end
+    if (reversed)
+    {
+        for (uint16_t i = 0; i < length; i++)
+        {
+            output->next[i] = text[-1 - (int16_t)i];
+        }
+    }
+    else
+    {
+        for (uint16_t i = 0; i < length; i++)
+        {
+            output->next[i] = text[i];
+        }
+    }
+    output->next += length;
+}
+
+static void Format_Pad(Format_Output *output, char pad, uint8_t count)
+{
+    while (count > 0)
+    {
+        if (output->next < output->end)
+        {
+            *output->next++ = pad;
+        }
+        else
+        {
+            output->dropped++;
+        }
+        count--;
+    }
+}
+
+static uint8_t Format_Decimal_Digits(uint32_t value, char *digits)
+{
+    uint8_t count = 0;
+    
+    do
+    {
+        uint32_t quotient = (uint32_t)(((uint64_t)value * 0xCCCCCCCD) >> 35);
+        digits[count++] = (char)('0' + (value - (quotient * 10)));
+        value = quotient;
+    } while (value > 0);
+    
+    return count;
+}
+
+static uint8_t Format_Hexadecimal_Digits(uint32_t value, char *digits)
+{
+    uint8_t count = 0;
+    
+    do
+    {
+        digits[count++] = "0123456789abcdef"[value & 0x0F];
+        value >>= 4;
+    } while (value > 0);
+    
+    return count;
+}
+
+static void Format_Field(Format_Output *output, const char *text, uint8_t reversed, uint16_t length,
+                         char sign, uint8_t width, uint8_t left, char pad)
+{
+    uint16_t field = length + (sign ? 1 : 0);
+    uint8_t padding = (width > field) ? (uint8_t)(width - field) : 0;
+    
+    if (!left && (pad == ' '))
+    {
+        Format_Pad(output, ' ', padding);
+    }
+    
+    if (sign)
+    {
+        Format_Pad(output, sign, 1);
+    }
+    
+    // Zero padding goes between the sign and the digits
+    if (!left && (pad == '0'))
+    {
+        Format_Pad(output, '0', padding);
+    }
+    
+    Format_Copy(output, reversed ? &text[length] : text, length, reversed);
+    
+    if (left)
+    {
+        Format_Pad(output, ' ', padding);
+    }
+}
+
+uint16_t Format_String(char *buffer, uint16_t size, const char *format, ...)
+{
+    va_list args;
+    uint16_t length;
+    
+    va_start(args, format);
+    length = Format_Vector(buffer, size, format, args);
+    va_end(args);
+    
+    return length;
+}
+
+uint16_t Format_Vector(char *buffer, uint16_t size, const char *format, va_list args)
+{
+    Format_Output output = { buffer, buffer + ((size > 0) ? (size - 1) : 0), 0 };
+    char digits[FORMAT_MAX_DIGITS];
+    
+    while (*format)
+    {
+        // Copies the text up to the next conversion in one run
+        const char *literal = format;
+        while (*format && (*format != '%'))
+        {
+            format++;
+        }
+        Format_Copy(&output, literal, (uint16_t)(format - literal), 0);
+        
+        if (*format == 0)
+        {
+            break;
+        }
+        format++;
+        
+        // Flags, width and length modifier
+        uint8_t left = 0;
+        char pad = ' ';
+        uint8_t width = 0;
+        uint8_t is_long = 0;
+        
+        for (; (*format == '-') || (*format == '0'); format++)
+        {
+            if (*format == '-')
+            {
+                left = 1;
+            }
+            else
+            {
+                pad = '0';
+            }
+        }
+        
+        for (; (*format >= '0') && (*format <= '9'); format++)
+        {
+            width = (uint8_t)((width * 10) + (*format - '0'));
+        }
+        
+        if (*format == 'l')
+        {
+            is_long = 1;
+            format++;
+        }
+        
+        switch (*format)
+        {
+            case 'u':
+            {
+                uint32_t value = is_long ? (uint32_t)va_arg(args, unsigned long) : va_arg(args, unsigned int);
+                Format_Field(&output, digits, 1, Format_Decimal_Digits(value, digits), 0, width, left, pad);
+                break;
+            }
+                
+            case 'd':
+            {
+                int32_t value = is_long ? (int32_t)va_arg(args, long) : va_arg(args, int);
+                uint32_t magnitude = (value < 0) ? (0 - (uint32_t)value) : (uint32_t)value;
+                Format_Field(&output, digits, 1, Format_Decimal_Digits(magnitude, digits), (value < 0) ? '-' : 0,
+                             width, left, pad);
+                break;
+            }
+                
+            case 'x':
+            {
+                uint32_t value = is_long ? (uint32_t)va_arg(args, unsigned long) : va_arg(args, unsigned int);
+                Format_Field(&output, digits, 1, Format_Hexadecimal_Digits(value, digits), 0, width, left, pad);
+                break;
+            }
+                
+            case 's':
+            {
+                const char *text = va_arg(args, const char *);
+                uint16_t length = 0;
+                while (text[length] && (length < UINT16_MAX))
+                {
+                    length++;
+                }
+                Format_Field(&output, text, 0, length, 0, width, left, ' ');
+                break;
+            }
+                
+            case 'c':
+            {
+                char character = (char)va_arg(args, int);
+                Format_Field(&output, &character, 0, 1, 0, width, left, ' ');
+                break;
+            }
+                
+            case '%':
+                Format_Pad(&output, '%', 1);
+                break;
+                
+            default:
+                // Unknown conversions are copied through, and a trailing '%' ends the output
+                if (*format == 0)
+                {
+                    continue;
+                }
+                Format_Pad(&output, '%', 1);
+                Format_Pad(&output, *format, 1);
+        }
+        format++;
+    }
+    
+    if (size > 0)
+    {
+        *output.next = 0;
+    }
+    
+    return (uint16_t)(output.next - buffer) + output.dropped;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file Format.h
+ *
+ * @brief Header file for the formatted output engine.
+ *
+ * This file contains the function prototypes for a small printf-style formatter that
+ * renders into a caller-supplied buffer, so a whole report line is built first and then
+ * handed to the UART in one operation.
+ *
+ * Conversions (each with optional '-' for left alignment, '0' for zero padding and a width):
+ *  - %u, %lu: unsigned decimal
+ *  - %d, %ld: signed decimal
+ *  - %x, %lx: lowercase hexadecimal
+ *  - The 'l' forms take a long or unsigned long argument; values are 32-bit either way
+ *  - %s: string, %c: character, %%: a percent sign
+ *
+ * Fixed-point values are written as two conversions, e.g. "%u.%03u ms" for milliseconds
+ * with three decimal places.
+ *
+ * @note Digits are generated without division (multiplication by the reciprocal of 10)
+ * and without recursion, so a call uses a fixed, small amount of stack.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+
+// Function Prototypes
+uint16_t Format_String(char *buffer, uint16_t size, const char *format, ...);
+uint16_t Format_Vector(char *buffer, uint16_t size, const char *format, va_list args);
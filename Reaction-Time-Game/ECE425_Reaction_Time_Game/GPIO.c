@@ -11,20 +11,160 @@
  *  - PF1 (Red LED): Output
  *  - PF2 (Blue LED): Output
  *  - PF3 (Green LED): Output
- *  - PF4 (SW1): Input with interrupt
- *  - PF0 (SW2): Input with pull-up
+ *  - PF4 (SW1): Input with pull-up, muxed as T2CCP0 for Timer 2A edge-time capture
+ *  - PF0 (SW2): Input with pull-up, muxed as T0CCP0 for Timer 0A edge-time capture
+ *  - PB3 (Calibration loopback): Output, wired to PB2
+ *  - PB2 (Calibration loopback): Input with pull-down, muxed as T3CCP0 for Timer 3A edge-time capture
+ *
+ * Reaction times are measured from timer ticks (one per system clock cycle). The press
+ * edges on SW1 and SW2 are latched by Timer 2A and Timer 0A in hardware, the two timers
+ * count in lockstep, and the stimulus onset is stamped from the same timebase. Presses by
+ * the two players are ordered to a single clock cycle. The latency offset measured by the
+ * loopback calibration (see Calibration.h) is subtracted from every press timestamp.
+ *
+ * Button Debouncing (the same code path for both buttons):
+ *  - The first edge after a quiet period is timestamped and starts a lockout window
+ *  - Edges inside the lockout window are contact bounce and are ignored
+ *  - When the window expires, the settled pin level decides whether the edge was a press,
+ *    a release or a glitch, and a press is reported with the timestamp of its first edge
+ *  - Timer 1A is a single one-shot, always started for the earliest open window, so the
+ *    windows of both buttons run at the same time without a second timer
+ *  - The button levels are sampled when the capture is armed, so a button that is already
+ *    held only counts once it has been released and pressed again
+ *  - Only a player's first press in a round is kept
+ *  - Every edge, and what each window settled to, is posted in order to the button event
+ *    queue (see Event_Queue.h), so bursts of presses, releases and bounces can be read back
  *
  * @author Benjamin Nguyen
  */
 
 #include "GPIO.h"
-#include "TM4C123GH6PM.h"
-#include "SysTick_Delay.h"
+#include "Event_Queue.h"
+#include "HAL.h"
+#include "Timer_0A_Capture.h"
+#include "Timer_2A_Capture.h"
+#include "Timer_3A_Capture.h"
+#include "Timer_1A_OneShot.h"
+
+// Debounce window in timer ticks
+#define BUTTON_DEBOUNCE_TICKS    ((uint64_t)BUTTON_DEBOUNCE_US * TIMER_2A_TICKS_PER_US)
 
 // Global variables
-static volatile uint8_t button_flag = 0;
-static volatile uint32_t reaction_time = 0;
-static volatile uint32_t start_time = 0;
+static volatile uint8_t button_flags = 0;
+static volatile uint64_t press_ticks[PLAYER_COUNT];
+static volatile uint64_t start_ticks = 0;
+static int32_t latency_offset_ticks = 0;
+
+// Debounce state (owned by the capture and Timer 1A interrupt handlers while armed, which
+// share one priority level and so never preempt each other)
+static volatile uint8_t armed_players = 0;              // Bit n set when player n is armed
+static volatile uint8_t button_state[PLAYER_COUNT];     // Debounced level, 1 when pressed
+static volatile uint8_t button_lockout[PLAYER_COUNT];
+static volatile uint64_t button_edge_ticks[PLAYER_COUNT];
+
+// Press timestamp with the stimulus-to-capture latency offset removed
+static uint64_t Corrected_Press_Ticks(uint8_t player)
+{
+    return press_ticks[player] - (uint64_t)(int64_t)latency_offset_ticks;
+}
+
+static uint8_t Button_Pressed(uint8_t player)
+{
+    return (player == PLAYER_1) ? SW1_Pressed() : SW2_Pressed();
+}
+
+// Starts Timer 1A for the earliest open lockout window, or stops it if none is open
+static void Schedule_Debounce(void)
+{
+    uint64_t now = Timer_2A_Get_Time_Ticks();
+    uint64_t deadline = 0;
+    uint8_t open = 0;
+    
+    for (uint8_t player = 0; player < PLAYER_COUNT; player++)
+    {
+        uint64_t player_deadline = button_edge_ticks[player] + BUTTON_DEBOUNCE_TICKS;
+        if (button_lockout[player] && (!open || (player_deadline < deadline)))
+        {
+            deadline = player_deadline;
+            open = 1;
+        }
+    }
+    
+    if (!open)
+    {
+        Timer_1A_OneShot_Stop();
+        return;
+    }
+    
+    // Rounds up to whole microseconds, so the window has always closed at the time-out
+    uint32_t remaining_us = 1;
+    if (deadline > now)
+    {
+        remaining_us = (uint32_t)((deadline - now + TIMER_2A_TICKS_PER_US - 1) / TIMER_2A_TICKS_PER_US);
+    }
+    Timer_1A_OneShot_Start(remaining_us);
+}
+
+// Timestamps the first edge after a quiet period and opens the lockout window
+static void Button_Capture(uint8_t player, uint64_t capture_ticks)
+{
+    if (button_lockout[player])
+    {
+        Event_Queue_Post(EVENT_SOURCE_BUTTON, EVENT_BUTTON_BOUNCE, player, capture_ticks);
+        return;
+    }
+    
+    Event_Queue_Post(EVENT_SOURCE_BUTTON, EVENT_BUTTON_EDGE, player, capture_ticks);
+    button_edge_ticks[player] = capture_ticks;
+    button_lockout[player] = 1;
+    Schedule_Debounce();
+}
+
+static void SW1_Capture_Task(uint64_t capture_ticks)
+{
+    Button_Capture(PLAYER_1, capture_ticks);
+}
+
+static void SW2_Capture_Task(uint64_t capture_ticks)
+{
+    Button_Capture(PLAYER_2, capture_ticks);
+}
+
+// Classifies the edges whose lockout windows have closed from the settled pin levels
+static void Debounce_Task(void)
+{
+    uint64_t now = Timer_2A_Get_Time_Ticks();
+    
+    for (uint8_t player = 0; player < PLAYER_COUNT; player++)
+    {
+        if (!button_lockout[player] || ((button_edge_ticks[player] + BUTTON_DEBOUNCE_TICKS) > now))
+        {
+            continue;
+        }
+        
+        uint8_t level = Button_Pressed(player);
+        uint8_t bit = 1 << player;
+        
+        button_lockout[player] = 0;
+        
+        if (level == button_state[player])
+        {
+            Event_Queue_Post(EVENT_SOURCE_BUTTON, EVENT_BUTTON_GLITCH, player, button_edge_ticks[player]);
+            continue;
+        }
+        
+        button_state[player] = level;
+        Event_Queue_Post(EVENT_SOURCE_BUTTON, level ? EVENT_BUTTON_PRESS : EVENT_BUTTON_RELEASE, player,
+                         button_edge_ticks[player]);
+        if (level && (armed_players & bit) && !(button_flags & bit))
+        {
+            press_ticks[player] = button_edge_ticks[player];
+            button_flags |= bit;
+        }
+    }
+    
+    Schedule_Debounce();
+}
 
 void GPIO_Init(void)
 {
@@ -47,30 +187,73 @@ void GPIO_Init(void)
     
     // Clears any pending interrupts
     GPIOF->ICR = 0x11;
+    
+    // Selects the T2CCP0 alternate function for PF4 by writing 0x7 to PMC4 (Bits 19 to 16)
+    // and the T0CCP0 alternate function for PF0 by writing 0x7 to PMC0 (Bits 3 to 0)
+    GPIOF->AFSEL |= 0x11;
+    GPIOF->PCTL &= ~0x000F000F;
+    GPIOF->PCTL |= 0x00070007;
+    
+    // Starts the Timer 2A timebase with SW1 edge capture, then Timer 0A with SW2 edge capture
+    // in lockstep with it, and the Timer 1A debounce timer
+    Timer_1A_OneShot_Init(&Debounce_Task);
+    Timer_2A_Capture_Init(&SW1_Capture_Task);
+    Timer_0A_Capture_Init(&SW2_Capture_Task);
+    
+    // Enables clock for Port B
+    SYSCTL->RCGCGPIO |= 0x02;
+    
+    // Waits for clock to stabilize
+    while((SYSCTL->PRGPIO & 0x02) == 0);
+    
+    // Sets PB3 as the loopback output (low) and PB2 as the loopback input, pulled down so it
+    // stays low when the loopback wire is not fitted
+    GPIOB->DATA &= ~LOOPBACK_OUTPUT;
+    GPIOB->DIR |= LOOPBACK_OUTPUT;
+    GPIOB->DIR &= ~LOOPBACK_INPUT;
+    GPIOB->PDR |= LOOPBACK_INPUT;
+    GPIOB->DEN |= LOOPBACK_OUTPUT | LOOPBACK_INPUT;
+    
+    // Selects the T3CCP0 alternate function for PB2 by writing 0x7 to PMC2 (Bits 11 to 8)
+    GPIOB->AFSEL |= LOOPBACK_INPUT;
+    GPIOB->PCTL &= ~0x00000F00;
+    GPIOB->PCTL |= 0x00000700;
+    
+    // Starts Timer 3A for the loopback capture, restarting the other capture timers with it
+    Timer_3A_Capture_Init();
 }
 
-void GPIO_Enable_Interrupt(void)
+void GPIO_Enable_Interrupt(uint8_t player_count)
 {
-    // Clears any pending interrupt for PF4
-    GPIOF->ICR = 0x10;
-    
-    // Configures interrupt for PF4
-    GPIOF->IS &= ~0x10;     // Edge-sensitive
-    GPIOF->IBE &= ~0x10;    // Single edge
-    GPIOF->IEV &= ~0x10;    // Falling edge
-    GPIOF->IM |= 0x10;      // Enables interrupt for PF4
+    // Starts from the current button levels, so a held button is not a new press
+    Timer_1A_OneShot_Stop();
+    for (uint8_t player = 0; player < PLAYER_COUNT; player++)
+    {
+        button_lockout[player] = 0;
+        button_state[player] = Button_Pressed(player);
+    }
+    button_flags = 0;
+    armed_players = (1 << player_count) - 1;
     
-    // Enables interrupt in NVIC
-    NVIC->ISER[0] |= 1 << 30;
+    // Arms the capture events for both edges of each player's button
+    Timer_2A_Capture_Enable();
+    if (player_count > 1)
+    {
+        Timer_0A_Capture_Enable();
+    }
 }
 
 void GPIO_Disable_Interrupt(void)
 {
-    // Disables interrupt for PF4
-    GPIOF->IM &= ~0x10;
-    
-    // Disables interrupt in NVIC
-    NVIC->ICER[0] |= 1 << 30;
+    // Disarms the capture events and cancels the pending lockout windows
+    Timer_2A_Capture_Disable();
+    Timer_0A_Capture_Disable();
+    Timer_1A_OneShot_Stop();
+    armed_players = 0;
+    for (uint8_t player = 0; player < PLAYER_COUNT; player++)
+    {
+        button_lockout[player] = 0;
+    }
 }
 
 void LED_On(uint8_t color)
@@ -83,6 +266,13 @@ void LED_Off(uint8_t color)
     GPIOF->DATA &= ~color;
 }
 
+void LED_Set(uint8_t color)
+{
+    // Masked store through the DATA address alias for PF3 to PF1 (address bits 9 to 2),
+    // so the three LEDs change together without a read-modify-write
+    GPIOF->DATA_BITS[RED_LED | BLUE_LED | GREEN_LED] = color;
+}
+
 void LED_Toggle(uint8_t color)
 {
     GPIOF->DATA ^= color;
@@ -100,31 +290,79 @@ uint8_t SW2_Pressed(void)
 
 uint8_t Get_Button_Flag(void)
 {
-    return button_flag;
+    return button_flags;
 }
 
 void Clear_Button_Flag(void)
 {
-    button_flag = 0;
+    button_flags = 0;
 }
 
-uint32_t Get_Reaction_Time(void)
+uint32_t Get_Reaction_Time(uint8_t player)
 {
-    return reaction_time;
+    return (uint32_t)((Corrected_Press_Ticks(player) - start_ticks) / TIMER_2A_TICKS_PER_US);  // In microseconds
 }
 
-void Set_Start_Time(uint32_t time)
+uint32_t Get_Reaction_Time_Ms(uint8_t player)
 {
-    start_time = time;
+    return Get_Reaction_Time(player) / 1000;
 }
 
-// GPIO Port F Interrupt Handler
-void GPIOF_Handler(void)
+uint8_t Is_False_Start(uint8_t player)
 {
-    if (GPIOF->MIS & SW1)
+    // The press edge came before the stimulus onset
+    return Corrected_Press_Ticks(player) < start_ticks;
+}
+
+uint8_t Get_First_Player(void)
+{
+    // Orders the players that pressed by their latched edges, to one clock cycle
+    uint8_t flags = button_flags;
+    
+    if (flags == ((1 << PLAYER_1) | (1 << PLAYER_2)))
     {
-        GPIOF->ICR = SW1;
-        reaction_time = SysTick_Get_Current_Time() - start_time;  // Already in milliseconds
-        button_flag = 1;
+        if (press_ticks[PLAYER_1] == press_ticks[PLAYER_2])
+        {
+            return PLAYER_TIE;
+        }
+        return (press_ticks[PLAYER_1] < press_ticks[PLAYER_2]) ? PLAYER_1 : PLAYER_2;
     }
-}
\ No newline at end of file
+    
+    return (flags & (1 << PLAYER_2)) ? PLAYER_2 : PLAYER_1;
+}
+
+uint32_t Mark_Start_Time(void)
+{
+    // Stamps the stimulus onset and returns it in microseconds
+    uint64_t ticks = Timer_2A_Get_Time_Ticks();
+    
+    start_ticks = ticks;
+    return (uint32_t)(ticks / TIMER_2A_TICKS_PER_US);
+}
+
+uint64_t Get_Start_Time_Ticks(void)
+{
+    return start_ticks;
+}
+
+uint32_t Get_Current_Time_Us(void)
+{
+    return Timer_2A_Get_Time_Us();
+}
+
+void Loopback_Set(uint8_t level)
+{
+    // Masked store through the DATA address alias for PB3, in the same form as LED_Set,
+    // so the loopback edge is driven like a stimulus LED
+    GPIOB->DATA_BITS[LOOPBACK_OUTPUT] = level ? LOOPBACK_OUTPUT : 0;
+}
+
+void Set_Latency_Offset(int32_t offset_ticks)
+{
+    latency_offset_ticks = offset_ticks;
+}
+
+int32_t Get_Latency_Offset(void)
+{
+    return latency_offset_ticks;
+}
@@ -21,16 +21,38 @@
 #define SW1        0x10    // PF4
 #define SW2        0x01    // PF0
 
+// Calibration Loopback Definitions (PB3 is wired to PB2 for the latency calibration)
+#define LOOPBACK_OUTPUT    0x08    // PB3
+#define LOOPBACK_INPUT     0x04    // PB2, T3CCP0
+
+// Player Definitions
+#define PLAYER_1        0       // SW1, captured by Timer 2A
+#define PLAYER_2        1       // SW2, captured by Timer 0A
+#define PLAYER_COUNT    2
+#define PLAYER_TIE      0xFF    // Both presses latched in the same clock cycle
+
+// Button debounce lockout window after the first edge of a press or release
+#define BUTTON_DEBOUNCE_US    20000
+
 // Function Prototypes
 void GPIO_Init(void);
-void GPIO_Enable_Interrupt(void);
+void GPIO_Enable_Interrupt(uint8_t player_count);
 void GPIO_Disable_Interrupt(void);
 void LED_On(uint8_t color);
 void LED_Off(uint8_t color);
+void LED_Set(uint8_t color);            // Turns on color and turns off the other LEDs
 void LED_Toggle(uint8_t color);
 uint8_t SW1_Pressed(void);
 uint8_t SW2_Pressed(void);
-uint8_t Get_Button_Flag(void);
+uint8_t Get_Button_Flag(void);           // Bit n is set once player n has pressed
 void Clear_Button_Flag(void);
-uint32_t Get_Reaction_Time(void);
-void Set_Start_Time(uint32_t time);
\ No newline at end of file
+uint32_t Get_Reaction_Time(uint8_t player);       // Returns time in microseconds
+uint32_t Get_Reaction_Time_Ms(uint8_t player);    // Returns time in milliseconds
+uint8_t Is_False_Start(uint8_t player);
+uint8_t Get_First_Player(void);
+uint32_t Mark_Start_Time(void);
+uint64_t Get_Start_Time_Ticks(void);
+uint32_t Get_Current_Time_Us(void);
+void Loopback_Set(uint8_t level);
+void Set_Latency_Offset(int32_t offset_ticks);    // Subtracted from every press timestamp
+int32_t Get_Latency_Offset(void);
\ No newline at end of file
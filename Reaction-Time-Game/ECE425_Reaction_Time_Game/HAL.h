@@ -0,0 +1,37 @@
+/**
+ * @file HAL.h
+ *
+ * @brief Header file for the hardware abstraction layer.
+ *
+ * This file selects the register file used by the drivers and defines the accessors
+ * for registers whose reads or writes have side effects beyond storing a value.
+ *
+ * @note There are two backends, selected by the include path:
+ *  - TM4C123: the vendor TM4C123GH6PM.h device header (CMSIS register structures and intrinsics)
+ *  - Host simulator: Host/TM4C123GH6PM.h, which maps the same register structures onto a
+ *    virtual register file and the same intrinsics onto the simulator's virtual clock
+ *
+ * Drivers include this header instead of the device header, so the same driver sources
+ * build for both backends.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "TM4C123GH6PM.h"
+
+// UART0 data register accessors (a read pops the RX FIFO, a write pushes the TX FIFO)
+#ifndef HAL_UART0_Read_Data
+#define HAL_UART0_Read_Data()          (UART0->DR)
+#define HAL_UART0_Write_Data(data)     (UART0->DR = (data))
+#endif
+
+// EEPROM data register accessors (a write starts programming the selected word)
+#ifndef HAL_EEPROM_Read_Data
+#define HAL_EEPROM_Read_Data()         (EEPROM->EERDWR)
+#define HAL_EEPROM_Write_Data(data)    (EEPROM->EERDWR = (data))
+#endif
+
+// Fixed seed for the pseudo-random number generator (0 seeds it from hardware entropy)
+#ifndef HAL_RANDOM_SEED
+#define HAL_RANDOM_SEED()              0
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file Histogram.c
+ *
+ * @brief Source code for the log-linear reaction time histogram.
+ *
+ * This file contains the function definitions for the reaction time histogram.
+ *
+ * @note The bucket index is computed without branches: the doubling a time falls in comes
+ * from the position of its highest set bit (the CLZ instruction), and the 1 ms buckets are
+ * selected with a mask rather than a comparison, so recording takes the same few cycles
+ * for every time.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Histogram.h"
+#include "HAL.h"
+
+// Largest offset from HISTOGRAM_MIN_MS inside the range, in milliseconds
+#define HISTOGRAM_MAX_OFFSET_MS     ((1 << (HISTOGRAM_LINEAR_BITS + HISTOGRAM_OCTAVES)) - 1)
+
+void Histogram_Reset(Histogram *histogram)
+{
+    histogram->count = 0;
+    for (uint16_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        histogram->buckets[i] = 0;
+    }
+}
+
+void Histogram_Record(Histogram *histogram, uint32_t reaction_time_us)
+{
+    uint16_t *bucket = &histogram->buckets[Histogram_Bucket_Index(reaction_time_us)];
+    
+    // Saturates at the largest count instead of wrapping to zero
+    *bucket += (*bucket != UINT16_MAX);
+    histogram->count++;
+}
+
+void Histogram_Merge(Histogram *destination, const Histogram *source)
+{
+    for (uint16_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        uint32_t sum = (uint32_t)destination->buckets[i] + source->buckets[i];
+        destination->buckets[i] = (sum > UINT16_MAX) ? UINT16_MAX : (uint16_t)sum;
+    }
+    destination->count += source->count;
+}
+
+uint16_t Histogram_Bucket_Index(uint32_t reaction_time_us)
+{
+    // Offset from HISTOGRAM_MIN_MS, clamped to 0 below the range and to the last bucket above it
+    int32_t offset = (int32_t)(reaction_time_us / 1000) - HISTOGRAM_MIN_MS;
+    offset &= ~(offset >> 31);
+    int32_t over = (HISTOGRAM_MAX_OFFSET_MS - offset) >> 31;
+    offset = (offset & ~over) | (HISTOGRAM_MAX_OFFSET_MS & over);
+    
+    // Doubling above the 1 ms buckets: 0 below 256 ms, then 1 to HISTOGRAM_OCTAVES
+    uint32_t octave = (31 - HISTOGRAM_LINEAR_BITS + 1) - __CLZ((uint32_t)offset | (HISTOGRAM_LINEAR_BUCKETS - 1));
+    uint32_t logarithmic = -((0 - octave) >> 31);    // All ones above the 1 ms buckets
+    
+    // Above the 1 ms buckets, each doubling is split into HISTOGRAM_SUB_BUCKETS equal buckets
+    uint32_t shift = (octave + HISTOGRAM_LINEAR_BITS - 1 - HISTOGRAM_SUB_BUCKET_BITS) & logarithmic;
+    uint32_t base = (HISTOGRAM_LINEAR_BUCKETS + ((octave - 2) << HISTOGRAM_SUB_BUCKET_BITS)) & logarithmic;
+    
+    return (uint16_t)(base + ((uint32_t)offset >> shift));
+}
+
+uint16_t Histogram_Bucket_Lower_Ms(uint16_t index)
+{
+    if (index < HISTOGRAM_LINEAR_BUCKETS)
+    {
+        return HISTOGRAM_MIN_MS + index;
+    }
+    
+    uint16_t octave = ((index - HISTOGRAM_LINEAR_BUCKETS) >> HISTOGRAM_SUB_BUCKET_BITS) + 1;
+    uint16_t sub_bucket = ((index - HISTOGRAM_LINEAR_BUCKETS) & (HISTOGRAM_SUB_BUCKETS - 1)) + HISTOGRAM_SUB_BUCKETS;
+    return HISTOGRAM_MIN_MS + (sub_bucket << (octave + HISTOGRAM_LINEAR_BITS - 1 - HISTOGRAM_SUB_BUCKET_BITS));
+}
+
+uint16_t Histogram_Bucket_Width_Ms(uint16_t index)
+{
+    if (index < HISTOGRAM_LINEAR_BUCKETS)
+    {
+        return 1;
+    }
+    
+    uint16_t octave = ((index - HISTOGRAM_LINEAR_BUCKETS) >> HISTOGRAM_SUB_BUCKET_BITS) + 1;
+    return 1 << (octave + HISTOGRAM_LINEAR_BITS - 1 - HISTOGRAM_SUB_BUCKET_BITS);
+}
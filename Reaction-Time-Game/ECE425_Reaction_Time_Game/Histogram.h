@@ -0,0 +1,48 @@
+/**
+ * @file Histogram.h
+ *
+ * @brief Header file for the log-linear reaction time histogram.
+ *
+ * This file contains the bucket layout, histogram structure and function prototypes for
+ * the reaction time histogram. The buckets are fixed, in the style of an HDR histogram,
+ * so a session of any length uses the same RAM and two histograms can be merged by adding
+ * their counts:
+ *  - 1 ms buckets from HISTOGRAM_MIN_MS (100 ms) to 355 ms, where most reaction times fall
+ *  - Above that, HISTOGRAM_SUB_BUCKETS buckets per doubling of the time past HISTOGRAM_MIN_MS:
+ *    8 ms wide to 611 ms, 16 ms to 1123 ms and 32 ms to 2147 ms, so each bucket is within
+ *    about 3% of the times it holds
+ *
+ * Times below HISTOGRAM_MIN_MS are counted in the first bucket and times above the range
+ * in the last one.
+ *
+ * @note Counts saturate at 65535 per bucket. A histogram takes 708 bytes.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Bucket layout
+#define HISTOGRAM_MIN_MS            100    // Fastest valid reaction time (ANTICIPATION_THRESHOLD_MS)
+#define HISTOGRAM_LINEAR_BITS       8      // 1 ms buckets for the first 256 ms
+#define HISTOGRAM_SUB_BUCKET_BITS   5      // Buckets per doubling above that, as a power of two
+#define HISTOGRAM_OCTAVES           3      // Doublings above the 1 ms buckets
+
+#define HISTOGRAM_LINEAR_BUCKETS    (1 << HISTOGRAM_LINEAR_BITS)
+#define HISTOGRAM_SUB_BUCKETS       (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_BUCKETS           (HISTOGRAM_LINEAR_BUCKETS + (HISTOGRAM_OCTAVES * HISTOGRAM_SUB_BUCKETS))
+
+// Reaction time histogram
+typedef struct
+{
+    uint32_t count;                          // Times recorded, including any in saturated buckets
+    uint16_t buckets[HISTOGRAM_BUCKETS];
+} Histogram;
+
+// Function Prototypes
+void Histogram_Reset(Histogram *histogram);
+void Histogram_Record(Histogram *histogram, uint32_t reaction_time_us);
+void Histogram_Merge(Histogram *destination, const Histogram *source);
+uint16_t Histogram_Bucket_Index(uint32_t reaction_time_us);
+uint16_t Histogram_Bucket_Lower_Ms(uint16_t index);     // First millisecond in the bucket
+uint16_t Histogram_Bucket_Width_Ms(uint16_t index);
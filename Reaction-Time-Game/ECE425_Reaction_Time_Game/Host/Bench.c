@@ -0,0 +1,303 @@
+/**
+ * @file Bench.c
+ *
+ * @brief Host benchmarks for the firmware routines that run on every trial.
+ *
+ * This file links the unmodified firmware sources against the host simulator's register
+ * file and times the per-trial routines with the host's monotonic clock. Each benchmark
+ * runs a warmup batch, then a number of timed repetitions of a fixed batch of operations,
+ * and reports the fastest and the median repetition in ns per operation, plus throughput.
+ *
+ * Benchmarks:
+ *  - format_unsigned: one "%u" conversion (Format_String), as in every report line
+ *  - format_reaction_line: the "Reaction time: %u.%03u ms" line of a valid trial
+ *  - random_next: one xoshiro128** output (Random_Next)
+ *  - foreperiod_uniform, foreperiod_exponential: one foreperiod draw (Foreperiod_Draw)
+ *  - statistics_add_trial: one valid trial added to the streaming statistics, with the
+ *    channel reset every BENCH_SESSION_TRIALS trials as a new session would
+ *  - statistics_summary: one summary of a channel (Statistics_Get_Summary)
+ *  - histogram_record: one reaction time added to the log-linear histogram
+ *  - state_transition: one game state change (Timer_Wheel_Start of the state timer)
+ *  - button_arm: arming SW1 for a round (GPIO_Enable_Interrupt)
+ *  - button_arm_press_isr: arming SW1, then the Timer 2A capture interrupt for the press
+ *    edge (Timer2A_Handler through the debounce scheduling)
+ *
+ * @note Usage: bench [-n operations] [-r repetitions] [-j]
+ *  - -n operations   Operations per timed repetition (default 100000)
+ *  - -r repetitions  Timed repetitions per benchmark (default 15)
+ *  - -j              Prints one JSON object per benchmark instead of a table, so results
+ *                    can be saved and compared between revisions
+ *
+ * The register-level benchmarks (button_arm, button_arm_press_isr, state_transition) go
+ * through the simulated register file, where every peripheral access synchronizes the
+ * virtual peripherals. They compare revisions of the firmware with each other, not with
+ * the cycle counts of the LaunchPad (see the Diagnostics screen for those).
+ *
+ * @author Benjamin Nguyen
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "TM4C123GH6PM.h"
+#include "Sim.h"
+#include "../Foreperiod.h"
+#include "../Format.h"
+#include "../GPIO.h"
+#include "../Histogram.h"
+#include "../Random.h"
+#include "../Statistics.h"
+#include "../Timer_Wheel.h"
+
+#define BENCH_MAX_REPETITIONS   101
+#define BENCH_TIMER2A_CAE       0x04    // Timer 2A capture event (RIS Bit 2)
+#define BENCH_SESSION_TRIALS    1000    // Longest session (MAX_ROUNDS in main.c)
+
+// Timer 2A interrupt handler (Timer_2A_Capture.c)
+void Timer2A_Handler(void);
+
+typedef struct
+{
+    const char *name;
+    void (*run)(uint32_t operations);
+} Bench_Case;
+
+// Command-line options
+static uint32_t option_operations = 100000;
+static uint32_t option_repetitions = 15;
+static uint8_t option_json = 0;
+
+// Results are folded into the sink so the compiler cannot drop the work
+static volatile uint32_t bench_sink = 0;
+static Soft_Timer bench_timer;
+
+static void Bench_Task(void)
+{
+}
+
+static void Bench_Format_Unsigned(uint32_t operations)
+{
+    char buffer[16];
+    uint32_t value = 123456789;
+    
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        bench_sink += Format_String(buffer, sizeof(buffer), "%u", value);
+        value = (value * 1664525) + 1013904223;
+    }
+}
+
+static void Bench_Format_Reaction_Line(uint32_t operations)
+{
+    char buffer[64];
+    uint32_t reaction_time_us = 150000;
+    
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        bench_sink += Format_String(buffer, sizeof(buffer), "Reaction time: %u.%03u ms\r\n", reaction_time_us / 1000,
+                                    reaction_time_us % 1000);
+        reaction_time_us = 150000 + ((reaction_time_us * 7) % 350000);
+    }
+}
+
+static void Bench_Random_Next(uint32_t operations)
+{
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        bench_sink += Random_Next();
+    }
+}
+
+static void Bench_Foreperiod_Uniform(uint32_t operations)
+{
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        bench_sink += Foreperiod_Draw(FOREPERIOD_UNIFORM);
+    }
+}
+
+static void Bench_Foreperiod_Exponential(uint32_t operations)
+{
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        bench_sink += Foreperiod_Draw(FOREPERIOD_EXPONENTIAL);
+    }
+}
+
+static void Bench_Statistics_Add_Trial(uint32_t operations)
+{
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        if ((i % BENCH_SESSION_TRIALS) == 0)
+        {
+            Statistics_Reset();
+        }
+        Statistics_Add_Trial(0, RESULT_VALID, 150000 + (Random_Next() % 350000));
+    }
+}
+
+static void Bench_Histogram_Record(uint32_t operations)
+{
+    static Histogram histogram;
+    
+    Histogram_Reset(&histogram);
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        Histogram_Record(&histogram, 150000 + (Random_Next() % 350000));
+    }
+}
+
+static void Bench_Statistics_Summary(uint32_t operations)
+{
+    Statistics_Summary summary;
+    
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        Statistics_Get_Summary(0, &summary);
+        bench_sink += summary.median_us;
+    }
+}
+
+static void Bench_State_Transition(uint32_t operations)
+{
+    // The game engine enters a state by restarting its one timer, at the durations it uses
+    static const uint32_t durations_ms[] = { 500, 2000, 2500, 2020, 2000 };
+    
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        Timer_Wheel_Start(&bench_timer, durations_ms[i % 5], 0, &Bench_Task);
+    }
+    Timer_Wheel_Stop(&bench_timer);
+}
+
+static void Bench_Button_Arm(uint32_t operations)
+{
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        GPIO_Enable_Interrupt(1);
+    }
+    GPIO_Disable_Interrupt();
+}
+
+static void Bench_Button_Arm_Press_ISR(uint32_t operations)
+{
+    for (uint32_t i = 0; i < operations; i++)
+    {
+        GPIO_Enable_Interrupt(1);
+        
+        // A press edge latched by Timer 2A, as the simulator latches it on a PF4 edge
+        sim_timer[2].TAR = 0x00FFFFFF - (i & 0xFFFF);
+        sim_timer[2].RIS |= BENCH_TIMER2A_CAE;
+        Timer2A_Handler();
+    }
+    GPIO_Disable_Interrupt();
+}
+
+static const Bench_Case bench_cases[] =
+{
+    { "format_unsigned",         &Bench_Format_Unsigned },
+    { "format_reaction_line",    &Bench_Format_Reaction_Line },
+    { "random_next",             &Bench_Random_Next },
+    { "foreperiod_uniform",      &Bench_Foreperiod_Uniform },
+    { "foreperiod_exponential",  &Bench_Foreperiod_Exponential },
+    { "statistics_add_trial",    &Bench_Statistics_Add_Trial },
+    { "statistics_summary",      &Bench_Statistics_Summary },
+    { "histogram_record",        &Bench_Histogram_Record },
+    { "state_transition",        &Bench_State_Transition },
+    { "button_arm",              &Bench_Button_Arm },
+    { "button_arm_press_isr",    &Bench_Button_Arm_Press_ISR }
+};
+#define BENCH_CASE_COUNT (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+static uint64_t Bench_Time_Ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static int Bench_Compare(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    
+    return (x > y) - (x < y);
+}
+
+static void Bench_Run(const Bench_Case *bench)
+{
+    double ns_per_operation[BENCH_MAX_REPETITIONS];
+    
+    // One untimed batch warms the caches and the branch predictors
+    (*bench->run)(option_operations);
+    
+    for (uint32_t repetition = 0; repetition < option_repetitions; repetition++)
+    {
+        uint64_t start_ns = Bench_Time_Ns();
+        (*bench->run)(option_operations);
+        ns_per_operation[repetition] = (double)(Bench_Time_Ns() - start_ns) / option_operations;
+    }
+    
+    qsort(ns_per_operation, option_repetitions, sizeof(double), &Bench_Compare);
+    double best = ns_per_operation[0];
+    double median = ns_per_operation[option_repetitions / 2];
+    double operations_per_s = (median > 0) ? (1e9 / median) : 0.0;
+    
+    if (option_json)
+    {
+        printf("{\"benchmark\":\"%s\",\"operations\":%u,\"repetitions\":%u,\"best_ns_per_op\":%.2f,"
+               "\"median_ns_per_op\":%.2f,\"ops_per_s\":%.0f}\n", bench->name, (unsigned)option_operations,
+               (unsigned)option_repetitions, best, median, operations_per_s);
+    }
+    else
+    {
+        printf("%-24s %12.2f %12.2f %14.0f\n", bench->name, best, median, operations_per_s);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int option;
+    
+    while ((option = getopt(argc, argv, "n:r:j")) != -1)
+    {
+        switch (option)
+        {
+            case 'n': option_operations = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'r': option_repetitions = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'j': option_json = 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-n operations] [-r repetitions] [-j]\n", argv[0]);
+                return 2;
+        }
+    }
+    
+    if ((option_operations == 0) || (option_repetitions == 0) || (option_repetitions > BENCH_MAX_REPETITIONS))
+    {
+        fprintf(stderr, "bench: operations must be at least 1 and repetitions 1 to %u\n", BENCH_MAX_REPETITIONS);
+        return 2;
+    }
+    
+    // Brings up the peripherals the routines use, as main does on the target
+    Sim_Init();
+    Timer_Wheel_Init();
+    GPIO_Init();
+    Random_Seed(1);
+    Statistics_Reset();
+    
+    if (!option_json)
+    {
+        printf("%-24s %12s %12s %14s\n", "benchmark", "best ns/op", "median ns/op", "ops/s");
+    }
+    
+    for (uint8_t i = 0; i < BENCH_CASE_COUNT; i++)
+    {
+        Bench_Run(&bench_cases[i]);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,1123 @@
+/**
+ * @file Sim.c
+ *
+ * @brief Source code for the host simulator.
+ *
+ * This file contains the virtual register file, the peripheral models and the interrupt
+ * dispatcher of the Linux host simulator.
+ *
+ * @note The peripheral models cover what the firmware uses:
+ *  - GPIO Ports A, B and F: data (including the masked DATA_BITS aliases), direction, edge
+ *    interrupts and alternate function routing
+ *  - Calibration loopback: a wire from PB3 to PB2, with PB2 pulled down when PB3 is an input
+ *  - GPTM Timers 0 to 3: periodic, one-shot and input edge-time capture modes with time-outs,
+ *    and the Timer 0 SYNC register that restarts the selected Timer A counters together.
+ *    A capture latches the counter SIM_CAPTURE_LATENCY_CYCLES after the pin edge, for the
+ *    input synchronizer and edge detector
+ *  - UART0: 16-entry RX FIFO fed at line rate, TX written straight to the transmit task
+ *  - uDMA: basic mode transfers, completed on the next register access
+ *  - System control: peripheral clocks are ready and the PLL is locked as soon as enabled
+ *  - SysTick and NVIC: reload interrupts from the system clock or PIOSC / 4 (CLK_SRC), enable
+ *    and pending state
+ *  - Deep sleep: WFI with SLEEPDEEP set in the SCR register is timed separately
+ *  - DWT cycle counter: host monotonic time scaled to SIM_SYSTEM_CLOCK_HZ
+ *  - EEPROM: 512 words, erased (0xFFFFFFFF) or backed by a file (Sim_EEPROM_Open), with a
+ *    fixed busy time after every write
+ *  - ADC0 sample sequencer 3: a software-triggered conversion completes on the next
+ *    register access with a room temperature sensor code plus noise from the host clock
+ *
+ * The virtual clock only advances while the firmware sleeps, so code runs in zero virtual
+ * time. The DWT cycle counter is the exception: it follows the host's own execution time,
+ * so profiling probes report what the firmware code costs on the host in system clock cycles.
+ *
+ * Writes to write-1-to-clear and write-only registers (ICR, ENASET, NVIC ISER/ICER, ...) are
+ * applied by Sim_Sync on the next peripheral access and the register is cleared again. The
+ * uDMA CHIS register is both read and written, so its unused bit 31 is kept set while exposed
+ * to detect a write.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include "TM4C123GH6PM.h"
+#include "Sim.h"
+
+// Interrupt numbers
+#define SIM_IRQ_UART0       5
+#define SIM_IRQ_TIMER0A     19
+#define SIM_IRQ_TIMER1A     21
+#define SIM_IRQ_TIMER2A     23
+#define SIM_IRQ_GPIOF       30
+
+#define SIM_NO_EVENT        UINT64_MAX
+#define SIM_MAX_PIN_EVENTS  32
+#define SIM_RX_QUEUE_SIZE   4096
+#define SIM_RX_FIFO_SIZE    16
+#define SIM_CHIS_TAG        0x80000000
+#define SIM_UART_DMA_CHANNEL_BIT_MASK  (1 << 9)
+#define SIM_ADC_SS3_BIT_MASK           0x08
+#define SIM_ADC_TEMPERATURE_CODE       2027    // 25 C on the internal temperature sensor
+
+// Pin edge to timer capture: two-stage input synchronizer plus the edge detector
+#define SIM_CAPTURE_LATENCY_CYCLES     3
+
+// Calibration loopback wire on Port B
+#define SIM_PIN_LOOPBACK_OUTPUT        0x08    // PB3
+#define SIM_PIN_LOOPBACK_INPUT         0x04    // PB2, T3CCP0
+
+// Interrupt handlers provided by the firmware (weak, since not every build defines all of them)
+extern void SysTick_Handler(void) __attribute__((weak));
+extern void UART0_Handler(void) __attribute__((weak));
+extern void Timer0A_Handler(void) __attribute__((weak));
+extern void Timer1A_Handler(void) __attribute__((weak));
+extern void Timer2A_Handler(void) __attribute__((weak));
+extern void GPIOF_Handler(void) __attribute__((weak));
+
+// uDMA channel control structure entry, same layout as the firmware's control table
+typedef struct
+{
+    void * volatile Source_End_Pointer;
+    void * volatile Destination_End_Pointer;
+    volatile uint32_t Control_Word;
+    volatile uint32_t Unused;
+} Sim_UDMA_Control_Entry;
+
+// Scheduled pin level change
+typedef struct
+{
+    uint64_t time;
+    uint8_t pin_mask;
+    uint8_t level;
+} Sim_Pin_Event;
+
+// Timer model state
+typedef struct
+{
+    uint8_t running;
+    uint64_t base;
+    uint64_t periods;
+} Sim_Timer_State;
+
+// Virtual register file
+GPIOA_Type sim_gpioa;
+GPIOA_Type sim_gpiob;
+GPIOA_Type sim_gpiof;
+UART0_Type sim_uart0;
+TIMER0_Type sim_timer[4];
+SYSCTL_Type sim_sysctl;
+UDMA_Type sim_udma;
+EEPROM_Type sim_eeprom;
+ADC0_Type sim_adc0;
+NVIC_Type sim_nvic;
+SysTick_Type sim_systick;
+SCB_Type sim_scb;
+DWT_Type sim_dwt;
+CoreDebug_Type sim_coredebug;
+
+// Virtual clock and core state
+static uint64_t sim_cycles = 0;
+static uint32_t sim_primask = 0;
+static uint32_t sim_nvic_enabled = 0;
+static uint64_t sim_interrupt_count = 0;
+static uint64_t sim_deep_sleep_cycles = 0;
+static uint8_t sim_in_handler = 0;
+
+// SysTick model state
+static uint8_t sim_systick_running = 0;
+static uint64_t sim_systick_base = 0;
+static uint64_t sim_systick_reloads = 0;
+static uint8_t sim_systick_pending = 0;
+
+// DWT model state
+static uint8_t sim_dwt_running = 0;
+static uint64_t sim_dwt_base_ns = 0;
+static uint32_t sim_dwt_base_count = 0;
+static uint32_t sim_dwt_published = 0;
+
+// Timer model state
+static Sim_Timer_State sim_timer_state[4];
+
+// Port F pin levels (buttons idle high with the pull-ups)
+static uint8_t sim_portf_levels = 0xFF;
+static uint8_t sim_portf_leds = 0;
+static Sim_Pin_Event sim_pin_events[SIM_MAX_PIN_EVENTS];
+static uint8_t sim_pin_event_count = 0;
+
+// Port B pin levels (the loopback input idles low with its pull-down)
+static uint8_t sim_portb_levels = 0;
+
+// Copy of the DATA_BITS aliases as last published, per port
+typedef struct
+{
+    uint32_t data;
+    uint32_t aliases[255];
+} Sim_GPIO_Aliases;
+
+static Sim_GPIO_Aliases sim_gpioa_published;
+static Sim_GPIO_Aliases sim_gpiob_published;
+static Sim_GPIO_Aliases sim_gpiof_published;
+
+// UART model state
+static char sim_rx_queue[SIM_RX_QUEUE_SIZE];
+static uint32_t sim_rx_queue_head = 0;
+static uint32_t sim_rx_queue_tail = 0;
+static uint64_t sim_rx_next_arrival = SIM_NO_EVENT;
+static char sim_rx_fifo[SIM_RX_FIFO_SIZE];
+static uint8_t sim_rx_fifo_count = 0;
+
+// uDMA model state
+static uint32_t sim_udma_enabled = 0;
+static uint32_t sim_udma_chis = 0;
+
+// EEPROM model state
+static uint32_t sim_eeprom_words[SIM_EEPROM_WORD_COUNT];
+static uint64_t sim_eeprom_done = 0;
+static FILE *sim_eeprom_file = NULL;
+
+// Fixed seed for the firmware's pseudo-random number generator (0: use entropy)
+static uint32_t sim_random_seed = 0;
+
+// Front-end hooks
+static void (*Sim_UART_Transmit_Task)(char data);
+static void (*Sim_LED_Task)(uint8_t leds);
+static void (*Sim_Idle_Task)(void);
+
+static void Sim_Process_ICR(volatile uint32_t *ris, volatile uint32_t *icr)
+{
+    *ris &= ~*icr;
+    *icr = 0;
+}
+
+static uint64_t Sim_Timer_Period(TIMER0_Type *timer)
+{
+    // 32-bit configuration
+    if (timer->CFG == 0)
+    {
+        return (uint64_t)timer->TAILR + 1;
+    }
+    
+    // 16-bit edge-time capture uses the prescaler as a counter extension
+    if ((timer->TAMR & 0x07) == 0x07)
+    {
+        return ((((uint64_t)timer->TAPR & 0xFF) << 16) | (timer->TAILR & 0xFFFF)) + 1;
+    }
+    
+    // 16-bit periodic or one-shot uses the prescaler as a clock divider
+    return ((uint64_t)(timer->TAILR & 0xFFFF) + 1) * ((timer->TAPR & 0xFF) + 1);
+}
+
+static uint32_t Sim_Timer_Value_At(TIMER0_Type *timer, Sim_Timer_State *state, uint64_t cycles)
+{
+    uint64_t period = Sim_Timer_Period(timer);
+    uint64_t position = (cycles - state->base) % period;
+    
+    // TACDIR (Bit 4) selects counting up
+    return (uint32_t)((timer->TAMR & 0x10) ? position : (period - 1 - position));
+}
+
+static uint32_t Sim_Timer_Value(TIMER0_Type *timer, Sim_Timer_State *state)
+{
+    return Sim_Timer_Value_At(timer, state, sim_cycles);
+}
+
+// Latches a timer in input edge-time mode on an edge of its CCP pin that matches TAEVENT
+static void Sim_Timer_Capture(uint8_t index, uint8_t rising)
+{
+    TIMER0_Type *timer = &sim_timer[index];
+    uint32_t event_select = (timer->CTL >> 2) & 0x03;
+    uint8_t edge_match = (event_select == 3) || ((event_select == 0) && rising) || ((event_select == 1) && !rising);
+    
+    if (sim_timer_state[index].running && ((timer->TAMR & 0x07) == 0x07) && edge_match)
+    {
+        timer->TAR = Sim_Timer_Value_At(timer, &sim_timer_state[index], sim_cycles + SIM_CAPTURE_LATENCY_CYCLES);
+        timer->RIS |= 0x04;
+    }
+}
+
+static void Sim_Sync_Timer(uint8_t index)
+{
+    TIMER0_Type *timer = &sim_timer[index];
+    Sim_Timer_State *state = &sim_timer_state[index];
+    
+    Sim_Process_ICR(&timer->RIS, &timer->ICR);
+    
+    if (timer->CTL & 0x01)
+    {
+        if (!state->running)
+        {
+            state->running = 1;
+            state->base = sim_cycles;
+            state->periods = 0;
+        }
+        
+        uint64_t periods = (sim_cycles - state->base) / Sim_Timer_Period(timer);
+        if (periods > state->periods)
+        {
+            state->periods = periods;
+            timer->RIS |= 0x01;
+            
+            // One-shot mode stops at the time-out
+            if ((timer->TAMR & 0x03) == 0x01)
+            {
+                timer->CTL &= ~0x01;
+                state->running = 0;
+            }
+        }
+        
+        if (state->running)
+        {
+            timer->TAV = Sim_Timer_Value(timer, state);
+        }
+    }
+    else
+    {
+        state->running = 0;
+    }
+    
+    timer->MIS = timer->RIS & timer->IMR;
+}
+
+static void Sim_Sync_Timer_Restart(void)
+{
+    // SYNCTn fields (Bits 2n+1:2n) of the Timer 0 SYNC register, Bit 2n selects Timer A
+    uint32_t sync = sim_timer[0].SYNC;
+    
+    if (sync == 0)
+    {
+        return;
+    }
+    
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        if ((sync & (0x01 << (2 * i))) && (sim_timer[i].CTL & 0x01))
+        {
+            // The counter reloads and signals a time-out
+            sim_timer_state[i].running = 1;
+            sim_timer_state[i].base = sim_cycles;
+            sim_timer_state[i].periods = 0;
+            sim_timer[i].RIS |= 0x01;
+        }
+    }
+    
+    sim_timer[0].SYNC = 0;
+}
+
+static void Sim_Sync_GPIO(GPIOA_Type *port, uint8_t levels, Sim_GPIO_Aliases *published)
+{
+    uint32_t inputs = ~port->DIR & 0xFF;
+    uint8_t written = 0;
+    
+    // An alias that no longer reads back as published was written: the alias index is the
+    // address mask, and only the masked bits change (writing the current value changes nothing)
+    if (memcmp((const void *)port->DATA_BITS, published->aliases, sizeof(published->aliases)) != 0)
+    {
+        for (uint32_t mask = 1; mask < 255; mask++)
+        {
+            if (port->DATA_BITS[mask] != published->aliases[mask])
+            {
+                port->DATA = (port->DATA & ~mask) | (port->DATA_BITS[mask] & mask);
+            }
+        }
+        written = 1;
+    }
+    
+    Sim_Process_ICR(&port->RIS, &port->ICR);
+    port->DATA = (port->DATA & ~inputs) | (levels & inputs);
+    port->MIS = port->RIS & port->IM;
+    
+    if (written || (port->DATA != published->data))
+    {
+        for (uint32_t mask = 0; mask < 255; mask++)
+        {
+            published->aliases[mask] = port->DATA & mask;
+            port->DATA_BITS[mask] = published->aliases[mask];
+        }
+        published->data = port->DATA;
+    }
+}
+
+static void Sim_Sync_UART(void)
+{
+    Sim_Process_ICR(&sim_uart0.RIS, &sim_uart0.ICR);
+    
+    // The TX FIFO drains instantly, so it always reads as empty and never as busy
+    sim_uart0.FR = 0x80;
+    if (sim_rx_fifo_count == 0)
+    {
+        sim_uart0.FR |= 0x10;
+        sim_uart0.RIS &= ~0x50;
+    }
+    else
+    {
+        // RX and RX time-out interrupts are modeled as level signals
+        sim_uart0.RIS |= 0x50;
+        if (sim_rx_fifo_count == SIM_RX_FIFO_SIZE)
+        {
+            sim_uart0.FR |= 0x40;
+        }
+    }
+    
+    sim_uart0.MIS = sim_uart0.RIS & sim_uart0.IM;
+}
+
+static void Sim_Run_UDMA(void)
+{
+    Sim_UDMA_Control_Entry *table = (Sim_UDMA_Control_Entry *)sim_udma.CTLBASE;
+    
+    for (uint8_t channel = 0; channel < 32; channel++)
+    {
+        uint32_t channel_bit = (uint32_t)1 << channel;
+        
+        if (!(sim_udma_enabled & channel_bit) || (table == NULL))
+        {
+            continue;
+        }
+        
+        // Only the UART0 TX channel is driven by a peripheral request in this model
+        if ((channel == 9) && !(sim_uart0.DMACTL & 0x02))
+        {
+            continue;
+        }
+        
+        Sim_UDMA_Control_Entry *entry = &table[channel];
+        uint32_t control = entry->Control_Word;
+        uint32_t count = ((control >> 4) & 0x3FF) + 1;
+        uint32_t source_step = ((control >> 26) & 0x03) == 0x03 ? 0 : 1;
+        uint32_t destination_step = ((control >> 30) & 0x03) == 0x03 ? 0 : 1;
+        volatile uint8_t *source = (volatile uint8_t *)entry->Source_End_Pointer - ((count - 1) * source_step);
+        volatile uint8_t *destination = (volatile uint8_t *)entry->Destination_End_Pointer - ((count - 1) * destination_step);
+        
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (destination == (volatile uint8_t *)&sim_uart0.DR)
+            {
+                Sim_UART0_Write_Data(*source);
+            }
+            else
+            {
+                *destination = *source;
+            }
+            source += source_step;
+            destination += destination_step;
+        }
+        
+        // Marks the transfer as stopped and raises the completion interrupt
+        entry->Control_Word = control & ~0x3FF7;
+        sim_udma_enabled &= ~channel_bit;
+        sim_udma_chis |= channel_bit;
+    }
+}
+
+static void Sim_Sync_UDMA(void)
+{
+    sim_udma_enabled |= sim_udma.ENASET;
+    sim_udma_enabled &= ~sim_udma.ENACLR;
+    sim_udma.ENASET = 0;
+    sim_udma.ENACLR = 0;
+    
+    // A write to CHIS clears the tag bit along with the written channel bits
+    if ((sim_udma.CHIS & SIM_CHIS_TAG) == 0)
+    {
+        sim_udma_chis &= ~sim_udma.CHIS;
+    }
+    
+    if (sim_udma_enabled)
+    {
+        Sim_Run_UDMA();
+    }
+    
+    sim_udma.CHIS = sim_udma_chis | SIM_CHIS_TAG;
+}
+
+// SysTick period in system clock cycles, counting PIOSC / 4 when CLK_SRC (Bit 2) is clear
+static uint64_t Sim_SysTick_Period(void)
+{
+    uint64_t period = (uint64_t)(sim_systick.LOAD & 0x00FFFFFF) + 1;
+    
+    return (sim_systick.CTRL & 0x04) ? period : ((period * SIM_SYSTEM_CLOCK_HZ) / (SYSTEM_CLOCK_PIOSC_HZ / 4));
+}
+
+static void Sim_Sync_SysTick(void)
+{
+    uint64_t period = Sim_SysTick_Period();
+    uint64_t ticks = (sim_systick.CTRL & 0x04) ? 1 : (SIM_SYSTEM_CLOCK_HZ / (SYSTEM_CLOCK_PIOSC_HZ / 4));
+    
+    if (sim_systick.CTRL & 0x01)
+    {
+        if (!sim_systick_running)
+        {
+            sim_systick_running = 1;
+            sim_systick_base = sim_cycles;
+            sim_systick_reloads = 0;
+        }
+        
+        uint64_t reloads = (sim_cycles - sim_systick_base) / period;
+        if (reloads > sim_systick_reloads)
+        {
+            sim_systick_reloads = reloads;
+            sim_systick_pending = 1;
+            sim_systick.CTRL |= 0x10000;    // COUNTFLAG
+        }
+        
+        sim_systick.VAL = (uint32_t)((period - 1 - ((sim_cycles - sim_systick_base) % period)) / ticks);
+    }
+    else
+    {
+        sim_systick_running = 0;
+    }
+    
+    // PENDSTSET (Bit 26) mirrors a SysTick interrupt that has not been serviced yet
+    if (sim_systick_pending)
+    {
+        sim_scb.ICSR |= 0x04000000;
+    }
+    else
+    {
+        sim_scb.ICSR &= ~0x04000000;
+    }
+}
+
+static uint64_t Sim_Host_Time_Ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+void Sim_Sync_DWT(void)
+{
+    // CYCCNT counts only while TRCENA (DEMCR Bit 24) and CYCCNTENA (CTRL Bit 0) are set
+    if ((sim_coredebug.DEMCR & 0x01000000) && (sim_dwt.CTRL & 0x01))
+    {
+        uint64_t now_ns = Sim_Host_Time_Ns();
+        
+        // A value other than the last one published was written by the firmware
+        if (!sim_dwt_running || (sim_dwt.CYCCNT != sim_dwt_published))
+        {
+            sim_dwt_running = 1;
+            sim_dwt_base_ns = now_ns;
+            sim_dwt_base_count = sim_dwt.CYCCNT;
+        }
+        
+        sim_dwt_published = sim_dwt_base_count +
+            (uint32_t)(((now_ns - sim_dwt_base_ns) * SIM_CYCLES_PER_US) / 1000);
+        sim_dwt.CYCCNT = sim_dwt_published;
+    }
+    else
+    {
+        sim_dwt_running = 0;
+    }
+}
+
+static void Sim_Sync_EEPROM(void)
+{
+    // 32 blocks of 16 words, no retry errors, busy until the last write has finished
+    sim_eeprom.EESIZE = (32 << 16) | SIM_EEPROM_WORD_COUNT;
+    sim_eeprom.EESUPP = 0;
+    sim_eeprom.EEDONE = (sim_cycles < sim_eeprom_done) ? 0x01 : 0;
+}
+
+static void Sim_Sync_ADC(void)
+{
+    Sim_Process_ICR(&sim_adc0.RIS, &sim_adc0.ISC);
+    
+    // A processor-triggered sample on an enabled sequencer 3 converts right away
+    if (sim_adc0.PSSI & sim_adc0.ACTSS & SIM_ADC_SS3_BIT_MASK)
+    {
+        sim_adc0.SSFIFO3 = SIM_ADC_TEMPERATURE_CODE + (uint32_t)(Sim_Host_Time_Ns() & 0x07) - 3;
+        sim_adc0.RIS |= SIM_ADC_SS3_BIT_MASK;
+    }
+    sim_adc0.PSSI = 0;
+}
+
+static uint16_t Sim_EEPROM_Address(void)
+{
+    return ((sim_eeprom.EEBLOCK * 16) + (sim_eeprom.EEOFFSET & 0x0F)) % SIM_EEPROM_WORD_COUNT;
+}
+
+static void Sim_Update_LEDs(void)
+{
+    uint8_t leds = sim_gpiof.DATA & sim_gpiof.DIR & 0x0E;
+    
+    if (leds != sim_portf_leds)
+    {
+        sim_portf_leds = leds;
+        if (Sim_LED_Task)
+        {
+            (*Sim_LED_Task)(leds);
+        }
+    }
+}
+
+// Carries the PB3 output level to PB2, with a Timer 3A capture when PB2 is routed to T3CCP0
+static void Sim_Sync_Loopback(void)
+{
+    uint8_t level = ((sim_gpiob.DIR & SIM_PIN_LOOPBACK_OUTPUT) && (sim_gpiob.DATA & SIM_PIN_LOOPBACK_OUTPUT)) ?
+                    SIM_PIN_LOOPBACK_INPUT : 0;
+    
+    if (level == (sim_portb_levels & SIM_PIN_LOOPBACK_INPUT))
+    {
+        return;
+    }
+    
+    sim_portb_levels = (sim_portb_levels & ~SIM_PIN_LOOPBACK_INPUT) | level;
+    Sim_Sync_GPIO(&sim_gpiob, sim_portb_levels, &sim_gpiob_published);
+    
+    if ((sim_gpiob.AFSEL & SIM_PIN_LOOPBACK_INPUT) && (((sim_gpiob.PCTL >> 8) & 0x0F) == 7))
+    {
+        Sim_Timer_Capture(3, level != 0);
+        sim_timer[3].MIS = sim_timer[3].RIS & sim_timer[3].IMR;
+    }
+}
+
+void Sim_Sync(void)
+{
+    // NVIC enable and disable writes, applied in the order they were made
+    sim_nvic_enabled = (sim_nvic_enabled & ~sim_nvic.ICER[0]) | sim_nvic.ISER[0];
+    sim_nvic.ISER[0] = 0;
+    sim_nvic.ICER[0] = 0;
+    
+    // Peripheral clocks are ready immediately
+    sim_sysctl.PRGPIO = sim_sysctl.RCGCGPIO;
+    sim_sysctl.PRTIMER = sim_sysctl.RCGCTIMER;
+    sim_sysctl.PRUART = sim_sysctl.RCGCUART;
+    sim_sysctl.PRDMA = sim_sysctl.RCGCDMA;
+    sim_sysctl.PREEPROM = sim_sysctl.RCGCEEPROM;
+    sim_sysctl.PRADC = sim_sysctl.RCGCADC;
+    
+    // The PLL locks as soon as it is powered on (PWRDN2, RCC2 Bit 13)
+    if (!(sim_sysctl.RCC2 & 0x2000))
+    {
+        sim_sysctl.RIS |= 0x40;
+    }
+    
+    Sim_Sync_GPIO(&sim_gpioa, 0xFF, &sim_gpioa_published);
+    Sim_Sync_GPIO(&sim_gpiob, sim_portb_levels, &sim_gpiob_published);
+    Sim_Sync_GPIO(&sim_gpiof, sim_portf_levels, &sim_gpiof_published);
+    Sim_Update_LEDs();
+    
+    Sim_Sync_Timer_Restart();
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        Sim_Sync_Timer(i);
+    }
+    Sim_Sync_Loopback();
+    
+    Sim_Sync_UART();
+    Sim_Sync_UDMA();
+    Sim_Sync_SysTick();
+    Sim_Sync_EEPROM();
+    Sim_Sync_ADC();
+}
+
+uint32_t Sim_UART0_Read_Data(void)
+{
+    uint32_t data = 0;
+    
+    if (sim_rx_fifo_count > 0)
+    {
+        data = (uint8_t)sim_rx_fifo[0];
+        sim_rx_fifo_count--;
+        memmove(&sim_rx_fifo[0], &sim_rx_fifo[1], sim_rx_fifo_count);
+    }
+    
+    Sim_Sync_UART();
+    return data;
+}
+
+void Sim_UART0_Write_Data(uint32_t data)
+{
+    if (Sim_UART_Transmit_Task)
+    {
+        (*Sim_UART_Transmit_Task)((char)data);
+    }
+    else
+    {
+        putchar((char)data);
+    }
+    
+    // The TX FIFO drains through the trigger level right away
+    sim_uart0.RIS |= 0x20;
+    sim_uart0.MIS = sim_uart0.RIS & sim_uart0.IM;
+}
+
+uint32_t Sim_EEPROM_Read_Data(void)
+{
+    Sim_Sync();
+    return sim_eeprom_words[Sim_EEPROM_Address()];
+}
+
+void Sim_EEPROM_Write_Data(uint32_t data)
+{
+    Sim_Sync();
+    
+    // The controller ignores writes while it is still busy
+    if (sim_eeprom.EEDONE & 0x01)
+    {
+        return;
+    }
+    
+    uint16_t address = Sim_EEPROM_Address();
+    sim_eeprom_words[address] = data;
+    sim_eeprom_done = sim_cycles + (SIM_EEPROM_WRITE_US * SIM_CYCLES_PER_US);
+    
+    // Writes through to the backing file, so the contents survive the process
+    if (sim_eeprom_file)
+    {
+        fseek(sim_eeprom_file, address * 4, SEEK_SET);
+        fwrite(&sim_eeprom_words[address], 4, 1, sim_eeprom_file);
+        fflush(sim_eeprom_file);
+    }
+    
+    Sim_Sync_EEPROM();
+}
+
+// Applies a pin level change on Port F, including GPIO edge interrupts and timer captures
+static void Sim_Apply_Pin_Event(Sim_Pin_Event *event)
+{
+    uint8_t previous = sim_portf_levels;
+    
+    if (event->level)
+    {
+        sim_portf_levels |= event->pin_mask;
+    }
+    else
+    {
+        sim_portf_levels &= ~event->pin_mask;
+    }
+    
+    uint8_t rising = ~previous & sim_portf_levels;
+    uint8_t falling = previous & ~sim_portf_levels;
+    uint8_t changed = rising | falling;
+    
+    if (!changed)
+    {
+        return;
+    }
+    
+    Sim_Sync();
+    
+    // GPIO edge-sensitive interrupts (IS = 0), on both edges (IBE = 1) or the edge selected by IEV
+    for (uint8_t pin = 0; pin < 8; pin++)
+    {
+        uint8_t bit = 1 << pin;
+        
+        if (!(changed & bit) || (sim_gpiof.IS & bit))
+        {
+            continue;
+        }
+        
+        if ((sim_gpiof.IBE & bit) || ((sim_gpiof.IEV & bit) ? (rising & bit) : (falling & bit)))
+        {
+            sim_gpiof.RIS |= bit;
+        }
+        
+        // Input capture on T0CCP0 (PF0) and T2CCP0 (PF4) when the pin is routed to the timer
+        uint8_t timer_index = (pin == 0) ? 0 : (pin == 4) ? 2 : 0xFF;
+        if ((timer_index != 0xFF) && (sim_gpiof.AFSEL & bit) && (((sim_gpiof.PCTL >> (pin * 4)) & 0x0F) == 7))
+        {
+            Sim_Timer_Capture(timer_index, (rising & bit) != 0);
+        }
+    }
+    
+    Sim_Sync();
+}
+
+static void Sim_Process_Events(void)
+{
+    // Pin events in time order
+    uint8_t processed;
+    do
+    {
+        processed = 0;
+        uint8_t earliest = 0xFF;
+        
+        for (uint8_t i = 0; i < sim_pin_event_count; i++)
+        {
+            if ((sim_pin_events[i].time <= sim_cycles) &&
+                ((earliest == 0xFF) || (sim_pin_events[i].time < sim_pin_events[earliest].time)))
+            {
+                earliest = i;
+            }
+        }
+        
+        if (earliest != 0xFF)
+        {
+            Sim_Pin_Event event = sim_pin_events[earliest];
+            sim_pin_events[earliest] = sim_pin_events[--sim_pin_event_count];
+            Sim_Apply_Pin_Event(&event);
+            processed = 1;
+        }
+    } while (processed);
+    
+    // UART characters arriving at line rate
+    while ((sim_rx_next_arrival <= sim_cycles) && (sim_rx_fifo_count < SIM_RX_FIFO_SIZE))
+    {
+        sim_rx_fifo[sim_rx_fifo_count++] = sim_rx_queue[sim_rx_queue_tail % SIM_RX_QUEUE_SIZE];
+        sim_rx_queue_tail++;
+        sim_rx_next_arrival = (sim_rx_queue_tail != sim_rx_queue_head) ?
+                              (sim_rx_next_arrival + SIM_UART_CHARACTER_CYCLES) : SIM_NO_EVENT;
+    }
+    
+    // An overrun RX FIFO holds the next character until there is room
+    if (sim_rx_next_arrival < sim_cycles)
+    {
+        sim_rx_next_arrival = sim_cycles + SIM_UART_CHARACTER_CYCLES;
+    }
+}
+
+static uint8_t Sim_Interrupt_Pending(void)
+{
+    if (sim_systick_pending && (sim_systick.CTRL & 0x02))
+    {
+        return 1;
+    }
+    
+    uint32_t pending = 0;
+    if ((sim_uart0.RIS & sim_uart0.IM) || (sim_udma_chis & SIM_UART_DMA_CHANNEL_BIT_MASK))
+    {
+        pending |= 1 << SIM_IRQ_UART0;
+    }
+    if (sim_timer[0].RIS & sim_timer[0].IMR)
+    {
+        pending |= 1 << SIM_IRQ_TIMER0A;
+    }
+    if (sim_timer[1].RIS & sim_timer[1].IMR)
+    {
+        pending |= 1 << SIM_IRQ_TIMER1A;
+    }
+    if (sim_timer[2].RIS & sim_timer[2].IMR)
+    {
+        pending |= 1 << SIM_IRQ_TIMER2A;
+    }
+    if (sim_gpiof.RIS & sim_gpiof.IM)
+    {
+        pending |= 1 << SIM_IRQ_GPIOF;
+    }
+    
+    return (pending & sim_nvic_enabled) != 0;
+}
+
+static void Sim_Call_Handler(void (*handler)(void))
+{
+    if (handler)
+    {
+        sim_in_handler = 1;
+        (*handler)();
+        sim_in_handler = 0;
+        sim_interrupt_count++;
+    }
+}
+
+// Runs every pending and enabled handler, SysTick first and then by interrupt number
+static void Sim_Dispatch(void)
+{
+    for (uint16_t guard = 0; guard < 1000; guard++)
+    {
+        Sim_Sync();
+        
+        if (sim_systick_pending && (sim_systick.CTRL & 0x02))
+        {
+            sim_systick_pending = 0;
+            sim_systick.CTRL &= ~0x10000;
+            Sim_Call_Handler(SysTick_Handler);
+        }
+        else if ((sim_nvic_enabled & (1 << SIM_IRQ_UART0)) &&
+                 ((sim_uart0.RIS & sim_uart0.IM) || (sim_udma_chis & SIM_UART_DMA_CHANNEL_BIT_MASK)))
+        {
+            Sim_Call_Handler(UART0_Handler);
+        }
+        else if ((sim_nvic_enabled & (1 << SIM_IRQ_TIMER0A)) && (sim_timer[0].RIS & sim_timer[0].IMR))
+        {
+            Sim_Call_Handler(Timer0A_Handler);
+        }
+        else if ((sim_nvic_enabled & (1 << SIM_IRQ_TIMER1A)) && (sim_timer[1].RIS & sim_timer[1].IMR))
+        {
+            Sim_Call_Handler(Timer1A_Handler);
+        }
+        else if ((sim_nvic_enabled & (1 << SIM_IRQ_TIMER2A)) && (sim_timer[2].RIS & sim_timer[2].IMR))
+        {
+            Sim_Call_Handler(Timer2A_Handler);
+        }
+        else if ((sim_nvic_enabled & (1 << SIM_IRQ_GPIOF)) && (sim_gpiof.RIS & sim_gpiof.IM))
+        {
+            Sim_Call_Handler(GPIOF_Handler);
+        }
+        else
+        {
+            return;
+        }
+    }
+    
+    fprintf(stderr, "sim: interrupt storm, a handler is not clearing its interrupt\n");
+}
+
+static uint64_t Sim_Next_Event(void)
+{
+    uint64_t next = SIM_NO_EVENT;
+    
+    if ((sim_systick.CTRL & 0x03) == 0x03)
+    {
+        uint64_t period = Sim_SysTick_Period();
+        uint64_t tick = sim_systick_base + ((sim_systick_reloads + 1) * period);
+        next = (tick < next) ? tick : next;
+    }
+    
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        if (sim_timer_state[i].running && (sim_timer[i].IMR & 0x01))
+        {
+            uint64_t timeout = sim_timer_state[i].base + ((sim_timer_state[i].periods + 1) * Sim_Timer_Period(&sim_timer[i]));
+            next = (timeout < next) ? timeout : next;
+        }
+    }
+    
+    for (uint8_t i = 0; i < sim_pin_event_count; i++)
+    {
+        next = (sim_pin_events[i].time < next) ? sim_pin_events[i].time : next;
+    }
+    
+    if (sim_rx_fifo_count < SIM_RX_FIFO_SIZE)
+    {
+        next = (sim_rx_next_arrival < next) ? sim_rx_next_arrival : next;
+    }
+    
+    return next;
+}
+
+void Sim_Wait_For_Interrupt(void)
+{
+    // Interrupts cannot nest in the simulator, so a wait inside a handler only syncs
+    Sim_Sync();
+    if (sim_in_handler)
+    {
+        return;
+    }
+    
+    if (Sim_Idle_Task)
+    {
+        (*Sim_Idle_Task)();
+        Sim_Sync();
+    }
+    
+    if (!Sim_Interrupt_Pending())
+    {
+        uint64_t next = Sim_Next_Event();
+        
+        // With nothing scheduled, time still moves forward by one millisecond
+        uint64_t wake = (next != SIM_NO_EVENT) ? next : (sim_cycles + (SIM_SYSTEM_CLOCK_HZ / 1000));
+        
+        // SLEEPDEEP (Bit 2) in the SCR register selects deep sleep
+        if (sim_scb.SCR & 0x04)
+        {
+            sim_deep_sleep_cycles += wake - sim_cycles;
+        }
+        sim_cycles = wake;
+        Sim_Process_Events();
+        Sim_Sync();
+    }
+    
+    if (!sim_primask)
+    {
+        Sim_Dispatch();
+    }
+}
+
+void Sim_Enable_Interrupts(void)
+{
+    sim_primask = 0;
+    
+    if (!sim_in_handler)
+    {
+        Sim_Dispatch();
+    }
+}
+
+void Sim_Disable_Interrupts(void)
+{
+    sim_primask = 1;
+}
+
+uint32_t Sim_Get_PRIMASK(void)
+{
+    return sim_primask;
+}
+
+void Sim_Set_PRIMASK(uint32_t primask)
+{
+    if (primask)
+    {
+        Sim_Disable_Interrupts();
+    }
+    else
+    {
+        Sim_Enable_Interrupts();
+    }
+}
+
+void Sim_Init(void)
+{
+    memset(&sim_gpioa, 0, sizeof(sim_gpioa));
+    memset(&sim_gpiob, 0, sizeof(sim_gpiob));
+    memset(&sim_gpiof, 0, sizeof(sim_gpiof));
+    memset(&sim_uart0, 0, sizeof(sim_uart0));
+    memset(sim_timer, 0, sizeof(sim_timer));
+    memset(&sim_sysctl, 0, sizeof(sim_sysctl));
+    memset(&sim_udma, 0, sizeof(sim_udma));
+    memset(&sim_eeprom, 0, sizeof(sim_eeprom));
+    memset(&sim_adc0, 0, sizeof(sim_adc0));
+    memset(sim_eeprom_words, 0xFF, sizeof(sim_eeprom_words));
+    memset(&sim_nvic, 0, sizeof(sim_nvic));
+    memset(&sim_systick, 0, sizeof(sim_systick));
+    memset(&sim_scb, 0, sizeof(sim_scb));
+    memset(sim_timer_state, 0, sizeof(sim_timer_state));
+    
+    // Reset values (UART0 FIFO trigger levels at 1/2, LOCK reads as locked)
+    sim_uart0.IFLS = 0x12;
+    sim_uart0.FR = 0x90;
+    sim_gpioa.LOCK = 1;
+    sim_gpiob.LOCK = 1;
+    sim_gpiof.LOCK = 1;
+    sim_udma.CHIS = SIM_CHIS_TAG;
+    sim_sysctl.RCC = 0x078E3AD1;
+    sim_sysctl.RCC2 = 0x07C06810;
+    
+    sim_cycles = 0;
+    sim_primask = 1;
+    sim_nvic_enabled = 0;
+    sim_systick_running = 0;
+    sim_systick_pending = 0;
+    sim_portf_levels = 0xFF;
+    sim_portf_leds = 0;
+    sim_pin_event_count = 0;
+    sim_portb_levels = 0;
+    memset(&sim_gpioa_published, 0, sizeof(sim_gpioa_published));
+    memset(&sim_gpiob_published, 0, sizeof(sim_gpiob_published));
+    memset(&sim_gpiof_published, 0, sizeof(sim_gpiof_published));
+    sim_rx_queue_head = 0;
+    sim_rx_queue_tail = 0;
+    sim_rx_next_arrival = SIM_NO_EVENT;
+    sim_rx_fifo_count = 0;
+    sim_udma_enabled = 0;
+    sim_udma_chis = 0;
+    sim_eeprom_done = 0;
+    sim_interrupt_count = 0;
+    sim_deep_sleep_cycles = 0;
+}
+
+int Sim_EEPROM_Open(const char *path)
+{
+    // Loads an existing image (host byte order), or creates an erased one
+    sim_eeprom_file = fopen(path, "r+b");
+    if (sim_eeprom_file)
+    {
+        if (fread(sim_eeprom_words, 4, SIM_EEPROM_WORD_COUNT, sim_eeprom_file) != SIM_EEPROM_WORD_COUNT)
+        {
+            memset(sim_eeprom_words, 0xFF, sizeof(sim_eeprom_words));
+        }
+    }
+    else
+    {
+        sim_eeprom_file = fopen(path, "w+b");
+        if (!sim_eeprom_file)
+        {
+            return -1;
+        }
+    }
+    
+    fseek(sim_eeprom_file, 0, SEEK_SET);
+    fwrite(sim_eeprom_words, 4, SIM_EEPROM_WORD_COUNT, sim_eeprom_file);
+    fflush(sim_eeprom_file);
+    return 0;
+}
+
+uint64_t Sim_Get_Cycles(void)
+{
+    return sim_cycles;
+}
+
+uint64_t Sim_Get_Time_Us(void)
+{
+    return sim_cycles / SIM_CYCLES_PER_US;
+}
+
+void Sim_Schedule_Pin(uint8_t pin_mask, uint8_t level, uint64_t delay_us)
+{
+    if (sim_pin_event_count < SIM_MAX_PIN_EVENTS)
+    {
+        sim_pin_events[sim_pin_event_count].time = sim_cycles + (delay_us * SIM_CYCLES_PER_US);
+        sim_pin_events[sim_pin_event_count].pin_mask = pin_mask;
+        sim_pin_events[sim_pin_event_count].level = level;
+        sim_pin_event_count++;
+    }
+}
+
+void Sim_UART_Receive(const char *data)
+{
+    while (*data && ((sim_rx_queue_head - sim_rx_queue_tail) < SIM_RX_QUEUE_SIZE))
+    {
+        if (sim_rx_queue_head == sim_rx_queue_tail)
+        {
+            sim_rx_next_arrival = sim_cycles + SIM_UART_CHARACTER_CYCLES;
+        }
+        sim_rx_queue[sim_rx_queue_head % SIM_RX_QUEUE_SIZE] = *data;
+        sim_rx_queue_head++;
+        data++;
+    }
+}
+
+void Sim_UART_Receive_After(const char *data, uint64_t delay_us)
+{
+    uint8_t was_empty = (sim_rx_queue_head == sim_rx_queue_tail);
+    
+    Sim_UART_Receive(data);
+    if (was_empty && (sim_rx_queue_head != sim_rx_queue_tail))
+    {
+        sim_rx_next_arrival = sim_cycles + (delay_us * SIM_CYCLES_PER_US) + SIM_UART_CHARACTER_CYCLES;
+    }
+}
+
+uint32_t Sim_UART_Receive_Pending(void)
+{
+    return (sim_rx_queue_head - sim_rx_queue_tail) + sim_rx_fifo_count;
+}
+
+void Sim_Set_UART_Transmit_Task(void (*task)(char data))
+{
+    Sim_UART_Transmit_Task = task;
+}
+
+void Sim_Set_LED_Task(void (*task)(uint8_t leds))
+{
+    Sim_LED_Task = task;
+}
+
+void Sim_Set_Idle_Task(void (*task)(void))
+{
+    Sim_Idle_Task = task;
+}
+
+void Sim_Set_Random_Seed(uint32_t seed)
+{
+    sim_random_seed = seed;
+}
+
+uint32_t Sim_Get_Random_Seed(void)
+{
+    return sim_random_seed;
+}
+
+uint64_t Sim_Get_Interrupt_Count(void)
+{
+    return sim_interrupt_count;
+}
+
+uint64_t Sim_Get_Deep_Sleep_Cycles(void)
+{
+    return sim_deep_sleep_cycles;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file Sim.h
+ *
+ * @brief Header file for the host simulator.
+ *
+ * This file contains the function prototypes and definitions for the Linux host simulator,
+ * which runs the unmodified firmware against a virtual register file and a virtual clock.
+ *
+ * @note The virtual clock counts system clock cycles and only advances while the firmware
+ * sleeps in __WFI, jumping straight to the next event (SysTick reload, timer time-out,
+ * pin edge or UART character). Simulated time therefore runs as fast as the host allows.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include "System_Clock.h"
+
+// Virtual system clock, at the frequency the firmware configures the PLL for
+#define SIM_SYSTEM_CLOCK_HZ     SYSTEM_CLOCK_HZ
+#define SIM_CYCLES_PER_US       (SIM_SYSTEM_CLOCK_HZ / 1000000)
+
+// UART0 character time at the configured baud rate with 10 bits per character (about 87 us)
+#define SIM_UART_CHARACTER_CYCLES   ((SIM_SYSTEM_CLOCK_HZ * 10ULL) / UART0_BAUD_RATE)
+
+// EEPROM: 512 words, each write keeps the controller busy (EEDONE WORKING) for this long
+#define SIM_EEPROM_WORD_COUNT   512
+#define SIM_EEPROM_WRITE_US     500
+
+// Port F pins driven by the simulator (buttons are active low)
+#define SIM_PIN_SW1     0x10    // PF4
+#define SIM_PIN_SW2     0x01    // PF0
+#define SIM_PIN_LEVEL_PRESSED     0
+#define SIM_PIN_LEVEL_RELEASED    1
+
+// Function Prototypes
+void Sim_Init(void);
+uint64_t Sim_Get_Cycles(void);
+uint64_t Sim_Get_Time_Us(void);
+void Sim_Schedule_Pin(uint8_t pin_mask, uint8_t level, uint64_t delay_us);
+void Sim_UART_Receive(const char *data);
+void Sim_UART_Receive_After(const char *data, uint64_t delay_us);
+uint32_t Sim_UART_Receive_Pending(void);
+void Sim_Set_UART_Transmit_Task(void (*task)(char data));
+void Sim_Set_LED_Task(void (*task)(uint8_t leds));
+void Sim_Set_Idle_Task(void (*task)(void));
+uint64_t Sim_Get_Interrupt_Count(void);
+uint64_t Sim_Get_Deep_Sleep_Cycles(void);
+int Sim_EEPROM_Open(const char *path);
+void Sim_Set_Random_Seed(uint32_t seed);
+
+#endif
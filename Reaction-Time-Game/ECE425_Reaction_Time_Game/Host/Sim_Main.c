@@ -0,0 +1,537 @@
+/**
+ * @file Sim_Main.c
+ *
+ * @brief Command-line front end for the host simulator.
+ *
+ * This file runs the firmware's main function on the host simulator, either interactively
+ * with stdin/stdout as the UART0 terminal, or in batch mode where a scripted operator
+ * drives the menu and a simulated player presses SW1 after each stimulus. The player's
+ * contacts bounce on every press and release, and about one round in 25 it jumps the gun
+ * with a press during the foreperiod. In two-player mode a second simulated player with
+ * its own reaction times and false starts presses SW2. In choice mode the player answers
+ * red with SW1 and green with SW2, about 100 ms slower, picks the wrong button one time in
+ * 20 and presses for blue (no-go) one time in 10. In PVT mode its false starts come 0.5 to
+ * 1.5 s after a response, during the feedback or just after it, and with the rapid pacing
+ * they come half a second into the foreperiod. The operator can be made to wait before each
+ * menu choice, which leaves the firmware idle long enough to enter deep sleep,
+ * and can run the latency calibration over the modeled PB3 to PB2 loopback wire before
+ * the first game. After the last game the operator opens the results screen (with the
+ * session history) and the Diagnostics screen once each, then exits.
+ *
+ * @note Usage: sim [-g games] [-r rounds] [-s seed] [-w seconds] [-t file] [-e file] [-2 | -c | -v minutes]
+ *                  [-f] [-k] [-d] [-p] [-q]
+ *  - -g games   Batch mode: plays the given number of games, then exits from the menu
+ *  - -r rounds  Number of rounds per game in batch mode (default 5)
+ *  - -s seed    Seed for the simulated player's reaction times and for the firmware's
+ *               generator, so the run is reproducible (default: player seed 1, and the
+ *               firmware seeds itself from the simulated ADC noise as on the target)
+ *  - -w seconds Batch mode: the operator waits this long before each menu choice
+ *               (default 0)
+ *  - -t file    Batch mode: turns on telemetry mode and writes the raw UART0 stream to file
+ *               (decode it with telemetry_decode)
+ *  - -e file    Backs the EEPROM with file, so the session log and settings persist between
+ *               runs (default: an erased EEPROM every run)
+ *  - -2         Batch mode: plays in two-player mode
+ *  - -c         Batch mode: plays in choice mode (the batch mode default is simple mode)
+ *  - -v minutes Batch mode: plays PVT runs of the given length (sends the pvt command
+ *               before the first game)
+ *  - -f         Batch mode: plays with the rapid pacing (sends pace rapid before the first game)
+ *  - -k         Batch mode: sends the calibrate command before the first game
+ *  - -d         Batch mode: turns the live dashboard on before the first game
+ *  - -p         Enables the simulated player in interactive mode
+ *  - -q         Does not print UART0 output
+ *
+ * In interactive mode the virtual clock is paced to real time, and the '[' and ']' keys
+ * press SW1 and SW2 instead of being sent to the UART.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include "Sim.h"
+
+#define SIM_LED_RED                 0x02
+#define SIM_LED_BLUE                0x04
+#define SIM_LED_GREEN               0x08
+#define SIM_BUTTON_HOLD_US          90000
+#define SIM_EOF_SILENCE_US          10000000
+#define SIM_OUTPUT_HISTORY_SIZE     32
+
+// Game modes, in the firmware's menu order
+#define SIM_MODE_SIMPLE             0
+#define SIM_MODE_TWO_PLAYER         1
+#define SIM_MODE_CHOICE             2
+#define SIM_MODE_PVT                3
+
+// Firmware entry point (main.c is compiled with main renamed)
+int Firmware_Main(void);
+
+// Command-line options
+static uint32_t option_games = 0;
+static uint32_t option_rounds = 5;
+static uint32_t option_seed = 1;
+static uint8_t option_fixed_seed = 0;
+static uint64_t option_menu_wait_us = 0;
+static uint8_t option_player = 0;
+static uint8_t option_calibrate = 0;
+static uint8_t option_dashboard = 0;
+static uint32_t option_pvt_minutes = 0;
+static uint8_t option_rapid = 0;
+static uint8_t option_quiet = 0;
+static uint8_t option_mode = SIM_MODE_SIMPLE;
+static FILE *option_telemetry_file = NULL;
+static const char *option_eeprom_path = NULL;
+
+// Front-end state
+static char output_history[SIM_OUTPUT_HISTORY_SIZE + 1];
+static uint8_t rounds_configured = 0;
+static uint32_t games_started = 0;
+static uint32_t games_completed = 0;
+static uint8_t results_shown = 0;
+static uint8_t diagnostics_shown = 0;
+static uint8_t telemetry_enabled = 0;
+static uint8_t current_mode = SIM_MODE_SIMPLE;
+static char menu_results_choice[2] = "3";
+static char menu_diagnostics_choice[2] = "4";
+static char menu_telemetry_choice[2] = "5";
+static char menu_mode_choice[2] = "6";
+static char menu_exit_choice[2] = "7";
+static uint32_t stimuli = 0;
+static uint32_t false_starts = 0;
+static uint64_t last_output_us = 0;
+static uint8_t stdin_open = 1;
+static uint8_t stdin_is_terminal = 0;
+static struct termios saved_terminal;
+static struct timespec host_start;
+
+static uint32_t Player_Random(void)
+{
+    // xorshift32
+    option_seed ^= option_seed << 13;
+    option_seed ^= option_seed >> 17;
+    option_seed ^= option_seed << 5;
+    return option_seed;
+}
+
+// Presses and releases a button with contact bounce on both edges
+static void Player_Press(uint8_t pin_mask, uint64_t delay_us)
+{
+    static const uint32_t bounce_us[] = { 0, 300, 700, 1200, 1500 };
+    
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        Sim_Schedule_Pin(pin_mask, (i & 1) ? SIM_PIN_LEVEL_RELEASED : SIM_PIN_LEVEL_PRESSED,
+                         delay_us + bounce_us[i]);
+        Sim_Schedule_Pin(pin_mask, (i & 1) ? SIM_PIN_LEVEL_PRESSED : SIM_PIN_LEVEL_RELEASED,
+                         delay_us + SIM_BUTTON_HOLD_US + bounce_us[i]);
+    }
+}
+
+// Sum of uniforms around 250 ms with a long right tail
+static uint64_t Player_Reaction_Time(void)
+{
+    uint64_t reaction_us = 150000 + (Player_Random() % 60000) + (Player_Random() % 60000) +
+                           (Player_Random() % 60000);
+    
+    if ((Player_Random() % 50) == 0)
+    {
+        reaction_us += 400000;
+    }
+    
+    return reaction_us;
+}
+
+// Choice mode player: red is SW1, green is SW2 and blue is no press, with occasional errors
+static void Player_Choose(uint8_t leds)
+{
+    uint8_t pin = (leds == SIM_LED_RED) ? SIM_PIN_SW1 : SIM_PIN_SW2;
+    
+    if (leds == SIM_LED_BLUE)
+    {
+        if ((Player_Random() % 10) != 0)
+        {
+            return;
+        }
+        pin = (Player_Random() & 1) ? SIM_PIN_SW1 : SIM_PIN_SW2;
+    }
+    else if ((Player_Random() % 20) == 0)
+    {
+        pin = (pin == SIM_PIN_SW1) ? SIM_PIN_SW2 : SIM_PIN_SW1;
+    }
+    
+    Player_Press(pin, Player_Reaction_Time() + 100000);
+}
+
+// Simulated players: press SW1 (and SW2) a human-like reaction time after the stimulus LED
+// turns on
+static void Player_LED_Task(uint8_t leds)
+{
+    static const uint8_t pins[] = { SIM_PIN_SW1, SIM_PIN_SW2 };
+    static uint8_t previous_leds = 0;
+    uint8_t choice = (current_mode == SIM_MODE_CHOICE);
+    uint8_t players = (current_mode == SIM_MODE_TWO_PLAYER) ? 2 : 1;
+    
+    // Stimuli are a single LED turning on (only red outside choice mode). Feedback is green
+    // or blue, or in choice mode a mix of colors
+    uint8_t onset = (previous_leds == 0) &&
+                    ((leds == SIM_LED_RED) || (choice && ((leds == SIM_LED_GREEN) || (leds == SIM_LED_BLUE))));
+    uint8_t feedback_over = (leds == 0) &&
+                            (choice ? ((previous_leds & (previous_leds - 1)) != 0) :
+                                      ((previous_leds & (SIM_LED_BLUE | SIM_LED_GREEN)) && !(previous_leds & SIM_LED_RED)));
+    
+    for (uint8_t player = 0; player < players; player++)
+    {
+        // The feedback LED going off starts the 2 s intertrial and 6 s countdown, so a press
+        // 8.5 s later lands in the foreperiod (at least 1 s long). With the rapid pacing it
+        // starts the 0.5 s intertrial
+        if (feedback_over && (current_mode != SIM_MODE_PVT) && ((Player_Random() % 25) == 0))
+        {
+            Player_Press(pins[player], (option_rapid ? 1000000 : 8500000) + (player * 20000));
+            false_starts++;
+        }
+        
+        if (onset && !choice)
+        {
+            uint64_t reaction_us = Player_Reaction_Time();
+            Player_Press(pins[player], reaction_us);
+            
+            // The PVT feedback is the first second of the next interval, so a press 0.5 to
+            // 1.5 s after the response is a false start in it or just after it
+            if ((current_mode == SIM_MODE_PVT) && ((Player_Random() % 25) == 0))
+            {
+                Player_Press(pins[player], reaction_us + 500000 + (Player_Random() % 1000000));
+                false_starts++;
+            }
+        }
+    }
+    
+    if (onset)
+    {
+        if (choice)
+        {
+            Player_Choose(leds);
+        }
+        stimuli++;
+    }
+    
+    previous_leds = leds;
+}
+
+static uint8_t Output_Ends_With(const char *suffix)
+{
+    size_t history_length = strlen(output_history);
+    size_t suffix_length = strlen(suffix);
+    
+    return (history_length >= suffix_length) &&
+           (strcmp(&output_history[history_length - suffix_length], suffix) == 0);
+}
+
+// Scripted operator: answers the menu prompts in batch mode
+static void Operator_Respond(void)
+{
+    // Learns the menu numbering from the menu itself
+    size_t history_length = strlen(output_history);
+    if (Output_Ends_With(". View Previous Results"))
+    {
+        menu_results_choice[0] = output_history[history_length - 24];
+    }
+    else if (Output_Ends_With(". Diagnostics"))
+    {
+        menu_diagnostics_choice[0] = output_history[history_length - 14];
+    }
+    else if (Output_Ends_With(". Telemetry Mode"))
+    {
+        menu_telemetry_choice[0] = output_history[history_length - 17];
+    }
+    else if (Output_Ends_With(". Game Mode"))
+    {
+        menu_mode_choice[0] = output_history[history_length - 12];
+    }
+    else if (Output_Ends_With("(Current: Simple"))
+    {
+        current_mode = SIM_MODE_SIMPLE;
+    }
+    else if (Output_Ends_With("(Current: Two-Player"))
+    {
+        current_mode = SIM_MODE_TWO_PLAYER;
+    }
+    else if (Output_Ends_With("(Current: Choice"))
+    {
+        current_mode = SIM_MODE_CHOICE;
+    }
+    else if (Output_Ends_With("(Current: PVT"))
+    {
+        current_mode = SIM_MODE_PVT;
+    }
+    else if (Output_Ends_With(". Exit"))
+    {
+        menu_exit_choice[0] = output_history[history_length - 7];
+    }
+    
+    if (Output_Ends_With("Enter your choice: "))
+    {
+        const char *choice;
+        
+        // Every game returns to the menu, with or without a results screen first
+        games_completed = games_started;
+        
+        if (!rounds_configured)
+        {
+            choice = "1";
+        }
+        else if (option_telemetry_file && !telemetry_enabled)
+        {
+            telemetry_enabled = 1;
+            choice = menu_telemetry_choice;
+        }
+        else if ((current_mode != option_mode) && (option_mode != SIM_MODE_PVT))
+        {
+            // The setting may have been restored from the EEPROM, so it is stepped as needed
+            choice = menu_mode_choice;
+        }
+        else if (games_started < option_games)
+        {
+            // The calibration report and the dashboard, pace and pvt commands do not end with the
+            // menu, so the first game is started on the same line (pvt also selects PVT mode)
+            static char first_choice[48];
+            games_started++;
+            choice = "2";
+            if (games_started == 1)
+            {
+                char pvt_command[16] = "";
+                if (option_mode == SIM_MODE_PVT)
+                {
+                    snprintf(pvt_command, sizeof(pvt_command), "pvt %u\r", (unsigned)option_pvt_minutes);
+                    current_mode = SIM_MODE_PVT;
+                }
+                snprintf(first_choice, sizeof(first_choice), "%s%s%s%s2", option_calibrate ? "calibrate\r" : "",
+                         option_dashboard ? "dashboard on\r" : "", option_rapid ? "pace rapid\r" : "", pvt_command);
+                choice = first_choice;
+            }
+        }
+        else if (!results_shown)
+        {
+            results_shown = 1;
+            choice = menu_results_choice;
+        }
+        else if (!diagnostics_shown)
+        {
+            diagnostics_shown = 1;
+            choice = menu_diagnostics_choice;
+        }
+        else
+        {
+            choice = menu_exit_choice;
+        }
+        
+        Sim_UART_Receive_After(choice, option_menu_wait_us);
+    }
+    else if (Output_Ends_With("): "))
+    {
+        char line[16];
+        snprintf(line, sizeof(line), "%u\r", (unsigned)option_rounds);
+        Sim_UART_Receive(line);
+        rounds_configured = 1;
+    }
+    else if (Output_Ends_With("continue..."))
+    {
+        Sim_UART_Receive(" ");
+    }
+}
+
+static void Terminal_Transmit_Task(char data)
+{
+    if (option_telemetry_file)
+    {
+        fputc(data, option_telemetry_file);
+    }
+    else if (!option_quiet)
+    {
+        putchar(data);
+    }
+    
+    size_t length = strlen(output_history);
+    if (length == SIM_OUTPUT_HISTORY_SIZE)
+    {
+        memmove(output_history, &output_history[1], SIM_OUTPUT_HISTORY_SIZE - 1);
+        length--;
+    }
+    output_history[length] = data;
+    output_history[length + 1] = 0;
+    last_output_us = Sim_Get_Time_Us();
+    
+    if (option_games > 0)
+    {
+        Operator_Respond();
+    }
+}
+
+static uint64_t Host_Elapsed_Us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    return ((uint64_t)(now.tv_sec - host_start.tv_sec) * 1000000) + ((now.tv_nsec - host_start.tv_nsec) / 1000);
+}
+
+static void Print_Summary(void)
+{
+    double virtual_s = Sim_Get_Time_Us() / 1e6;
+    double host_s = Host_Elapsed_Us() / 1e6;
+    double deep_sleep_s = (double)Sim_Get_Deep_Sleep_Cycles() / SIM_SYSTEM_CLOCK_HZ;
+    
+    fflush(stdout);
+    fprintf(stderr, "sim: %u games, %u stimuli, %u false starts, %.1f s simulated in %.3f s (%.0fx real time), "
+            "%llu interrupts, %.1f%% in deep sleep\n", (unsigned)games_completed, (unsigned)stimuli,
+            (unsigned)false_starts, virtual_s, host_s, (host_s > 0) ? (virtual_s / host_s) : 0.0,
+            (unsigned long long)Sim_Get_Interrupt_Count(), (virtual_s > 0) ? ((100.0 * deep_sleep_s) / virtual_s) : 0.0);
+}
+
+static void Restore_Terminal(void)
+{
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved_terminal);
+}
+
+// Interactive mode: feeds stdin to UART0 and paces the virtual clock to real time
+static void Interactive_Idle_Task(void)
+{
+    if (stdin_is_terminal)
+    {
+        uint64_t virtual_us = Sim_Get_Time_Us();
+        uint64_t host_us = Host_Elapsed_Us();
+        
+        if (virtual_us > host_us)
+        {
+            uint64_t sleep_us = virtual_us - host_us;
+            struct timespec pause = { 0, (long)((sleep_us > 10000 ? 10000 : sleep_us) * 1000) };
+            nanosleep(&pause, NULL);
+        }
+    }
+    
+    struct pollfd input = { STDIN_FILENO, POLLIN, 0 };
+    while (stdin_open && (poll(&input, 1, 0) > 0))
+    {
+        char data;
+        if (read(STDIN_FILENO, &data, 1) != 1)
+        {
+            stdin_open = 0;
+            break;
+        }
+        
+        if (data == '[')
+        {
+            Sim_Schedule_Pin(SIM_PIN_SW1, SIM_PIN_LEVEL_PRESSED, 0);
+            Sim_Schedule_Pin(SIM_PIN_SW1, SIM_PIN_LEVEL_RELEASED, SIM_BUTTON_HOLD_US);
+        }
+        else if (data == ']')
+        {
+            Sim_Schedule_Pin(SIM_PIN_SW2, SIM_PIN_LEVEL_PRESSED, 0);
+            Sim_Schedule_Pin(SIM_PIN_SW2, SIM_PIN_LEVEL_RELEASED, SIM_BUTTON_HOLD_US);
+        }
+        else
+        {
+            char text[2] = { (data == '\n') ? '\r' : data, 0 };
+            Sim_UART_Receive(text);
+        }
+    }
+    
+    // Ends the run once input is exhausted and the firmware has gone quiet
+    if (!stdin_open && (Sim_UART_Receive_Pending() == 0) &&
+        ((Sim_Get_Time_Us() - last_output_us) > SIM_EOF_SILENCE_US))
+    {
+        Print_Summary();
+        exit(0);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int option;
+    
+    while ((option = getopt(argc, argv, "g:r:s:w:t:e:2cv:fkdpq")) != -1)
+    {
+        switch (option)
+        {
+            case 'g': option_games = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'r': option_rounds = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 's': option_seed = (uint32_t)strtoul(optarg, NULL, 10); option_fixed_seed = 1; break;
+            case 'w': option_menu_wait_us = (uint64_t)(strtod(optarg, NULL) * 1e6); break;
+            case 't':
+                option_telemetry_file = fopen(optarg, "wb");
+                if (!option_telemetry_file)
+                {
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+            case 'e': option_eeprom_path = optarg; break;
+            case '2': option_mode = SIM_MODE_TWO_PLAYER; break;
+            case 'c': option_mode = SIM_MODE_CHOICE; break;
+            case 'v': option_mode = SIM_MODE_PVT; option_pvt_minutes = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'f': option_rapid = 1; break;
+            case 'k': option_calibrate = 1; break;
+            case 'd': option_dashboard = 1; break;
+            case 'p': option_player = 1; break;
+            case 'q': option_quiet = 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-g games] [-r rounds] [-s seed] [-w seconds] [-t file] [-e file] [-2 | -c | -v minutes] [-f] [-k] [-d] [-p] [-q]\n", argv[0]);
+                return 2;
+        }
+    }
+    
+    if (option_seed == 0)
+    {
+        option_seed = 1;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &host_start);
+    Sim_Init();
+    if (option_eeprom_path && (Sim_EEPROM_Open(option_eeprom_path) != 0))
+    {
+        perror(option_eeprom_path);
+        return 1;
+    }
+    Sim_Set_UART_Transmit_Task(&Terminal_Transmit_Task);
+    if (option_fixed_seed)
+    {
+        Sim_Set_Random_Seed(option_seed);
+    }
+    
+    if ((option_games > 0) || option_player)
+    {
+        Sim_Set_LED_Task(&Player_LED_Task);
+    }
+    
+    if (option_games == 0)
+    {
+        stdin_is_terminal = isatty(STDIN_FILENO);
+        if (stdin_is_terminal)
+        {
+            // Raw input so single key presses reach the firmware immediately
+            struct termios raw;
+            tcgetattr(STDIN_FILENO, &saved_terminal);
+            raw = saved_terminal;
+            raw.c_lflag &= ~(ICANON | ECHO);
+            tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+            atexit(&Restore_Terminal);
+        }
+        Sim_Set_Idle_Task(&Interactive_Idle_Task);
+    }
+    
+    int result = Firmware_Main();
+    
+    if (option_telemetry_file)
+    {
+        fclose(option_telemetry_file);
+    }
+    Print_Summary();
+    return result;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file TM4C123GH6PM.h
+ *
+ * @brief Host simulator backend of the hardware abstraction layer.
+ *
+ * This file replaces the vendor device header when the firmware is built for the Linux
+ * host simulator (the Host directory comes first on the include path). It declares the
+ * same register structures and peripheral names as the vendor header, but maps every
+ * peripheral onto a virtual register file in Sim.c.
+ *
+ * @note Every peripheral access first calls Sim_Sync, which applies the side effects of
+ * the previous accesses (write-1-to-clear registers, channel enables, pin levels) and
+ * refreshes time-dependent registers (SysTick VAL, timer values) from the virtual clock.
+ * The virtual clock only advances when the firmware sleeps (__WFI), so interrupt handlers
+ * only run at the points where the firmware would wait for them on the target.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#ifndef HOST_TM4C123GH6PM_H
+#define HOST_TM4C123GH6PM_H
+
+#include <stdint.h>
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+
+// GPIO Port registers
+typedef struct
+{
+    __IO uint32_t DATA_BITS[255];
+    __IO uint32_t DATA, DIR, IS, IBE, IEV, IM, RIS, MIS;
+    __O  uint32_t ICR;
+    __IO uint32_t AFSEL;
+    uint32_t      RESERVED1[55];
+    __IO uint32_t DR2R, DR4R, DR8R, ODR, PUR, PDR, SLR, DEN, LOCK, CR, AMSEL, PCTL, ADCCTL, DMACTL;
+} GPIOA_Type;
+
+// UART registers
+typedef struct
+{
+    __IO uint32_t DR, RSR, RESERVED0[4], FR, RESERVED1, ILPR, IBRD, FBRD, LCRH, CTL, IFLS, IM, RIS, MIS;
+    __O  uint32_t ICR;
+    __IO uint32_t DMACTL, CC;
+} UART0_Type;
+
+// General-Purpose Timer registers
+typedef struct
+{
+    __IO uint32_t CFG, TAMR, TBMR, CTL, SYNC, RESERVED0, IMR, RIS, MIS;
+    __O  uint32_t ICR;
+    __IO uint32_t TAILR, TBILR, TAMATCHR, TBMATCHR, TAPR, TBPR, TAPMR, TBPMR, TAR, TBR, TAV, TBV,
+                  RTCPD, TAPS, TBPS, TAPV, TBPV, PP;
+} TIMER0_Type;
+
+// System Control registers
+typedef struct
+{
+    __IO uint32_t DID0, DID1, PBORCTL, RIS, IMC, MISC, RESC, RCC, GPIOHBCTL, RCC2, MOSCCTL,
+                  DSLPCLKCFG, SYSPROP, PIOSCCAL, PIOSCSTAT, PLLFREQ0, PLLFREQ1, PLLSTAT,
+                  SLPPWRCFG, DSLPPWRCFG, LDOSPCTL, LDODPCTL;
+    __IO uint32_t RCGCWD, RCGCTIMER, RCGCGPIO, RCGCDMA, RCGCHIB, RCGCUART, RCGCSSI, RCGCI2C,
+                  RCGCUSB, RCGCCAN, RCGCADC, RCGCACMP, RCGCPWM, RCGCQEI, RCGCEEPROM, RCGCWTIMER;
+    __IO uint32_t SCGCTIMER, SCGCGPIO, SCGCDMA, SCGCUART, DCGCTIMER, DCGCGPIO, DCGCDMA, DCGCUART;
+    __IO uint32_t PRWD, PRTIMER, PRGPIO, PRDMA, PRHIB, PRUART, PREEPROM, PRWTIMER, PRADC;
+} SYSCTL_Type;
+
+// ADC registers (sample sequencer 3 only)
+typedef struct
+{
+    __IO uint32_t ACTSS, RIS, IM, ISC, OSTAT, EMUX, USTAT, TSSEL, SSPRI, SPC, PSSI, SAC, DCISC, CTL;
+    __IO uint32_t SSMUX3, SSCTL3, SSFIFO3, SSFSTAT3, PC, CC;
+} ADC0_Type;
+
+// EEPROM registers
+typedef struct
+{
+    __IO uint32_t EESIZE, EEBLOCK, EEOFFSET;
+         uint32_t RESERVED0;
+    __IO uint32_t EERDWR, EERDWRINC, EEDONE, EESUPP, EEUNLOCK;
+} EEPROM_Type;
+
+// Micro Direct Memory Access registers
+typedef struct
+{
+    __IO uint32_t STAT;
+    __O  uint32_t CFG;
+    __IO uintptr_t CTLBASE;    // Wide enough to hold a host pointer
+    __IO uint32_t ALTBASE, WAITSTAT;
+    __O  uint32_t SWREQ;
+    __IO uint32_t USEBURSTSET;
+    __O  uint32_t USEBURSTCLR;
+    __IO uint32_t REQMASKSET;
+    __O  uint32_t REQMASKCLR;
+    __IO uint32_t ENASET;
+    __O  uint32_t ENACLR;
+    __IO uint32_t ALTSET;
+    __O  uint32_t ALTCLR;
+    __IO uint32_t PRIOSET;
+    __O  uint32_t PRIOCLR;
+    __IO uint32_t ERRCLR, CHASGN, CHIS, CHMAP0, CHMAP1, CHMAP2, CHMAP3;
+} UDMA_Type;
+
+// Nested Vectored Interrupt Controller registers
+typedef struct
+{
+    __IO uint32_t ISER[8];
+    __IO uint32_t ICER[8];
+    __IO uint32_t ISPR[8];
+    __IO uint32_t ICPR[8];
+    __IO uint32_t IABR[8];
+    __IO uint8_t  IP[240];
+} NVIC_Type;
+
+// System Timer registers
+typedef struct
+{
+    __IO uint32_t CTRL, LOAD, VAL;
+    __I  uint32_t CALIB;
+} SysTick_Type;
+
+// System Control Block registers
+typedef struct
+{
+    __I  uint32_t CPUID;
+    __IO uint32_t ICSR, VTOR, AIRCR, SCR, CCR;
+} SCB_Type;
+
+// Data Watchpoint and Trace registers
+typedef struct
+{
+    __IO uint32_t CTRL, CYCCNT, CPICNT, EXCCNT, SLEEPCNT, LSUCNT, FOLDCNT;
+    __I  uint32_t PCSR;
+} DWT_Type;
+
+// Core Debug registers
+typedef struct
+{
+    __IO uint32_t DHCSR;
+    __O  uint32_t DCRSR;
+    __IO uint32_t DCRDR, DEMCR;
+} CoreDebug_Type;
+
+// Virtual register file (Sim.c)
+extern GPIOA_Type sim_gpioa;
+extern GPIOA_Type sim_gpiob;
+extern GPIOA_Type sim_gpiof;
+extern UART0_Type sim_uart0;
+extern TIMER0_Type sim_timer[4];
+extern SYSCTL_Type sim_sysctl;
+extern UDMA_Type sim_udma;
+extern EEPROM_Type sim_eeprom;
+extern ADC0_Type sim_adc0;
+extern NVIC_Type sim_nvic;
+extern SysTick_Type sim_systick;
+extern SCB_Type sim_scb;
+extern DWT_Type sim_dwt;
+extern CoreDebug_Type sim_coredebug;
+
+void Sim_Sync(void);
+void Sim_Sync_DWT(void);
+uint32_t Sim_UART0_Read_Data(void);
+void Sim_UART0_Write_Data(uint32_t data);
+uint32_t Sim_EEPROM_Read_Data(void);
+void Sim_EEPROM_Write_Data(uint32_t data);
+uint32_t Sim_Get_Random_Seed(void);
+void Sim_Wait_For_Interrupt(void);
+void Sim_Enable_Interrupts(void);
+void Sim_Disable_Interrupts(void);
+uint32_t Sim_Get_PRIMASK(void);
+void Sim_Set_PRIMASK(uint32_t primask);
+
+// Peripheral names, each access synchronizes the virtual register file first
+#define GPIOA      (Sim_Sync(), &sim_gpioa)
+#define GPIOB      (Sim_Sync(), &sim_gpiob)
+#define GPIOF      (Sim_Sync(), &sim_gpiof)
+#define UART0      (Sim_Sync(), &sim_uart0)
+#define TIMER0     (Sim_Sync(), &sim_timer[0])
+#define TIMER1     (Sim_Sync(), &sim_timer[1])
+#define TIMER2     (Sim_Sync(), &sim_timer[2])
+#define TIMER3     (Sim_Sync(), &sim_timer[3])
+#define SYSCTL     (Sim_Sync(), &sim_sysctl)
+#define UDMA       (Sim_Sync(), &sim_udma)
+#define EEPROM     (Sim_Sync(), &sim_eeprom)
+#define ADC0       (Sim_Sync(), &sim_adc0)
+#define NVIC       (Sim_Sync(), &sim_nvic)
+#define SysTick    (Sim_Sync(), &sim_systick)
+#define SCB        (Sim_Sync(), &sim_scb)
+
+// The cycle counter only synchronizes itself, so a probe does not time the whole register file
+#define DWT        (Sim_Sync_DWT(), &sim_dwt)
+#define CoreDebug  (&sim_coredebug)
+
+// Data register accessors with FIFO side effects (see HAL.h)
+#define HAL_UART0_Read_Data()          Sim_UART0_Read_Data()
+#define HAL_UART0_Write_Data(data)     Sim_UART0_Write_Data(data)
+#define HAL_EEPROM_Read_Data()         Sim_EEPROM_Read_Data()
+#define HAL_EEPROM_Write_Data(data)    Sim_EEPROM_Write_Data(data)
+#define HAL_RANDOM_SEED()              Sim_Get_Random_Seed()
+
+// CMSIS core intrinsics
+#define __WFI()                 Sim_Wait_For_Interrupt()
+#define __WFE()                 Sim_Wait_For_Interrupt()
+#define __enable_irq()          Sim_Enable_Interrupts()
+#define __disable_irq()         Sim_Disable_Interrupts()
+#define __get_PRIMASK()         Sim_Get_PRIMASK()
+#define __set_PRIMASK(primask)  Sim_Set_PRIMASK(primask)
+#define __DSB()
+#define __ISB()
+#define __NOP()
+#define __CLZ(value)            ((uint8_t)(((value) == 0) ? 32 : __builtin_clz(value)))
+
+#endif
@@ -0,0 +1,284 @@
+/**
+ * @file Telemetry_Decode.c
+ *
+ * @brief Linux decoder for the binary telemetry stream.
+ *
+ * This file reads a raw UART0 capture (a serial port log or the output of sim -t), finds the
+ * telemetry frames described in Telemetry.h and prints the records as CSV or JSON Lines.
+ *
+ * @note Usage: telemetry_decode [-j] [file]
+ *  - -j     Prints one JSON object per record (session headers, rounds and session ends)
+ *           instead of one CSV row per round
+ *  - file   Capture to decode (default: stdin)
+ *
+ * Text on the same link (menus, prompts) is skipped: every frame is delimited by 0x00 on both
+ * sides, and a chunk between delimiters only counts as a record if it COBS-decodes to a known
+ * record type of the right length with a matching CRC16. A summary with the number of records,
+ * CRC errors and dropped frames (gaps in the sequence numbers) is printed to stderr.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "../Telemetry.h"
+
+#define DECODE_MAX_CHUNK_SIZE   256
+
+// Record length (type, sequence, payload and CRC16) of each record type
+#define DECODE_SESSION_HEADER_SIZE  14
+#define DECODE_ROUND_SIZE           20
+#define DECODE_SESSION_END_SIZE     8
+
+static const char *const result_names[] = { "valid", "no_response", "anticipated", "false_start", "wrong_button",
+                                             "no_go_press", "withheld" };
+static const char *const mode_names[] = { "simple", "two_player", "choice", "pvt" };
+static const char *const stimulus_names[] = { "red", "green", "blue" };
+
+// Decoder state
+static uint8_t option_json = 0;
+static uint32_t session_count = 0;
+static uint32_t record_count = 0;
+static uint32_t crc_errors = 0;
+static uint32_t dropped_frames = 0;
+static uint32_t text_bytes = 0;
+static uint8_t sequence_valid = 0;
+static uint16_t expected_sequence = 0;
+static const char *session_mode = "unknown";
+
+uint16_t Telemetry_CRC16(const uint8_t *data, uint16_t length)
+{
+    // Same CRC-16/CCITT-FALSE as the firmware
+    uint16_t crc = 0xFFFF;
+    
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    
+    return crc;
+}
+
+static uint16_t Get_U16(const uint8_t *data)
+{
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static uint32_t Get_U32(const uint8_t *data)
+{
+    return Get_U16(data) | ((uint32_t)Get_U16(&data[2]) << 16);
+}
+
+// Returns the decoded length, or -1 if the chunk is not valid COBS
+static int COBS_Decode(const uint8_t *chunk, int length, uint8_t *record)
+{
+    int record_length = 0;
+    int i = 0;
+    
+    while (i < length)
+    {
+        uint8_t code = chunk[i++];
+        if ((code == 0) || ((i + code - 1) > length))
+        {
+            return -1;
+        }
+        
+        for (uint8_t j = 1; j < code; j++)
+        {
+            record[record_length++] = chunk[i++];
+        }
+        
+        // A code below 0xFF stands for a zero, except at the end of the frame
+        if ((code < 0xFF) && (i < length))
+        {
+            record[record_length++] = 0;
+        }
+    }
+    
+    return record_length;
+}
+
+static uint8_t Is_Text(const uint8_t *chunk, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        if (((chunk[i] < 0x20) || (chunk[i] > 0x7E)) && (chunk[i] != '\r') && (chunk[i] != '\n') &&
+            (chunk[i] != 0x1B) && (chunk[i] != '\b'))
+        {
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+static void Print_Record(const uint8_t *record)
+{
+    uint16_t sequence = Get_U16(&record[1]);
+    const uint8_t *payload = &record[3];
+    
+    switch (record[0])
+    {
+        case TELEMETRY_SESSION_HEADER:
+            session_count++;
+            session_mode = (payload[3] < 4) ? mode_names[payload[3]] : "unknown";
+            if (option_json)
+            {
+                printf("{\"type\":\"session\",\"sequence\":%u,\"session\":%u,\"version\":%u,\"rounds\":%u,"
+                       "\"mode\":\"%s\",\"players\":%u,\"start_us\":%u}\n", sequence, session_count, payload[0],
+                       Get_U16(&payload[1]), session_mode, payload[4], Get_U32(&payload[5]));
+            }
+            break;
+            
+        case TELEMETRY_ROUND:
+        {
+            uint8_t stimulus = payload[3];
+            uint8_t result = payload[4];
+            const char *stimulus_name = (stimulus < 3) ? stimulus_names[stimulus] : "unknown";
+            const char *result_name = (result < 7) ? result_names[result] : "unknown";
+            
+            if (option_json)
+            {
+                printf("{\"type\":\"round\",\"sequence\":%u,\"session\":%u,\"round\":%u,\"player\":%u,"
+                       "\"stimulus\":\"%s\",\"result\":\"%s\",\"foreperiod_ms\":%u,\"onset_us\":%u,\"reaction_us\":%u}\n",
+                       sequence, session_count, Get_U16(&payload[0]) + 1, payload[2] + 1, stimulus_name, result_name,
+                       Get_U16(&payload[5]), Get_U32(&payload[7]), Get_U32(&payload[11]));
+            }
+            else
+            {
+                printf("%u,%s,%u,%u,%u,%s,%s,%u,%u,%u\n", session_count, session_mode, sequence, Get_U16(&payload[0]) + 1,
+                       payload[2] + 1, stimulus_name, result_name, Get_U16(&payload[5]), Get_U32(&payload[7]),
+                       Get_U32(&payload[11]));
+            }
+            break;
+        }
+            
+        case TELEMETRY_SESSION_END:
+            if (option_json)
+            {
+                printf("{\"type\":\"session_end\",\"sequence\":%u,\"session\":%u,\"rounds_completed\":%u,"
+                       "\"aborted\":%s}\n", sequence, session_count, Get_U16(&payload[0]), payload[2] ? "true" : "false");
+            }
+            break;
+    }
+}
+
+static void Decode_Chunk(const uint8_t *chunk, int length)
+{
+    uint8_t record[DECODE_MAX_CHUNK_SIZE];
+    int record_length = COBS_Decode(chunk, length, record);
+    int expected_length = 0;
+    
+    if (record_length > 0)
+    {
+        expected_length = (record[0] == TELEMETRY_SESSION_HEADER) ? DECODE_SESSION_HEADER_SIZE :
+                          (record[0] == TELEMETRY_ROUND) ? DECODE_ROUND_SIZE :
+                          (record[0] == TELEMETRY_SESSION_END) ? DECODE_SESSION_END_SIZE : -1;
+    }
+    
+    if ((record_length != expected_length) ||
+        (Telemetry_CRC16(record, record_length - 2) != Get_U16(&record[record_length - 2])))
+    {
+        if (Is_Text(chunk, length))
+        {
+            text_bytes += length;
+        }
+        else
+        {
+            crc_errors++;
+        }
+        return;
+    }
+    
+    // A gap in the sequence numbers means frames were lost on the link
+    uint16_t sequence = Get_U16(&record[1]);
+    if (sequence_valid && (sequence != expected_sequence))
+    {
+        dropped_frames += (uint16_t)(sequence - expected_sequence);
+    }
+    sequence_valid = 1;
+    expected_sequence = sequence + 1;
+    
+    record_count++;
+    Print_Record(record);
+}
+
+int main(int argc, char *argv[])
+{
+    int option;
+    
+    while ((option = getopt(argc, argv, "j")) != -1)
+    {
+        switch (option)
+        {
+            case 'j': option_json = 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-j] [file]\n", argv[0]);
+                return 2;
+        }
+    }
+    
+    FILE *input = stdin;
+    if (optind < argc)
+    {
+        input = fopen(argv[optind], "rb");
+        if (!input)
+        {
+            perror(argv[optind]);
+            return 1;
+        }
+    }
+    
+    if (!option_json)
+    {
+        printf("session,mode,sequence,round,player,stimulus,result,foreperiod_ms,onset_us,reaction_us\n");
+    }
+    
+    // Splits the stream on the 0x00 delimiters
+    uint8_t chunk[DECODE_MAX_CHUNK_SIZE];
+    int length = 0;
+    uint8_t overflow = 0;
+    int data;
+    
+    while ((data = fgetc(input)) != EOF)
+    {
+        if (data != 0)
+        {
+            if (length < DECODE_MAX_CHUNK_SIZE)
+            {
+                chunk[length++] = (uint8_t)data;
+            }
+            else
+            {
+                overflow = 1;
+                text_bytes++;
+            }
+            continue;
+        }
+        
+        // Chunks longer than any frame are text
+        if (overflow)
+        {
+            text_bytes += length;
+        }
+        else if (length > 0)
+        {
+            Decode_Chunk(chunk, length);
+        }
+        length = 0;
+        overflow = 0;
+    }
+    
+    fprintf(stderr, "telemetry_decode: %u records in %u sessions, %u CRC errors, %u dropped frames, "
+            "%u text bytes skipped\n", record_count, session_count, crc_errors, dropped_frames, text_bytes);
+    
+    return (crc_errors || dropped_frames) ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file Power.c
+ *
+ * @brief Source code for the low-power idle driver.
+ *
+ * This file contains the function definitions for the low-power idle driver.
+ *
+ * Deep-Sleep Configuration:
+ *  - Clock: PIOSC, undivided (DSOSCSRC = 0x1 in DSLPCLKCFG), so the PLL and the main
+ *    oscillator are powered down
+ *  - Peripheral clocks: UART0 and Port A only (DCGCUART R0, DCGCGPIO R0), applied by
+ *    setting the ACG bit (Bit 27) in RCC for the length of the deep sleep
+ *  - Flash in low power mode (FLASHPM = 0x2) and SRAM in standby (SRAMPM = 0x1) in
+ *    DSLPPWRCFG, both retaining their contents
+ *  - SysTick switched to PIOSC / 4, since the system clock it normally counts is stopped,
+ *    and made tickless: it interrupts once, at the wake-up time (see SysTick_Delay.c)
+ *
+ * @note The capture timers are not clocked in deep sleep. Deep sleep is only entered from
+ * the menu, where no round is being timed.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Power.h"
+#include "SysTick_Delay.h"
+#include "HAL.h"
+
+// System Control Bit Masks
+#define POWER_SLEEPDEEP_BIT_MASK    0x04          // Deep sleep on WFI (SCB SCR Bit 2)
+#define POWER_ACG_BIT_MASK          0x08000000    // Auto clock gating (RCC Bit 27)
+#define POWER_DSOSCSRC_PIOSC        0x10          // Deep-sleep clock source (DSLPCLKCFG Bits 6 to 4)
+#define POWER_FLASHPM_LOW_POWER     0x20          // Flash power mode (DSLPPWRCFG Bits 5 to 4)
+#define POWER_SRAMPM_STANDBY        0x01          // SRAM power mode (DSLPPWRCFG Bits 1 to 0)
+
+static uint64_t power_start_ms = 0;
+static uint64_t power_active_cycles = 0;
+static uint64_t power_deep_sleep_ms = 0;
+static uint32_t power_sleep_count = 0;
+static uint32_t power_deep_sleep_count = 0;
+static uint32_t power_wake_cycles = 0;
+
+void Power_Init(void)
+{
+    // Enables the DWT cycle counter (also done by the profiler when it is compiled in)
+    CoreDebug->DEMCR |= 0x01000000;
+    DWT->CTRL |= 0x01;
+    
+    // Runs from the PIOSC in deep sleep by writing 0x1 to the DSOSCSRC field (Bits 6 to 4)
+    // and 0 to the DSDIVORIDE field (Bits 28 to 23) in the DSLPCLKCFG register
+    SYSCTL->DSLPCLKCFG = POWER_DSOSCSRC_PIOSC;
+    
+    // Puts the flash and SRAM in their low power modes during deep sleep
+    SYSCTL->DSLPPWRCFG = POWER_FLASHPM_LOW_POWER | POWER_SRAMPM_STANDBY;
+    
+    // Keeps only UART0 and its Port A pins clocked in deep sleep by setting the R0 bit (Bit 0)
+    // in the DCGCUART and DCGCGPIO registers
+    SYSCTL->DCGCTIMER = 0;
+    SYSCTL->DCGCDMA = 0;
+    SYSCTL->DCGCUART = 0x01;
+    SYSCTL->DCGCGPIO = 0x01;
+    
+    power_start_ms = SysTick_Get_Time_Ms64();
+    power_wake_cycles = DWT->CYCCNT;
+}
+
+void Power_Sleep(void)
+{
+    // The 32-bit difference is exact as long as the core stays awake for less than a
+    // CYCCNT period (53 s at 80 MHz), which SysTick guarantees
+    power_active_cycles += DWT->CYCCNT - power_wake_cycles;
+    
+    __WFI();
+    
+    power_wake_cycles = DWT->CYCCNT;
+    power_sleep_count++;
+}
+
+void Power_Deep_Sleep(uint8_t (*wake_condition)(void), uint64_t wake_time_ms)
+{
+    uint64_t start_ms = SysTick_Get_Time_Ms64();
+    if (wake_time_ms <= start_ms)
+    {
+        return;
+    }
+    
+    // Gates the peripheral clocks with the DCGC registers by setting the ACG bit (Bit 27)
+    // in the RCC register, and has SysTick interrupt once, at the wake-up time, from the PIOSC
+    SYSCTL->RCC |= POWER_ACG_BIT_MASK;
+    uint64_t sleep_ms = wake_time_ms - start_ms;
+    SysTick_Start_Tickless((sleep_ms < SYSTICK_TICKLESS_MAX_MS) ? (uint32_t)sleep_ms : SYSTICK_TICKLESS_MAX_MS);
+    
+    // Makes WFI enter deep sleep by setting the SLEEPDEEP bit (Bit 2) in the SCR register
+    SCB->SCR |= POWER_SLEEPDEEP_BIT_MASK;
+    
+    // The clock only moves when the tickless period ends, so other wake-ups return
+    // straight to deep sleep until the condition holds or the period is over
+    while (!(*wake_condition)() && (SysTick_Get_Time_Ms64() == start_ms))
+    {
+        Power_Sleep();
+    }
+    
+    // Restores the run-mode sleep, SysTick ticks and clock gating
+    SCB->SCR &= ~POWER_SLEEPDEEP_BIT_MASK;
+    SysTick_Stop_Tickless();
+    SYSCTL->RCC &= ~POWER_ACG_BIT_MASK;
+    
+    power_deep_sleep_ms += SysTick_Get_Time_Ms64() - start_ms;
+    power_deep_sleep_count++;
+}
+
+void Power_Get_Stats(Power_Stats *stats)
+{
+    stats->elapsed_ms = SysTick_Get_Time_Ms64() - power_start_ms;
+    stats->active_cycles = power_active_cycles + (DWT->CYCCNT - power_wake_cycles);
+    stats->deep_sleep_ms = power_deep_sleep_ms;
+    stats->sleep_count = power_sleep_count;
+    stats->deep_sleep_count = power_deep_sleep_count;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file Power.h
+ *
+ * @brief Header file for the low-power idle driver.
+ *
+ * This file contains the function prototypes and definitions for the low-power idle
+ * driver. Every wait loop in the firmware sleeps with Power_Sleep instead of spinning, and
+ * the main loop enters deep sleep with Power_Deep_Sleep once the menu has been idle for
+ * POWER_DEEP_SLEEP_TIMEOUT_MS. A deep sleep lasts until the wake condition holds or the
+ * wake-up time (the next timer deadline) arrives, and at most SYSTICK_TICKLESS_MAX_MS, after
+ * which the main loop runs once and sleeps again.
+ *
+ * Wake-up Latency:
+ *  - Sleep: the next interrupt, at most 1 ms away since SysTick runs in every state
+ *  - Deep sleep: UART0 is clocked from the PIOSC, so it keeps receiving, and its receive
+ *    time-out interrupt wakes the core 32 bit periods after a character (about 0.3 ms) plus
+ *    the PLL relock time. SysTick runs from the PIOSC as well, but only interrupts at the
+ *    wake-up time, so the core is not woken every millisecond
+ *
+ * The active time is counted with the DWT cycle counter between each wake-up and the next
+ * sleep, so the ratio of active to elapsed time can be read from the Diagnostics screen.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Menu idle time before the main loop enters deep sleep
+#define POWER_DEEP_SLEEP_TIMEOUT_MS    30000
+
+// Time spent in each power state since Power_Init
+typedef struct
+{
+    uint64_t elapsed_ms;
+    uint64_t active_cycles;        // Core clock cycles awake, less the handlers that woke it
+    uint64_t deep_sleep_ms;
+    uint32_t sleep_count;          // Wake-ups from sleep and deep sleep
+    uint32_t deep_sleep_count;     // Deep sleep periods
+} Power_Stats;
+
+// Function Prototypes
+void Power_Init(void);
+void Power_Sleep(void);
+void Power_Deep_Sleep(uint8_t (*wake_condition)(void), uint64_t wake_time_ms);
+void Power_Get_Stats(Power_Stats *stats);
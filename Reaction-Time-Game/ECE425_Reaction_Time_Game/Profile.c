@@ -0,0 +1,107 @@
+/**
+ * @file Profile.c
+ *
+ * @brief Source code for the DWT cycle-counter profiler.
+ *
+ * This file contains the function definitions for the profiler.
+ *
+ * @note Each probe is recorded from a single context (one interrupt handler or the main
+ * loop), so a probe's statistics are never updated concurrently.
+ *
+ * DWT Configuration:
+ *  - TRCENA (Bit 24) set in CoreDebug DEMCR to power the DWT unit
+ *  - CYCCNTENA (Bit 0) set in DWT CTRL to start the free-running cycle counter
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Profile.h"
+
+#if PROFILE_ENABLED
+static Profile_Stats profile_stats[PROFILE_PROBE_COUNT];
+#endif
+
+static const char *const profile_names[PROFILE_PROBE_COUNT] =
+{
+    "SysTick_Handler",
+    "Timer2A_Handler",
+    "Timer0A_Handler",
+    "Timer1A_Handler",
+    "UART0_Handler",
+    "UART0_Output_Character",
+    "UART0_Output_String",
+    "UART0_Write_DMA",
+    "Stimulus onset",
+    "Phase: LED test",
+    "Phase: Countdown",
+    "Phase: Foreperiod",
+    "Phase: Stimulus",
+    "Phase: Feedback",
+    "Phase: Intertrial",
+    "Phase: Response",
+    "Report_Printf"
+};
+
+void Profile_Init(void)
+{
+#if PROFILE_ENABLED
+    // Enables the DWT unit, then resets and starts the cycle counter
+    CoreDebug->DEMCR |= 0x01000000;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= 0x01;
+    
+    Profile_Reset();
+#endif
+}
+
+void Profile_Record(uint8_t probe, uint32_t cycles)
+{
+#if PROFILE_ENABLED
+    Profile_Stats *stats = &profile_stats[probe];
+    
+    if ((stats->count == 0) || (cycles < stats->min_cycles))
+    {
+        stats->min_cycles = cycles;
+    }
+    if (cycles > stats->max_cycles)
+    {
+        stats->max_cycles = cycles;
+    }
+    stats->total_cycles += cycles;
+    stats->count++;
+#else
+    (void)probe;
+    (void)cycles;
+#endif
+}
+
+void Profile_Get_Stats(uint8_t probe, Profile_Stats *stats)
+{
+#if PROFILE_ENABLED
+    *stats = profile_stats[probe];
+#else
+    (void)probe;
+    stats->count = 0;
+    stats->min_cycles = 0;
+    stats->max_cycles = 0;
+    stats->total_cycles = 0;
+#endif
+}
+
+const char *Profile_Get_Name(uint8_t probe)
+{
+    return profile_names[probe];
+}
+
+void Profile_Reset(void)
+{
+#if PROFILE_ENABLED
+    for (uint8_t i = 0; i < PROFILE_PROBE_COUNT; i++)
+    {
+        profile_stats[i].count = 0;
+        profile_stats[i].min_cycles = 0;
+        profile_stats[i].max_cycles = 0;
+        profile_stats[i].total_cycles = 0;
+    }
+#endif
+}
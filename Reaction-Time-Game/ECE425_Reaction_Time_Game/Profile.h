@@ -0,0 +1,65 @@
+/**
+ * @file Profile.h
+ *
+ * @brief Header file for the DWT cycle-counter profiler.
+ *
+ * This file contains the probe definitions and function prototypes for the profiler.
+ * Each probe keeps the count and the minimum, maximum and total number of core clock
+ * cycles measured with the Cortex-M4 DWT cycle counter (CYCCNT).
+ *
+ * @note Set PROFILE_ENABLED to 0 in the build to compile every probe out. The
+ * PROFILE_START and PROFILE_STOP macros then expand to nothing.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+#include "HAL.h"
+
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 1
+#endif
+
+// Probe identifiers
+#define PROFILE_SYSTICK_HANDLER       0
+#define PROFILE_TIMER_2A_HANDLER      1    // SW1 capture (replaces the GPIOF_Handler path)
+#define PROFILE_TIMER_0A_HANDLER      2    // SW2 capture (player 2)
+#define PROFILE_TIMER_1A_HANDLER      3    // Button debounce lockout expiry
+#define PROFILE_UART0_HANDLER         4
+#define PROFILE_UART0_OUTPUT_CHAR     5
+#define PROFILE_UART0_OUTPUT_STRING   6
+#define PROFILE_UART0_WRITE_DMA       7
+#define PROFILE_STIMULUS_ONSET        8    // LED_Set through Mark_Start_Time
+#define PROFILE_PHASE_LED_TEST        9
+#define PROFILE_PHASE_COUNTDOWN       10
+#define PROFILE_PHASE_FOREPERIOD      11
+#define PROFILE_PHASE_STIMULUS        12
+#define PROFILE_PHASE_FEEDBACK        13
+#define PROFILE_PHASE_INTERTRIAL      14
+#define PROFILE_PHASE_RESPONSE        15
+#define PROFILE_REPORT_PRINTF         16    // One formatted report line
+#define PROFILE_PROBE_COUNT           17
+
+// Per-probe statistics
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+} Profile_Stats;
+
+#if PROFILE_ENABLED
+#define PROFILE_START(start)           uint32_t start = DWT->CYCCNT
+#define PROFILE_STOP(start, probe)     Profile_Record((probe), DWT->CYCCNT - (start))
+#else
+#define PROFILE_START(start)
+#define PROFILE_STOP(start, probe)
+#endif
+
+// Function Prototypes
+void Profile_Init(void);
+void Profile_Record(uint8_t probe, uint32_t cycles);
+void Profile_Get_Stats(uint8_t probe, Profile_Stats *stats);
+const char *Profile_Get_Name(uint8_t probe);
+void Profile_Reset(void);
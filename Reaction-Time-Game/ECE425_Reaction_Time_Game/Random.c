@@ -0,0 +1,163 @@
+/**
+ * @file Random.c
+ *
+ * @brief Source code for the pseudo-random number generator.
+ *
+ * This file contains the function definitions for the pseudo-random number generator.
+ *
+ * @note The main loop is the only caller, so the state is never updated concurrently.
+ *
+ * ADC0 Configuration (only powered while the seed is collected):
+ *  - Clock: RCGCADC R0 (Bit 0), conversion clock from the PIOSC (CS = 0x1 in ADCCC)
+ *  - Sample sequencer 3 (one sample), triggered by software through ADCPSSI
+ *  - ADCSSCTL3: TS0 (Bit 3) samples the temperature sensor, IE0 (Bit 2) raises the
+ *    INR3 flag and END0 (Bit 1) ends the sequence
+ *
+ * Seeding:
+ *  - Each conversion result and the DWT cycle count at its completion are mixed into a
+ *    32-bit seed with the MurmurHash3 block and finalization steps
+ *  - The seed is expanded into the four state words with SplitMix32, so any seed,
+ *    including 0, gives a valid (non-zero) state
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Random.h"
+#include "HAL.h"
+
+// Conversions mixed into the seed
+#define RANDOM_ENTROPY_SAMPLES    64
+
+// ADC0 Bit Masks
+#define RANDOM_ADC_SS3_BIT_MASK   0x08    // ASEN3, SS3 in ADCPSSI, INR3 and IN3 in ADCISC
+
+static uint32_t random_state[4];
+static uint32_t random_seed = 0;
+
+static uint32_t Random_Rotate_Left(uint32_t x, uint8_t k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+static uint32_t Random_Split_Mix(uint32_t *x)
+{
+    uint32_t z = (*x += 0x9E3779B9);
+    
+    z = (z ^ (z >> 16)) * 0x85EBCA6B;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35;
+    return z ^ (z >> 16);
+}
+
+static uint32_t Random_Collect_Entropy(void)
+{
+    uint32_t hash = 0;
+    
+    // Enables the clock to ADC0 by setting the R0 bit (Bit 0) in the RCGCADC register
+    SYSCTL->RCGCADC |= 0x01;
+    
+    // Waits for the clock to stabilize
+    while ((SYSCTL->PRADC & 0x01) == 0);
+    
+    // Enables the DWT cycle counter (also done by the profiler when it is compiled in)
+    CoreDebug->DEMCR |= 0x01000000;
+    DWT->CTRL |= 0x01;
+    
+    // Clocks the converter from the PIOSC, so its timing drifts against the core clock
+    ADC0->CC = 0x01;
+    
+    // Configures sample sequencer 3 for one software-triggered temperature sensor sample
+    ADC0->ACTSS &= ~RANDOM_ADC_SS3_BIT_MASK;
+    ADC0->EMUX &= ~0xF000;
+    ADC0->SSMUX3 = 0;
+    ADC0->SSCTL3 = 0x0E;
+    ADC0->ACTSS |= RANDOM_ADC_SS3_BIT_MASK;
+    
+    for (uint8_t i = 0; i < RANDOM_ENTROPY_SAMPLES; i++)
+    {
+        ADC0->PSSI = RANDOM_ADC_SS3_BIT_MASK;
+        while ((ADC0->RIS & RANDOM_ADC_SS3_BIT_MASK) == 0);
+        
+        uint32_t sample = (ADC0->SSFIFO3 & 0xFFF) | (DWT->CYCCNT << 12);
+        ADC0->ISC = RANDOM_ADC_SS3_BIT_MASK;
+        
+        // MurmurHash3 block step
+        sample *= 0xCC9E2D51;
+        sample = Random_Rotate_Left(sample, 15) * 0x1B873593;
+        hash = (Random_Rotate_Left(hash ^ sample, 13) * 5) + 0xE6546B64;
+    }
+    
+    // Turns the converter off again
+    ADC0->ACTSS &= ~RANDOM_ADC_SS3_BIT_MASK;
+    SYSCTL->RCGCADC &= ~0x01;
+    
+    // MurmurHash3 finalization, so every sample bit affects every seed bit
+    hash ^= RANDOM_ENTROPY_SAMPLES * 4;
+    hash = (hash ^ (hash >> 16)) * 0x85EBCA6B;
+    hash = (hash ^ (hash >> 13)) * 0xC2B2AE35;
+    return hash ^ (hash >> 16);
+}
+
+void Random_Init(void)
+{
+    uint32_t seed = HAL_RANDOM_SEED();
+    
+    // A seed of 0 from the HAL means no fixed seed was given
+    if (seed == 0)
+    {
+        seed = Random_Collect_Entropy();
+    }
+    
+    Random_Seed(seed);
+}
+
+void Random_Seed(uint32_t seed)
+{
+    uint32_t x = seed;
+    
+    random_seed = seed;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        random_state[i] = Random_Split_Mix(&x);
+    }
+}
+
+uint32_t Random_Get_Seed(void)
+{
+    return random_seed;
+}
+
+uint32_t Random_Next(void)
+{
+    // xoshiro128**
+    uint32_t result = Random_Rotate_Left(random_state[1] * 5, 7) * 9;
+    uint32_t t = random_state[1] << 9;
+    
+    random_state[2] ^= random_state[0];
+    random_state[3] ^= random_state[1];
+    random_state[1] ^= random_state[2];
+    random_state[0] ^= random_state[3];
+    random_state[2] ^= t;
+    random_state[3] = Random_Rotate_Left(random_state[3], 11);
+    
+    return result;
+}
+
+uint32_t Random_Below(uint32_t bound)
+{
+    // Lemire's multiply-shift: the high word of x * bound is uniform once the few low words
+    // below 2^32 mod bound are rejected, and the modulo is only computed on that rare path
+    uint64_t product = (uint64_t)Random_Next() * bound;
+    uint32_t low = (uint32_t)product;
+    
+    if (low < bound)
+    {
+        uint32_t threshold = (0 - bound) % bound;
+        while (low < threshold)
+        {
+            product = (uint64_t)Random_Next() * bound;
+            low = (uint32_t)product;
+        }
+    }
+    
+    return (uint32_t)(product >> 32);
+}
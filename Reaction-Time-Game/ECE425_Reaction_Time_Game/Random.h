@@ -0,0 +1,29 @@
+/**
+ * @file Random.h
+ *
+ * @brief Header file for the pseudo-random number generator.
+ *
+ * This file contains the function prototypes for the pseudo-random number generator, a
+ * xoshiro128** generator (Blackman and Vigna) with 128 bits of state. It is seeded at
+ * power-up from hardware entropy, so each power-up plays a different sequence.
+ *
+ * Entropy Sources:
+ *  - ADC0 converts the internal temperature sensor with its clock taken from the PIOSC,
+ *    and the low bits of each result are thermal noise
+ *  - The DWT cycle count when each conversion completes, so the jitter between the PIOSC
+ *    and the main oscillator is mixed in as well
+ *
+ * @note The host simulator can supply a fixed seed instead (HAL_RANDOM_SEED), which makes
+ * a run reproducible.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Function Prototypes
+void Random_Init(void);
+void Random_Seed(uint32_t seed);
+uint32_t Random_Get_Seed(void);
+uint32_t Random_Next(void);
+uint32_t Random_Below(uint32_t bound);    // Uniform in [0, bound), without modulo bias
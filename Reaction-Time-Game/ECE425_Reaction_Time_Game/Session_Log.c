@@ -0,0 +1,343 @@
+/**
+ * @file Session_Log.c
+ *
+ * @brief Source code for the persistent session log.
+ *
+ * This file contains the function definitions for the session log.
+ *
+ * @note Appends only queue the record in RAM. Session_Log_Process, called from the main
+ * loop, starts at most one EEPROM word write per call and only when the caller allows it,
+ * so the game keeps EEPROM writes out of the stimulus/response window.
+ *
+ * At boot the head of the ring is found in one pass over the records: the newest record is
+ * the last valid one before the sequence numbers break. The ring holds fewer records than
+ * the 12-bit sequence space, so the break is unambiguous.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Session_Log.h"
+#include "EEPROM.h"
+#include "Power.h"
+#include "HAL.h"
+
+// Ring geometry
+#define SESSION_LOG_FIRST_WORD         EEPROM_WORDS_PER_BLOCK
+#define SESSION_LOG_RECORD_WORDS       2
+#define SESSION_LOG_RECORD_COUNT       ((EEPROM_WORD_COUNT - SESSION_LOG_FIRST_WORD) / SESSION_LOG_RECORD_WORDS)
+#define SESSION_LOG_SEQUENCE_MASK      0x0FFF
+
+// Encoded record waiting to be written
+typedef struct
+{
+    uint32_t word0;
+    uint32_t word1;
+} Session_Log_Entry;
+
+static uint8_t session_log_available = 0;
+
+// Ring state: the next record is written to slot head, the oldest record is count slots behind it
+static uint16_t session_log_head = 0;
+static uint16_t session_log_count = 0;
+static uint16_t session_log_sequence = 0;
+
+// Write queue
+static Session_Log_Entry session_log_queue[SESSION_LOG_QUEUE_SIZE];
+static uint8_t session_log_queue_head = 0;
+static uint8_t session_log_queue_tail = 0;
+static uint8_t session_log_write_step = 0;    // 0: word 1 next, 1: word 0 next
+static uint32_t session_log_dropped = 0;
+
+// Settings cache and the settings words still to be written (bit 0 is the magic word)
+static uint32_t session_log_settings[SESSION_LOG_SETTING_COUNT];
+static uint16_t session_log_settings_dirty = 0;
+
+static uint32_t Session_Log_Check(uint32_t word0, uint32_t word1)
+{
+    // XOR-folds both words (without the check field) into 4 bits
+    uint32_t x = (word0 & ~0x0000F000) ^ word1;
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    
+    return (x ^ 0x5) & 0xF;
+}
+
+static uint16_t Session_Log_Slot_Address(uint16_t slot)
+{
+    return SESSION_LOG_FIRST_WORD + (slot * SESSION_LOG_RECORD_WORDS);
+}
+
+// Reads a slot and returns 1 if it holds a valid record
+static uint8_t Session_Log_Read_Slot(uint16_t slot, uint32_t *word0, uint32_t *word1)
+{
+    uint16_t address = Session_Log_Slot_Address(slot);
+    *word0 = EEPROM_Read_Word(address);
+    *word1 = EEPROM_Read_Word(address + 1);
+    
+    uint32_t type = (*word0 >> 16) & 0xF;
+    
+    return ((type == SESSION_LOG_SESSION) || (type == SESSION_LOG_ROUND)) &&
+           (((*word0 >> 12) & 0xF) == Session_Log_Check(*word0, *word1));
+}
+
+static void Session_Log_Enqueue(uint8_t type, uint16_t field, uint32_t payload)
+{
+    uint8_t next = (session_log_queue_head + 1) % SESSION_LOG_QUEUE_SIZE;
+    
+    if (!session_log_available)
+    {
+        return;
+    }
+    
+    if (next == session_log_queue_tail)
+    {
+        session_log_dropped++;
+        return;
+    }
+    
+    uint32_t word0 = ((uint32_t)session_log_sequence << 20) | ((uint32_t)type << 16) | (field & 0x0FFF);
+    word0 |= Session_Log_Check(word0, payload) << 12;
+    session_log_sequence = (session_log_sequence + 1) & SESSION_LOG_SEQUENCE_MASK;
+    
+    session_log_queue[session_log_queue_head].word0 = word0;
+    session_log_queue[session_log_queue_head].word1 = payload;
+    session_log_queue_head = next;
+}
+
+void Session_Log_Init(void)
+{
+    if (EEPROM_Init() != EEPROM_OK)
+    {
+        session_log_available = 0;
+        return;
+    }
+    session_log_available = 1;
+    
+    // Loads the settings. A block without the magic word (blank, an older layout or leftover
+    // data) is rewritten as erased words in full before the magic word, which is written
+    // last, so none of its old contents can later read back as a setting
+    uint8_t settings_valid = (EEPROM_Read_Word(0) == SESSION_LOG_SETTINGS_MAGIC);
+    for (uint8_t i = 0; i < SESSION_LOG_SETTING_COUNT; i++)
+    {
+        session_log_settings[i] = settings_valid ? EEPROM_Read_Word(1 + i) : EEPROM_ERASED_WORD;
+    }
+    if (!settings_valid)
+    {
+        session_log_settings_dirty = (1 << (SESSION_LOG_SETTING_COUNT + 1)) - 1;
+    }
+    
+    // Finds the newest record: the first valid slot whose successor does not continue the sequence
+    int16_t newest = -1;
+    uint32_t word0, word1;
+    uint32_t next_word0, next_word1;
+    uint8_t valid = Session_Log_Read_Slot(0, &word0, &word1);
+    
+    for (uint16_t slot = 0; slot < SESSION_LOG_RECORD_COUNT; slot++)
+    {
+        uint16_t next_slot = (slot + 1) % SESSION_LOG_RECORD_COUNT;
+        uint8_t next_valid = Session_Log_Read_Slot(next_slot, &next_word0, &next_word1);
+        
+        if (valid && (!next_valid || ((next_word0 >> 20) != (((word0 >> 20) + 1) & SESSION_LOG_SEQUENCE_MASK))))
+        {
+            newest = slot;
+            break;
+        }
+        
+        valid = next_valid;
+        word0 = next_word0;
+    }
+    
+    if (newest < 0)
+    {
+        // Blank log
+        session_log_head = 0;
+        session_log_count = 0;
+        session_log_sequence = 0;
+        return;
+    }
+    
+    session_log_head = (newest + 1) % SESSION_LOG_RECORD_COUNT;
+    session_log_sequence = ((word0 >> 20) + 1) & SESSION_LOG_SEQUENCE_MASK;
+    
+    // Counts back through the consecutive run that ends at the newest record
+    session_log_count = 1;
+    uint16_t expected = word0 >> 20;
+    while (session_log_count < SESSION_LOG_RECORD_COUNT)
+    {
+        uint16_t slot = (newest + SESSION_LOG_RECORD_COUNT - session_log_count) % SESSION_LOG_RECORD_COUNT;
+        expected = (expected - 1) & SESSION_LOG_SEQUENCE_MASK;
+        
+        if (!Session_Log_Read_Slot(slot, &word0, &word1) || ((word0 >> 20) != expected))
+        {
+            break;
+        }
+        session_log_count++;
+    }
+}
+
+uint8_t Session_Log_Available(void)
+{
+    return session_log_available;
+}
+
+void Session_Log_Append_Session(uint16_t total_rounds, uint8_t game_mode, uint8_t player_count)
+{
+    Session_Log_Enqueue(SESSION_LOG_SESSION, total_rounds, ((uint32_t)(game_mode & 0xF) << 4) | (player_count & 0xF));
+}
+
+void Session_Log_Append_Round(uint16_t round_index, uint8_t player, uint8_t stimulus, uint8_t result,
+                              uint16_t foreperiod_ms, uint32_t reaction_time_us)
+{
+    if (reaction_time_us > 0x003FFFFF)
+    {
+        reaction_time_us = 0x003FFFFF;
+    }
+    if (foreperiod_ms > 0x0FFF)
+    {
+        foreperiod_ms = 0x0FFF;
+    }
+    
+    Session_Log_Enqueue(SESSION_LOG_ROUND, foreperiod_ms,
+                        ((uint32_t)(round_index & 0xF) << 28) | ((uint32_t)(player & 0x1) << 27) |
+                        ((uint32_t)(result & 0x7) << 24) | ((uint32_t)(stimulus & 0x3) << 22) | reaction_time_us);
+}
+
+void Session_Log_Process(uint8_t write_allowed)
+{
+    if (!session_log_available || !write_allowed || EEPROM_Busy())
+    {
+        return;
+    }
+    
+    // Records first, one word per call (payload, then the header word that commits the record)
+    if (session_log_queue_tail != session_log_queue_head)
+    {
+        Session_Log_Entry *entry = &session_log_queue[session_log_queue_tail];
+        uint16_t address = Session_Log_Slot_Address(session_log_head);
+        
+        if (session_log_write_step == 0)
+        {
+            EEPROM_Write_Word(address + 1, entry->word1);
+            session_log_write_step = 1;
+        }
+        else
+        {
+            EEPROM_Write_Word(address, entry->word0);
+            session_log_write_step = 0;
+            session_log_queue_tail = (session_log_queue_tail + 1) % SESSION_LOG_QUEUE_SIZE;
+            session_log_head = (session_log_head + 1) % SESSION_LOG_RECORD_COUNT;
+            if (session_log_count < SESSION_LOG_RECORD_COUNT)
+            {
+                session_log_count++;
+            }
+        }
+        return;
+    }
+    
+    // Then changed settings words, with the magic word of a blank block written last
+    for (uint8_t i = 0; i < SESSION_LOG_SETTING_COUNT; i++)
+    {
+        if (session_log_settings_dirty & (1 << (i + 1)))
+        {
+            session_log_settings_dirty &= ~(1 << (i + 1));
+            EEPROM_Write_Word(1 + i, session_log_settings[i]);
+            return;
+        }
+    }
+    if (session_log_settings_dirty & 0x01)
+    {
+        session_log_settings_dirty &= ~0x01;
+        EEPROM_Write_Word(0, SESSION_LOG_SETTINGS_MAGIC);
+    }
+}
+
+void Session_Log_Flush(void)
+{
+    // Finishes every queued write, sleeping between SysTick wake-ups
+    while (session_log_available && ((session_log_queue_tail != session_log_queue_head) ||
+                                     session_log_settings_dirty || EEPROM_Busy()))
+    {
+        Session_Log_Process(1);
+        Power_Sleep();
+    }
+}
+
+uint16_t Session_Log_Get_Count(void)
+{
+    return session_log_count;
+}
+
+uint8_t Session_Log_Read(uint16_t index, Session_Log_Record *record)
+{
+    uint32_t word0, word1;
+    
+    // Index 0 is the oldest record written to the EEPROM
+    if (index >= session_log_count)
+    {
+        return 0;
+    }
+    
+    uint16_t slot = (session_log_head + SESSION_LOG_RECORD_COUNT - session_log_count + index) % SESSION_LOG_RECORD_COUNT;
+    if (!Session_Log_Read_Slot(slot, &word0, &word1))
+    {
+        return 0;
+    }
+    
+    record->sequence = word0 >> 20;
+    record->type = (word0 >> 16) & 0xF;
+    record->total_rounds = 0;
+    record->game_mode = 0;
+    record->player_count = 0;
+    record->round_index = 0;
+    record->player = 0;
+    record->stimulus = 0;
+    record->result = 0;
+    record->foreperiod_ms = 0;
+    record->reaction_time_us = 0;
+    
+    if (record->type == SESSION_LOG_SESSION)
+    {
+        record->total_rounds = word0 & 0x0FFF;
+        record->game_mode = (word1 >> 4) & 0xF;
+        record->player_count = ((word1 & 0xF) > 0) ? (word1 & 0xF) : 1;
+    }
+    else
+    {
+        record->foreperiod_ms = word0 & 0x0FFF;
+        record->round_index = word1 >> 28;
+        record->player = (word1 >> 27) & 0x1;
+        record->result = (word1 >> 24) & 0x7;
+        record->stimulus = (word1 >> 22) & 0x3;
+        record->reaction_time_us = word1 & 0x003FFFFF;
+    }
+    
+    return 1;
+}
+
+uint32_t Session_Log_Load_Setting(uint8_t id, uint32_t default_value)
+{
+    if (!session_log_available || (session_log_settings[id] == EEPROM_ERASED_WORD))
+    {
+        return default_value;
+    }
+    
+    return session_log_settings[id];
+}
+
+void Session_Log_Save_Setting(uint8_t id, uint32_t value)
+{
+    // Unchanged settings are not rewritten
+    if (!session_log_available || (session_log_settings[id] == value))
+    {
+        return;
+    }
+    
+    session_log_settings[id] = value;
+    session_log_settings_dirty |= 1 << (id + 1);
+}
+
+uint32_t Session_Log_Get_Dropped_Count(void)
+{
+    return session_log_dropped;
+}
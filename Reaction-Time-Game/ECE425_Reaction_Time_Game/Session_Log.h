@@ -0,0 +1,85 @@
+/**
+ * @file Session_Log.h
+ *
+ * @brief Header file for the persistent session log.
+ *
+ * This file contains the record definitions and function prototypes for the session log,
+ * an append-only ring of round and session records in the on-chip EEPROM, plus a block
+ * of persisted settings.
+ *
+ * EEPROM Layout (32-bit words):
+ *  - Words 0 to 15 (block 0): settings, word 0 holds SESSION_LOG_SETTINGS_MAGIC and
+ *    word (1 + id) holds setting id
+ *  - Words 16 to 511 (blocks 1 to 31): ring of 248 two-word records, written in order
+ *    so every word is programmed once per lap of the ring (wear leveling)
+ *
+ * Record Layout:
+ *  - Word 0: sequence (Bits 31 to 20) | type (Bits 19 to 16) | check (Bits 15 to 12) | field (Bits 11 to 0)
+ *  - Word 1: payload
+ *  - Session record: field = total rounds, payload = game mode (Bits 7 to 4) | number of
+ *    players (Bits 3 to 0, 0 is read as 1)
+ *  - Round record: field = foreperiod in ms (saturating at 4095, PVT intervals are longer),
+ *    payload = round index modulo 16 (Bits 31 to 28) | player (Bit 27) | result code
+ *    (Bits 26 to 24) | stimulus code (Bits 23 to 22) | reaction time in us (Bits 21 to 0)
+ *  - A two-player round is two round records, player 1 first
+ *
+ * @note Word 1 is written before word 0, and the 4-bit check covers both words, so a
+ * record torn by a reset is discarded at the next boot.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Record types
+#define SESSION_LOG_SESSION        0x1
+#define SESSION_LOG_ROUND          0x2
+
+// Persisted settings (ids 0 to 14)
+#define SESSION_LOG_SETTING_TOTAL_ROUNDS    0
+#define SESSION_LOG_SETTING_GAME_MODE       1
+#define SESSION_LOG_SETTING_FOREPERIOD      2
+#define SESSION_LOG_SETTING_LATENCY_OFFSET  3    // See Calibration.h
+#define SESSION_LOG_SETTING_DASHBOARD       4
+#define SESSION_LOG_SETTING_PVT_MINUTES     5
+#define SESSION_LOG_SETTING_LED_TEST_MS     6    // Game pacing, in milliseconds
+#define SESSION_LOG_SETTING_COUNTDOWN_MS    7
+#define SESSION_LOG_SETTING_FEEDBACK_MS     8
+#define SESSION_LOG_SETTING_INTERTRIAL_MS   9
+#define SESSION_LOG_SETTING_COUNT           15
+
+// Marks an initialized settings block (ASCII "RT", layout version 1)
+#define SESSION_LOG_SETTINGS_MAGIC     0x52540001
+
+// Records waiting to be written (the log is written between rounds, so a few records at most)
+#define SESSION_LOG_QUEUE_SIZE         16
+
+// Decoded log record
+typedef struct
+{
+    uint8_t type;
+    uint16_t sequence;
+    uint16_t total_rounds;       // Session records
+    uint8_t game_mode;           // Session records
+    uint8_t player_count;        // Session records
+    uint8_t round_index;         // Round records, modulo 16
+    uint8_t player;              // Round records
+    uint8_t stimulus;            // Round records
+    uint8_t result;
+    uint16_t foreperiod_ms;
+    uint32_t reaction_time_us;
+} Session_Log_Record;
+
+// Function Prototypes
+void Session_Log_Init(void);
+uint8_t Session_Log_Available(void);
+void Session_Log_Append_Session(uint16_t total_rounds, uint8_t game_mode, uint8_t player_count);
+void Session_Log_Append_Round(uint16_t round_index, uint8_t player, uint8_t stimulus, uint8_t result,
+                              uint16_t foreperiod_ms, uint32_t reaction_time_us);
+void Session_Log_Process(uint8_t write_allowed);
+void Session_Log_Flush(void);
+uint16_t Session_Log_Get_Count(void);
+uint8_t Session_Log_Read(uint16_t index, Session_Log_Record *record);
+uint32_t Session_Log_Load_Setting(uint8_t id, uint32_t default_value);
+void Session_Log_Save_Setting(uint8_t id, uint32_t value);
+uint32_t Session_Log_Get_Dropped_Count(void);
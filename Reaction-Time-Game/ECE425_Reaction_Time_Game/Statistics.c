@@ -0,0 +1,291 @@
+/**
+ * @file Statistics.c
+ *
+ * @brief Source code for the streaming reaction time statistics.
+ *
+ * This file contains the function definitions for the statistics engine.
+ *
+ * P-square Estimator (Jain and Chlamtac, 1985):
+ *  - The first five responses fill the markers in sorted order
+ *  - Each later response moves the outer markers if it is a new extreme, then shifts the
+ *    positions of the markers above it by one
+ *  - A middle marker that is one or more positions away from its desired position
+ *    (1 + (n - 1) * {0, p/2, p, (1+p)/2, 1}) moves one position, and its height is
+ *    adjusted with the piecewise-parabolic formula (or linearly when that would break
+ *    the marker order)
+ *  - The quantile estimate is the height of the middle marker
+ *
+ * @note The main loop is the only caller, so the state is never updated concurrently.
+ * Valid reaction times are below 2^21 us (the 2 s timeout), so the mean fits in 32 bits
+ * at 1/256 us for any number of trials and its update is a single SDIV on the Cortex-M4.
+ * The sum of squares, the desired marker positions and the parabolic prediction use 64
+ * bits, so a channel can hold any number of trials. The prediction is the only 64-bit
+ * division, and it only runs on the trials where a marker moves.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Statistics.h"
+
+// Quantiles tracked by the P-square estimators
+#define STATISTICS_MEDIAN    0
+#define STATISTICS_P90       1
+#define STATISTICS_P99       2
+#define STATISTICS_QUANTILE_COUNT    3
+
+// Q16 constants
+#define Q16_ONE    65536
+
+// Per-channel state
+typedef struct
+{
+    Statistics_Summary counts;      // Counts, minimum and maximum
+    int32_t mean_q8;                // Mean in 1/256 us
+    uint64_t sum_squares;           // Sum of squared differences from the mean in us^2
+    Statistics_Quantile quantiles[STATISTICS_QUANTILE_COUNT];
+} Statistics_Channel;
+
+static Statistics_Channel statistics_channels[STATISTICS_CHANNEL_COUNT];
+
+// Quantiles in 1/65536 units: 0.5, 0.9 and 0.99
+static const uint32_t quantile_fractions[STATISTICS_QUANTILE_COUNT] = { 32768, 58982, 64881 };
+
+static void Statistics_Update_Quantile(Statistics_Quantile *quantile, int32_t x, uint32_t n);
+static int32_t Statistics_Get_Quantile(const Statistics_Quantile *quantile, uint32_t n);
+
+void Statistics_Reset(void)
+{
+    for (uint8_t channel = 0; channel < STATISTICS_CHANNEL_COUNT; channel++)
+    {
+        Statistics_Channel *state = &statistics_channels[channel];
+        
+        state->counts.trials = 0;
+        state->counts.valid = 0;
+        state->counts.lapses = 0;
+        state->counts.anticipations = 0;
+        state->counts.false_starts = 0;
+        state->counts.no_responses = 0;
+        state->counts.wrong_buttons = 0;
+        state->counts.no_go_presses = 0;
+        state->counts.withheld = 0;
+        state->counts.min_us = 0;
+        state->counts.max_us = 0;
+        state->mean_q8 = 0;
+        state->sum_squares = 0;
+        
+        for (uint8_t i = 0; i < STATISTICS_QUANTILE_COUNT; i++)
+        {
+            state->quantiles[i].fraction_q16 = quantile_fractions[i];
+        }
+    }
+}
+
+void Statistics_Add_Trial(uint8_t channel, uint8_t outcome, uint32_t reaction_time_us)
+{
+    Statistics_Channel *state = &statistics_channels[channel];
+    Statistics_Summary *statistics = &state->counts;
+    
+    statistics->trials++;
+    
+    switch (outcome)
+    {
+        case RESULT_VALID:
+            break;
+            
+        case RESULT_ANTICIPATED:
+            statistics->anticipations++;
+            return;
+            
+        case RESULT_FALSE_START:
+            statistics->false_starts++;
+            return;
+            
+        case RESULT_WRONG_BUTTON:
+            statistics->wrong_buttons++;
+            return;
+            
+        case RESULT_NO_GO_PRESS:
+            statistics->no_go_presses++;
+            return;
+            
+        case RESULT_WITHHELD:
+            statistics->withheld++;
+            return;
+            
+        default:
+            statistics->no_responses++;
+            return;
+    }
+    
+    uint32_t n = ++statistics->valid;
+    
+    if ((n == 1) || (reaction_time_us < statistics->min_us))
+    {
+        statistics->min_us = reaction_time_us;
+    }
+    if (reaction_time_us > statistics->max_us)
+    {
+        statistics->max_us = reaction_time_us;
+    }
+    if (reaction_time_us > STATISTICS_LAPSE_US)
+    {
+        statistics->lapses++;
+    }
+    
+    // Welford's update: both differences have the same sign, so the product is never negative
+    int32_t x_q8 = (int32_t)(reaction_time_us << 8);
+    int32_t delta_q8 = x_q8 - state->mean_q8;
+    state->mean_q8 += delta_q8 / (int32_t)n;
+    state->sum_squares += (uint64_t)(((int64_t)delta_q8 * (x_q8 - state->mean_q8)) >> 16);
+    
+    for (uint8_t i = 0; i < STATISTICS_QUANTILE_COUNT; i++)
+    {
+        Statistics_Update_Quantile(&state->quantiles[i], (int32_t)reaction_time_us, n);
+    }
+}
+
+void Statistics_Get_Summary(uint8_t channel, Statistics_Summary *summary)
+{
+    const Statistics_Channel *state = &statistics_channels[channel];
+    uint32_t n = state->counts.valid;
+    
+    *summary = state->counts;
+    summary->mean_us = (n > 0) ? (uint32_t)((state->mean_q8 + 128) >> 8) : 0;
+    summary->std_dev_us = (n > 1) ? Statistics_Square_Root(state->sum_squares / (n - 1)) : 0;
+    summary->median_us = (uint32_t)Statistics_Get_Quantile(&state->quantiles[STATISTICS_MEDIAN], n);
+    summary->p90_us = (uint32_t)Statistics_Get_Quantile(&state->quantiles[STATISTICS_P90], n);
+    summary->p99_us = (uint32_t)Statistics_Get_Quantile(&state->quantiles[STATISTICS_P99], n);
+}
+
+uint32_t Statistics_Square_Root(uint64_t n)
+{
+    // Bitwise integer square root, rounded down
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    
+    while (bit > n)
+    {
+        bit >>= 2;
+    }
+    
+    while (bit != 0)
+    {
+        if (n >= (root + bit))
+        {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    
+    return (uint32_t)root;
+}
+
+static void Statistics_Update_Quantile(Statistics_Quantile *quantile, int32_t x, uint32_t n)
+{
+    int32_t *height = quantile->height;
+    int32_t *position = quantile->position;
+    
+    // Fills the markers with the first five responses in sorted order
+    if (n <= STATISTICS_MARKER_COUNT)
+    {
+        uint8_t i = n - 1;
+        while ((i > 0) && (height[i - 1] > x))
+        {
+            height[i] = height[i - 1];
+            i--;
+        }
+        height[i] = x;
+        position[n - 1] = n;
+        return;
+    }
+    
+    // Finds the cell containing x, extending the outer markers for a new extreme
+    uint8_t cell;
+    if (x < height[0])
+    {
+        height[0] = x;
+        cell = 0;
+    }
+    else if (x >= height[4])
+    {
+        height[4] = x;
+        cell = 3;
+    }
+    else
+    {
+        cell = 0;
+        while (x >= height[cell + 1])
+        {
+            cell++;
+        }
+    }
+    
+    for (uint8_t i = cell + 1; i < STATISTICS_MARKER_COUNT; i++)
+    {
+        position[i]++;
+    }
+    
+    // Desired position increments: 0, p/2, p, (1+p)/2, 1
+    uint32_t p = quantile->fraction_q16;
+    const uint32_t increments[STATISTICS_MARKER_COUNT] = { 0, p / 2, p, (Q16_ONE + p) / 2, Q16_ONE };
+    
+    for (uint8_t i = 1; i < (STATISTICS_MARKER_COUNT - 1); i++)
+    {
+        int64_t desired_q16 = Q16_ONE + ((uint64_t)(n - 1) * increments[i]);
+        int64_t offset_q16 = desired_q16 - ((int64_t)position[i] << 16);
+        
+        int32_t step;
+        if ((offset_q16 >= Q16_ONE) && ((position[i + 1] - position[i]) > 1))
+        {
+            step = 1;
+        }
+        else if ((offset_q16 <= -Q16_ONE) && ((position[i - 1] - position[i]) < -1))
+        {
+            step = -1;
+        }
+        else
+        {
+            continue;
+        }
+        
+        // Piecewise-parabolic prediction, as its two terms over the distance between the neighbors
+        int64_t below = position[i] - position[i - 1];
+        int64_t above = position[i + 1] - position[i];
+        int64_t upper_term = (below + step) * (height[i + 1] - height[i]) / above;
+        int64_t lower_term = (above - step) * (height[i] - height[i - 1]) / below;
+        int64_t predicted = height[i] + (step * (upper_term + lower_term) / (below + above));
+        
+        if ((predicted > height[i - 1]) && (predicted < height[i + 1]))
+        {
+            height[i] = (int32_t)predicted;
+        }
+        else
+        {
+            // Linear prediction toward the neighbor in the direction of the step
+            height[i] += step * (height[i + step] - height[i]) / (position[i + step] - position[i]);
+        }
+        position[i] += step;
+    }
+}
+
+static int32_t Statistics_Get_Quantile(const Statistics_Quantile *quantile, uint32_t n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+    
+    if (n > STATISTICS_MARKER_COUNT)
+    {
+        return quantile->height[2];
+    }
+    
+    // Nearest rank among the sorted first responses (the markers still hold all of them): ceil(p * n) - 1
+    uint32_t rank = ((quantile->fraction_q16 * n) + Q16_ONE - 1) >> 16;
+    return quantile->height[(rank > 0) ? (rank - 1) : 0];
+}
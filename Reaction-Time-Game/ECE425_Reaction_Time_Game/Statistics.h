@@ -0,0 +1,77 @@
+/**
+ * @file Statistics.h
+ *
+ * @brief Header file for the streaming reaction time statistics.
+ *
+ * This file contains the outcome codes, summary structure and function prototypes for the
+ * statistics engine. Each channel (one per player, or one per stimulus color in choice
+ * mode) keeps a fixed amount of state, so a session of any length uses the same RAM:
+ *  - Mean and variance with Welford's method (mean in 1/256 us fixed point)
+ *  - Minimum and maximum
+ *  - Median, 90th and 99th percentiles with P-square estimators (five markers each)
+ *  - Counts of lapses, anticipations, false starts and missed stimuli
+ *  - Choice mode: counts of wrong-button presses, no-go presses and withheld responses
+ *
+ * @note All arithmetic is integer, so the engine does not depend on the FPU. The
+ * percentiles are exact for the first five valid responses and estimates after that.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Trial outcome codes (also stored in the session log and telemetry records)
+typedef enum
+{
+    RESULT_VALID,
+    RESULT_NO_RESPONSE,
+    RESULT_ANTICIPATED,     // Pressed within ANTICIPATION_THRESHOLD_MS of the stimulus
+    RESULT_FALSE_START,     // Pressed before the stimulus
+    RESULT_WRONG_BUTTON,    // Choice mode: pressed the other button
+    RESULT_NO_GO_PRESS,     // Choice mode: pressed for the no-go stimulus
+    RESULT_WITHHELD         // Choice mode: did not press for the no-go stimulus (correct)
+} RoundOutcome;
+
+// Independent statistics channels, one per player or stimulus color
+#define STATISTICS_CHANNEL_COUNT    3
+
+// Valid responses slower than this count as lapses
+#define STATISTICS_LAPSE_US         500000
+
+// Number of P-square markers per estimator
+#define STATISTICS_MARKER_COUNT     5
+
+// P-square estimator for one quantile
+typedef struct
+{
+    int32_t height[STATISTICS_MARKER_COUNT];      // Marker heights in us
+    int32_t position[STATISTICS_MARKER_COUNT];    // Actual marker positions (1-based)
+    uint32_t fraction_q16;                        // Quantile in 1/65536 units
+} Statistics_Quantile;
+
+// Session summary
+typedef struct
+{
+    uint32_t trials;
+    uint32_t valid;
+    uint32_t lapses;              // Valid responses slower than STATISTICS_LAPSE_US
+    uint32_t anticipations;
+    uint32_t false_starts;
+    uint32_t no_responses;
+    uint32_t wrong_buttons;
+    uint32_t no_go_presses;
+    uint32_t withheld;
+    uint32_t min_us;              // Valid responses only, 0 when there are none
+    uint32_t max_us;
+    uint32_t mean_us;
+    uint32_t std_dev_us;          // Sample standard deviation, 0 below two responses
+    uint32_t median_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+} Statistics_Summary;
+
+// Function Prototypes
+void Statistics_Reset(void);
+void Statistics_Add_Trial(uint8_t channel, uint8_t outcome, uint32_t reaction_time_us);
+void Statistics_Get_Summary(uint8_t channel, Statistics_Summary *summary);
+uint32_t Statistics_Square_Root(uint64_t n);
@@ -0,0 +1,64 @@
+/**
+ * @file Stimulus_Schedule.c
+ *
+ * @brief Source code for the stimulus schedule.
+ *
+ * This file contains the function definitions for the stimulus schedule.
+ *
+ * Choice Schedule:
+ *  - The trials are filled with the three colors in turn, so each color appears in a
+ *    third of the trials (the counts differ by one at most)
+ *  - The trials are then shuffled with a Fisher-Yates shuffle, so the order is random
+ *    but the proportions are exact in every session
+ *
+ * @note Trial n is held in bits 2(n mod 4)+1 to 2(n mod 4) of byte n / 4.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Stimulus_Schedule.h"
+#include "Random.h"
+
+// Packed stimulus codes, four per byte
+static uint8_t stimulus_schedule[(STIMULUS_SCHEDULE_MAX_TRIALS + 3) / 4];
+
+static void Stimulus_Schedule_Set(uint16_t trial, uint8_t stimulus)
+{
+    uint8_t shift = (trial & 0x3) * 2;
+    
+    stimulus_schedule[trial >> 2] = (stimulus_schedule[trial >> 2] & ~(0x3 << shift)) | (stimulus << shift);
+}
+
+void Stimulus_Schedule_Generate(uint16_t trials, uint8_t choice)
+{
+    if (trials > STIMULUS_SCHEDULE_MAX_TRIALS)
+    {
+        trials = STIMULUS_SCHEDULE_MAX_TRIALS;
+    }
+    
+    // Simple sessions are red every trial
+    for (uint16_t trial = 0; trial < trials; trial++)
+    {
+        Stimulus_Schedule_Set(trial, choice ? (trial % STIMULUS_COUNT) : STIMULUS_RED);
+    }
+    
+    if (!choice || (trials < 2))
+    {
+        return;
+    }
+    
+    // Swaps each trial with a uniformly chosen trial at or before it
+    for (uint16_t trial = trials - 1; trial > 0; trial--)
+    {
+        uint16_t other = (uint16_t)Random_Below(trial + 1);
+        uint8_t stimulus = Stimulus_Schedule_Get(trial);
+        
+        Stimulus_Schedule_Set(trial, Stimulus_Schedule_Get(other));
+        Stimulus_Schedule_Set(other, stimulus);
+    }
+}
+
+uint8_t Stimulus_Schedule_Get(uint16_t trial)
+{
+    return (stimulus_schedule[trial >> 2] >> ((trial & 0x3) * 2)) & 0x3;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file Stimulus_Schedule.h
+ *
+ * @brief Header file for the stimulus schedule.
+ *
+ * This file contains the stimulus codes and function prototypes for the stimulus schedule,
+ * the sequence of stimulus colors for a session. The schedule is generated once when the
+ * session starts, so a trial only looks up its stimulus.
+ *
+ * Stimulus Codes (also stored in the session log and telemetry records):
+ *  - STIMULUS_RED: press SW1
+ *  - STIMULUS_GREEN: press SW2 (choice mode only)
+ *  - STIMULUS_BLUE: no-go, do not press (choice mode only)
+ *
+ * @note The table packs four 2-bit stimulus codes per byte, so a session of
+ * STIMULUS_SCHEDULE_MAX_TRIALS trials takes 250 bytes.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Stimulus codes
+#define STIMULUS_RED      0
+#define STIMULUS_GREEN    1
+#define STIMULUS_BLUE     2
+#define STIMULUS_COUNT    3
+
+// Longest session the table holds
+#define STIMULUS_SCHEDULE_MAX_TRIALS    1000
+
+// Function Prototypes
+void Stimulus_Schedule_Generate(uint16_t trials, uint8_t choice);
+uint8_t Stimulus_Schedule_Get(uint16_t trial);
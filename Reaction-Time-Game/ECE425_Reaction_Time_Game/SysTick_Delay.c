@@ -5,49 +5,130 @@
  *
  * This file contains the function definitions for the SysTick Delay driver.
  *
- * @note Assumes that the frequency of the system clock is 16 MHz.
- *
  * SysTick Configuration:
- *  - System Clock: 16 MHz
+ *  - System Clock: SYSTEM_CLOCK_HZ (PIOSC / 4 while the core is in deep sleep)
  *  - Interrupt: Enabled
- *  - Reload Value: Set for 1 ms interrupts
+ *  - Reload Value: Set for 1 ms interrupts, or in deep sleep for one interrupt at the next
+ *    deadline (tickless, up to SYSTICK_TICKLESS_MAX_MS)
+ *
+ * The SysTick interrupt drives a free-running 64-bit millisecond counter that is never
+ * reset. It is kept as two 32-bit words, so readers retry if the interrupt carried into
+ * the upper word in the middle of a read. This makes the read functions safe to call
+ * from both interrupt handlers and the main loop without disabling interrupts. Every
+ * tick outside deep sleep is also posted to the SysTick event queue (see Event_Queue.h).
+ *
+ * Switching between the 1 ms ticks and a tickless period adds the time counted so far in
+ * the current period to the clock, and carries the part of a millisecond that is left over
+ * into the next switch, so the clock does not lose time however often the core sleeps.
  *
  * @author Benjamin Nguyen
  */
 
 #include "SysTick_Delay.h"
-#include "TM4C123GH6PM.h"
+#include "Event_Queue.h"
+#include "Power.h"
+#include "Profile.h"
+#include "HAL.h"
+
+// Free-running millisecond counter (upper and lower 32-bit words)
+static volatile uint32_t systick_counter_high = 0;
+static volatile uint32_t systick_counter_low = 0;
 
-// Global variable
-static volatile uint32_t systick_counter = 0;
+// Reload value, tick rate and milliseconds per interrupt of the current period
+static uint32_t systick_reload = SYSTICK_RELOAD_VALUE;
+static uint32_t systick_ticks_per_us = SYSTICK_TICKS_PER_US;
+static uint32_t systick_period_ms = 1;
 
-// SysTick register addresses
-#define NVIC_ST_CTRL     (*((volatile uint32_t *)0xE000E010))
-#define NVIC_ST_RELOAD   (*((volatile uint32_t *)0xE000E014))
-#define NVIC_ST_CURRENT  (*((volatile uint32_t *)0xE000E018))
+// Microseconds counted at the last switch that did not make up a whole millisecond
+static uint32_t systick_carry_us = 0;
+
+// SysTick pending bit (PENDSTSET, Bit 26) in the Interrupt Control and State register
+#define SCB_ICSR_PENDSTSET_BIT_MASK  0x04000000
 
 void SysTick_Init(void)
 {
     // Disables SysTick during configuration
-    NVIC_ST_CTRL = 0;
+    SysTick->CTRL = 0;
     
-    // Sets reload value for 1 ms interrupts at 16 MHz
+    // Sets reload value for 1 ms interrupts
     // Reload value = (Desired period * Clock Frequency) - 1
-    // For 1 ms: (0.001 * 16,000,000) - 1 = 15999
-    NVIC_ST_RELOAD = 15999;  // 1 ms at 16 MHz
+    // For 1 ms at 80 MHz: (0.001 * 80,000,000) - 1 = 79999
+    SysTick->LOAD = SYSTICK_RELOAD_VALUE;  // 1 ms
     
     // Clears current value
-    NVIC_ST_CURRENT = 0;
+    SysTick->VAL = 0;
     
     // Enables SysTick with system clock & interrupt
     // Bit 0: Enable, Bit 1: Interrupt Enable, Bit 2: Clock Source (1 = system clock)
-    NVIC_ST_CTRL = 0x07;
+    SysTick->CTRL = 0x07;
+}
+
+static void SysTick_Advance(uint32_t ms)
+{
+    uint32_t low = systick_counter_low + ms;
+    
+    // Carries into the upper word before publishing the wrapped lower word
+    if (low < systick_counter_low)
+    {
+        systick_counter_high++;
+    }
+    systick_counter_low = low;
+}
+
+// Stops SysTick and adds the time counted in the current period to the clock
+static void SysTick_Stop(void)
+{
+    // Clearing the ENABLE bit freezes the current value. A reload that was already due is
+    // taken as soon as the write completes, so it is counted with the period it ended
+    SysTick->CTRL = 0;
+    
+    uint32_t elapsed_us = systick_carry_us + ((systick_reload - SysTick->VAL) / systick_ticks_per_us);
+    SysTick_Advance(elapsed_us / 1000);
+    systick_carry_us = elapsed_us % 1000;
+}
+
+void SysTick_Start_Tickless(uint32_t period_ms)
+{
+    SysTick_Stop();
+    
+    // One interrupt after period_ms from PIOSC / 4, which keeps running in deep sleep
+    if (period_ms > SYSTICK_TICKLESS_MAX_MS)
+    {
+        period_ms = SYSTICK_TICKLESS_MAX_MS;
+    }
+    systick_reload = (period_ms * (SYSTEM_CLOCK_SYSTICK_PIOSC_HZ / 1000)) - 1;
+    systick_ticks_per_us = SYSTEM_CLOCK_SYSTICK_PIOSC_HZ / 1000000;
+    systick_period_ms = period_ms;
+    SysTick->LOAD = systick_reload;
+    SysTick->VAL = 0;
+    
+    // Selects PIOSC / 4 by clearing the CLK_SRC bit (Bit 2)
+    SysTick->CTRL = 0x03;
+}
+
+void SysTick_Stop_Tickless(void)
+{
+    SysTick_Stop();
+    
+    // Returns to 1 ms interrupts from the system clock
+    systick_reload = SYSTICK_RELOAD_VALUE;
+    systick_ticks_per_us = SYSTICK_TICKS_PER_US;
+    systick_period_ms = 1;
+    SysTick->LOAD = systick_reload;
+    SysTick->VAL = 0;
+    SysTick->CTRL = 0x07;
 }
 
 void SysTick_Delay(uint32_t delay_ms)
 {
-    systick_counter = 0;
-    while (systick_counter < delay_ms);
+    // Sleeps until the deadline instead of resetting the clock, so timestamps
+    // taken before the delay remain valid
+    uint64_t deadline = SysTick_Get_Time_Ms64() + delay_ms;
+    
+    while (SysTick_Get_Time_Ms64() < deadline)
+    {
+        Power_Sleep();
+    }
 }
 
 void SysTick_Delay_Milliseconds(uint32_t ms)
@@ -57,21 +138,58 @@ void SysTick_Delay_Milliseconds(uint32_t ms)
 
 uint32_t SysTick_Get_Current_Time(void)
 {
-    return systick_counter;  // Returns milliseconds
+    return systick_counter_low;  // Returns milliseconds (lower 32 bits of the monotonic clock)
 }
 
-uint32_t Generate_Random_Delay(uint32_t min_ms, uint32_t max_ms)
+uint64_t SysTick_Get_Time_Ms64(void)
 {
-    static uint32_t seed = 12345;
+    uint32_t high;
+    uint32_t low;
     
-    // Simple pseudo-random number generator
-    seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+    // Re-reads if the lower word carried into the upper word during the read
+    do
+    {
+        high = systick_counter_high;
+        low = systick_counter_low;
+    } while (high != systick_counter_high);
     
-    return min_ms + (seed % (max_ms - min_ms + 1));
+    return ((uint64_t)high << 32) | low;
 }
 
-// SysTick Interrupt Handler - increments every 1 ms
+uint64_t SysTick_Get_Time_Us64(void)
+{
+    uint64_t ms;
+    uint32_t current;
+    
+    // Re-reads if a SysTick interrupt was serviced during the read
+    do
+    {
+        ms = SysTick_Get_Time_Ms64();
+        current = SysTick->VAL;
+    } while (ms != SysTick_Get_Time_Ms64());
+    
+    // When called with SysTick masked (e.g. from a higher priority handler), a reload
+    // that has not been counted yet shows up as a pending SysTick with a high current value
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_BIT_MASK) && (current > (systick_reload / 2)))
+    {
+        ms++;
+    }
+    
+    return (ms * 1000) + systick_carry_us + ((systick_reload - current) / systick_ticks_per_us);
+}
+
+// SysTick Interrupt Handler - increments every 1 ms (every tickless period in deep sleep)
+// and posts the tick
 void SysTick_Handler(void)
 {
-    systick_counter++;
-}
\ No newline at end of file
+    PROFILE_START(profile_start);
+    SysTick_Advance(systick_period_ms);
+    
+    // Tickless periods in deep sleep are not posted: the capture timers that stamp events
+    // are not clocked, and the main loop is not running to drain them
+    if (systick_period_ms == 1)
+    {
+        Event_Queue_Post_Now(EVENT_SOURCE_SYSTICK, EVENT_SYSTICK_TICK, (uint8_t)systick_counter_low);
+    }
+    PROFILE_STOP(profile_start, PROFILE_SYSTICK_HANDLER);
+}
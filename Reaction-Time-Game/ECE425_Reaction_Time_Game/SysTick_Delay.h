@@ -5,16 +5,26 @@
  *
  * This file contains the function prototypes and definitions for the SysTick Delay driver.
  *
- * @note Assumes that the frequency of the system clock is 16 MHz.
- *
  * @author Benjamin Nguyen
  */
 
 #include <stdint.h>
+#include "System_Clock.h"
+
+// SysTick reload value for 1 ms interrupts and ticks per microsecond, from SYSTEM_CLOCK_HZ
+// (see System_Clock.h)
+#define SYSTICK_RELOAD_VALUE    SYSTEM_CLOCK_SYSTICK_RELOAD
+#define SYSTICK_TICKS_PER_US    SYSTEM_CLOCK_TICKS_PER_US
+
+// Longest tickless period (SysTick_Start_Tickless), about 4.19 s
+#define SYSTICK_TICKLESS_MAX_MS    SYSTEM_CLOCK_SYSTICK_MAX_SLEEP_MS
 
 // Function Prototypes
 void SysTick_Init(void);
+void SysTick_Start_Tickless(uint32_t period_ms);
+void SysTick_Stop_Tickless(void);
 void SysTick_Delay(uint32_t delay_ms);
 void SysTick_Delay_Milliseconds(uint32_t ms);
 uint32_t SysTick_Get_Current_Time(void);  // Returns time in milliseconds
-uint32_t Generate_Random_Delay(uint32_t min_ms, uint32_t max_ms);
\ No newline at end of file
+uint64_t SysTick_Get_Time_Ms64(void);     // Returns monotonic time in milliseconds
+uint64_t SysTick_Get_Time_Us64(void);     // Returns monotonic time in microseconds
\ No newline at end of file
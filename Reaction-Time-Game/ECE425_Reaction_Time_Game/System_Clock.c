@@ -0,0 +1,73 @@
+/**
+ * @file System_Clock.c
+ *
+ * @brief Source code for the system clock configuration.
+ *
+ * This file contains the function definitions for the system clock configuration.
+ *
+ * PLL Configuration:
+ *  - Source: 16 MHz main oscillator (XTAL = 0x15 in RCC, OSCSRC2 = 0x0 in RCC2)
+ *  - PLL: 400 MHz (DIV400 set in RCC2), divided by SYSTEM_CLOCK_SYSDIV2 + 1
+ *  - The system clock is bypassed to the oscillator while the PLL is configured, and only
+ *    switched to the PLL once it reports lock
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "System_Clock.h"
+#include "HAL.h"
+
+// Compile-time checks: the array size is negative, so the build fails, if a condition is false
+#define SYSTEM_CLOCK_STATIC_ASSERT(condition, name)    typedef char name[(condition) ? 1 : -1]
+
+// Difference between the actual and the requested UART0 baud rate
+#define SYSTEM_CLOCK_UART0_BAUD_ERROR    ((UART0_ACTUAL_BAUD_RATE > UART0_BAUD_RATE) ? (UART0_ACTUAL_BAUD_RATE - UART0_BAUD_RATE) : \
+                                                                                  (UART0_BAUD_RATE - UART0_ACTUAL_BAUD_RATE))
+
+SYSTEM_CLOCK_STATIC_ASSERT((SYSTEM_CLOCK_PLL_HZ % SYSTEM_CLOCK_HZ) == 0, system_clock_reachable_from_pll);
+SYSTEM_CLOCK_STATIC_ASSERT((SYSTEM_CLOCK_SYSDIV2 >= 4) && (SYSTEM_CLOCK_SYSDIV2 <= 0x7F), system_clock_sysdiv2_in_range);
+SYSTEM_CLOCK_STATIC_ASSERT((SYSTEM_CLOCK_HZ % 1000000) == 0, system_clock_whole_mhz);
+SYSTEM_CLOCK_STATIC_ASSERT(SYSTEM_CLOCK_SYSTICK_RELOAD <= 0x00FFFFFF, system_clock_systick_reload_fits);
+SYSTEM_CLOCK_STATIC_ASSERT(((SYSTEM_CLOCK_PIOSC_HZ / 4) % SYSTEM_CLOCK_SYSTICK_HZ) == 0, system_clock_systick_piosc_exact);
+SYSTEM_CLOCK_STATIC_ASSERT((UART0_IBRD_VALUE >= 1) && (UART0_IBRD_VALUE <= 0xFFFF), system_clock_uart0_ibrd_in_range);
+SYSTEM_CLOCK_STATIC_ASSERT((SYSTEM_CLOCK_UART0_BAUD_ERROR * 1000000) <= (UART0_BAUD_TOLERANCE_PPM * (uint64_t)UART0_BAUD_RATE),
+                           system_clock_uart0_baud_error_in_tolerance);
+
+// System Control Bit Masks
+#define SYSTEM_CLOCK_USERCC2_BIT_MASK    0x80000000    // RCC2 overrides RCC (RCC2 Bit 31)
+#define SYSTEM_CLOCK_DIV400_BIT_MASK     0x40000000    // Divides the 400 MHz PLL output (RCC2 Bit 30)
+#define SYSTEM_CLOCK_SYSDIV2_MASK        0x1FC00000    // SYSDIV2 and SYSDIV2LSB (RCC2 Bits 28 to 22)
+#define SYSTEM_CLOCK_PWRDN2_BIT_MASK     0x00002000    // Powers the PLL down (RCC2 Bit 13)
+#define SYSTEM_CLOCK_BYPASS2_BIT_MASK    0x00000800    // Bypasses the PLL (RCC2 Bit 11)
+#define SYSTEM_CLOCK_OSCSRC2_MASK        0x00000070    // Oscillator source (RCC2 Bits 6 to 4)
+#define SYSTEM_CLOCK_XTAL_MASK           0x000007C0    // Crystal frequency (RCC Bits 10 to 6)
+#define SYSTEM_CLOCK_XTAL_16MHZ          0x00000540    // XTAL = 0x15
+#define SYSTEM_CLOCK_PLLLRIS_BIT_MASK    0x00000040    // PLL lock (RIS Bit 6)
+
+void System_Clock_Init(void)
+{
+    // Uses RCC2 for its wider divisor field by setting the USERCC2 bit (Bit 31)
+    SYSCTL->RCC2 |= SYSTEM_CLOCK_USERCC2_BIT_MASK;
+    
+    // Runs from the oscillator while the PLL is configured by setting the BYPASS2 bit (Bit 11)
+    SYSCTL->RCC2 |= SYSTEM_CLOCK_BYPASS2_BIT_MASK;
+    
+    // Selects the 16 MHz crystal in the XTAL field (Bits 10 to 6) and the main oscillator
+    // in the OSCSRC2 field (Bits 6 to 4)
+    SYSCTL->RCC = (SYSCTL->RCC & ~SYSTEM_CLOCK_XTAL_MASK) | SYSTEM_CLOCK_XTAL_16MHZ;
+    SYSCTL->RCC2 &= ~SYSTEM_CLOCK_OSCSRC2_MASK;
+    
+    // Powers the PLL on by clearing the PWRDN2 bit (Bit 13)
+    SYSCTL->RCC2 &= ~SYSTEM_CLOCK_PWRDN2_BIT_MASK;
+    
+    // Divides the 400 MHz PLL output by SYSTEM_CLOCK_SYSDIV2 + 1 by setting the DIV400 bit
+    // (Bit 30) and writing the divisor to the SYSDIV2 and SYSDIV2LSB fields (Bits 28 to 22)
+    SYSCTL->RCC2 = (SYSCTL->RCC2 & ~SYSTEM_CLOCK_SYSDIV2_MASK) | SYSTEM_CLOCK_DIV400_BIT_MASK |
+                   ((uint32_t)SYSTEM_CLOCK_SYSDIV2 << 22);
+    
+    // Waits for the PLL to lock
+    while ((SYSCTL->RIS & SYSTEM_CLOCK_PLLLRIS_BIT_MASK) == 0);
+    
+    // Switches the system clock to the PLL by clearing the BYPASS2 bit (Bit 11)
+    SYSCTL->RCC2 &= ~SYSTEM_CLOCK_BYPASS2_BIT_MASK;
+}
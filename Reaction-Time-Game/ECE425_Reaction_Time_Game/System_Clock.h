@@ -0,0 +1,58 @@
+/**
+ * @file System_Clock.h
+ *
+ * @brief Header file for the system clock configuration.
+ *
+ * This file contains the system clock frequency and every peripheral timing constant
+ * derived from it. The drivers take their divisors and tick rates from here, so changing
+ * SYSTEM_CLOCK_HZ retimes the whole firmware and the constants cannot drift apart.
+ *
+ * Derived Constants:
+ *  - SYSTEM_CLOCK_SYSDIV2: PLL divisor, 400 MHz / (SYSDIV2 + 1) with DIV400 set
+ *  - UART0_IBRD_VALUE and UART0_FBRD_VALUE: BRD = UART0_CLOCK_HZ / (16 * UART0_BAUD_RATE),
+ *    split into the integer part and the fraction in 64ths (rounded to nearest)
+ *  - SYSTEM_CLOCK_SYSTICK_RELOAD: SysTick reload value for SYSTEM_CLOCK_SYSTICK_HZ interrupts
+ *  - SYSTEM_CLOCK_SYSTICK_PIOSC_HZ: the SysTick clock in deep sleep (the PIOSC divided by 4),
+ *    and SYSTEM_CLOCK_SYSTICK_MAX_SLEEP_MS, the longest period its 24-bit reload value allows
+ *  - SYSTEM_CLOCK_TICKS_PER_US: tick rate of SysTick, the DWT cycle counter and the GPTM
+ *    timers. The timers run undivided: the capture timers use the prescaler as a counter
+ *    extension and Timer 1A is a 32-bit timer, so none of them needs a prescale value.
+ *
+ * UART0 is clocked from the 16 MHz precision internal oscillator (PIOSC) rather than the
+ * system clock, so it keeps its baud rate in deep sleep, where the PLL is off.
+ *
+ * @note The build fails if the frequency cannot be reached from the PLL, is not a whole
+ * number of MHz, or gives a baud rate error above UART0_BAUD_TOLERANCE_PPM (see the static
+ * assertions in System_Clock.c).
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// System clock, from the PLL (80 MHz is the maximum for the TM4C123)
+#define SYSTEM_CLOCK_HZ                80000000
+#define SYSTEM_CLOCK_PLL_HZ            400000000
+#define SYSTEM_CLOCK_SYSDIV2           ((SYSTEM_CLOCK_PLL_HZ / SYSTEM_CLOCK_HZ) - 1)
+#define SYSTEM_CLOCK_TICKS_PER_US      (SYSTEM_CLOCK_HZ / 1000000)
+
+// Precision internal oscillator, which keeps running in deep sleep
+#define SYSTEM_CLOCK_PIOSC_HZ          16000000
+
+// SysTick interrupt rate and reload value
+#define SYSTEM_CLOCK_SYSTICK_HZ        1000
+#define SYSTEM_CLOCK_SYSTICK_RELOAD    ((SYSTEM_CLOCK_HZ / SYSTEM_CLOCK_SYSTICK_HZ) - 1)
+#define SYSTEM_CLOCK_SYSTICK_PIOSC_HZ        (SYSTEM_CLOCK_PIOSC_HZ / 4)
+#define SYSTEM_CLOCK_SYSTICK_MAX_SLEEP_MS    (0x01000000 / (SYSTEM_CLOCK_SYSTICK_PIOSC_HZ / 1000))
+
+// UART0 clock, baud rate, divisors and the baud rate they actually give
+#define UART0_CLOCK_HZ                 SYSTEM_CLOCK_PIOSC_HZ
+#define UART0_BAUD_RATE                115200
+#define UART0_BAUD_TOLERANCE_PPM       10000    // 1%
+#define UART0_BRD_64THS                ((((UART0_CLOCK_HZ * 8ULL) / UART0_BAUD_RATE) + 1) / 2)
+#define UART0_IBRD_VALUE               (UART0_BRD_64THS >> 6)
+#define UART0_FBRD_VALUE               (UART0_BRD_64THS & 0x3F)
+#define UART0_ACTUAL_BAUD_RATE         ((UART0_CLOCK_HZ * 4ULL) / UART0_BRD_64THS)
+
+// Function Prototypes
+void System_Clock_Init(void);
@@ -0,0 +1,135 @@
+/**
+ * @file Telemetry.c
+ *
+ * @brief Source code for the binary telemetry stream.
+ *
+ * This file contains the function definitions for the telemetry stream.
+ *
+ * @note Frames are handed to UART0_Write_DMA, so they leave in order with any text
+ * written through the UART0 driver. Telemetry is only sent from the main loop.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Telemetry.h"
+#include "UART.h"
+
+// Sequence number of the next frame
+static uint16_t telemetry_sequence = 0;
+
+// Record being assembled
+static uint8_t telemetry_record[TELEMETRY_MAX_RECORD_SIZE];
+static uint8_t telemetry_record_length = 0;
+
+static void Telemetry_Begin(uint8_t type)
+{
+    telemetry_record[0] = type;
+    telemetry_record[1] = telemetry_sequence & 0xFF;
+    telemetry_record[2] = telemetry_sequence >> 8;
+    telemetry_record_length = 3;
+    telemetry_sequence++;
+}
+
+static void Telemetry_Put_U8(uint8_t value)
+{
+    telemetry_record[telemetry_record_length++] = value;
+}
+
+static void Telemetry_Put_U16(uint16_t value)
+{
+    Telemetry_Put_U8(value & 0xFF);
+    Telemetry_Put_U8(value >> 8);
+}
+
+static void Telemetry_Put_U32(uint32_t value)
+{
+    Telemetry_Put_U16(value & 0xFFFF);
+    Telemetry_Put_U16(value >> 16);
+}
+
+// Appends the CRC16, COBS-encodes the record between two delimiters and sends the frame
+static void Telemetry_End(void)
+{
+    // Delimiter (1) + COBS overhead (1) + record + delimiter (1)
+    char frame[TELEMETRY_MAX_RECORD_SIZE + 3];
+    uint8_t frame_length = 0;
+    
+    Telemetry_Put_U16(Telemetry_CRC16(telemetry_record, telemetry_record_length));
+    
+    frame[frame_length++] = 0;
+    
+    // Each code byte holds the distance to the next zero (records are shorter than 254 bytes)
+    uint8_t code_index = frame_length++;
+    uint8_t code = 1;
+    
+    for (uint8_t i = 0; i < telemetry_record_length; i++)
+    {
+        if (telemetry_record[i] == 0)
+        {
+            frame[code_index] = code;
+            code_index = frame_length++;
+            code = 1;
+        }
+        else
+        {
+            frame[frame_length++] = telemetry_record[i];
+            code++;
+        }
+    }
+    frame[code_index] = code;
+    
+    frame[frame_length++] = 0;
+    
+    UART0_Write_DMA(frame, frame_length);
+}
+
+void Telemetry_Send_Session_Header(uint16_t total_rounds, uint8_t game_mode, uint8_t player_count,
+                                   uint32_t start_time_us)
+{
+    Telemetry_Begin(TELEMETRY_SESSION_HEADER);
+    Telemetry_Put_U8(TELEMETRY_VERSION);
+    Telemetry_Put_U16(total_rounds);
+    Telemetry_Put_U8(game_mode);
+    Telemetry_Put_U8(player_count);
+    Telemetry_Put_U32(start_time_us);
+    Telemetry_End();
+}
+
+void Telemetry_Send_Round(uint16_t round_index, uint8_t player, uint8_t stimulus, uint8_t result,
+                          uint16_t foreperiod_ms, uint32_t onset_time_us, uint32_t reaction_time_us)
+{
+    Telemetry_Begin(TELEMETRY_ROUND);
+    Telemetry_Put_U16(round_index);
+    Telemetry_Put_U8(player);
+    Telemetry_Put_U8(stimulus);
+    Telemetry_Put_U8(result);
+    Telemetry_Put_U16(foreperiod_ms);
+    Telemetry_Put_U32(onset_time_us);
+    Telemetry_Put_U32(reaction_time_us);
+    Telemetry_End();
+}
+
+void Telemetry_Send_Session_End(uint16_t rounds_completed, uint8_t aborted)
+{
+    Telemetry_Begin(TELEMETRY_SESSION_END);
+    Telemetry_Put_U16(rounds_completed);
+    Telemetry_Put_U8(aborted);
+    Telemetry_End();
+}
+
+uint16_t Telemetry_CRC16(const uint8_t *data, uint16_t length)
+{
+    // CRC-16/CCITT-FALSE, bitwise (records are short, so no lookup table is needed)
+    uint16_t crc = 0xFFFF;
+    
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    
+    return crc;
+}
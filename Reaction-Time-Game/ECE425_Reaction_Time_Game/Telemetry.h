@@ -0,0 +1,45 @@
+/**
+ * @file Telemetry.h
+ *
+ * @brief Header file for the binary telemetry stream.
+ *
+ * This file contains the record definitions and function prototypes for the telemetry
+ * stream. Each record is sent over UART0 as one frame:
+ *
+ *   0x00 | COBS( type | sequence | payload | CRC16 ) | 0x00
+ *
+ * Multi-byte fields are little-endian. The sequence number counts every frame since reset,
+ * so a gap in the sequence marks a dropped frame. The CRC16 is CRC-16/CCITT-FALSE
+ * (polynomial 0x1021, initial value 0xFFFF) over the type, sequence and payload bytes.
+ * COBS removes every 0x00 from the frame, so the delimiters separate frames from each
+ * other and from any text on the same link.
+ *
+ * @note Host/Telemetry_Decode.c decodes the stream into CSV or JSON.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+
+// Stream format version, sent in every session header
+#define TELEMETRY_VERSION           4
+
+// Record types
+#define TELEMETRY_SESSION_HEADER    0x01    // version (1), total rounds (2), game mode (1),
+                                            // players (1), session start time in us (4)
+#define TELEMETRY_ROUND             0x02    // round index (2), player (1), stimulus code (1),
+                                            // result code (1), foreperiod in ms (2),
+                                            // onset time in us (4), reaction time in us (4);
+                                            // one record per player
+#define TELEMETRY_SESSION_END       0x03    // rounds completed (2), aborted (1)
+
+// Largest record before framing: type (1) + sequence (2) + payload (15) + CRC16 (2)
+#define TELEMETRY_MAX_RECORD_SIZE   20
+
+// Function Prototypes
+void Telemetry_Send_Session_Header(uint16_t total_rounds, uint8_t game_mode, uint8_t player_count,
+                                   uint32_t start_time_us);
+void Telemetry_Send_Round(uint16_t round_index, uint8_t player, uint8_t stimulus, uint8_t result,
+                          uint16_t foreperiod_ms, uint32_t onset_time_us, uint32_t reaction_time_us);
+void Telemetry_Send_Session_End(uint16_t rounds_completed, uint8_t aborted);
+uint16_t Telemetry_CRC16(const uint8_t *data, uint16_t length);
@@ -0,0 +1,137 @@
+/**
+ * @file Timer_0A_Capture.c
+ *
+ * @brief Source code for the Timer 0A Input Edge-Time Capture driver.
+ *
+ * This file contains the function definitions for the Timer 0A capture driver.
+ *
+ * Timer 0A Configuration:
+ *  - Mode: 16-bit Input Edge-Time, count down, with the 8-bit prescaler as a counter extension
+ *  - Range: 24 bits (0xFFFFFF ticks, about 0.21 s at 80 MHz) extended in software on every time-out
+ *  - Event: Both edges on T0CCP0 (PF0 / SW2), so press and release edges are both timestamped
+ *  - Interrupts: Time-out (always on) and Capture Event (armed by Timer_0A_Capture_Enable)
+ *
+ * The configuration, interrupt priority and handler are the same as Timer 2A (SW1), so both
+ * buttons are captured with the same latency. The press edge itself is latched by the
+ * hardware, so neither handler's position in the interrupt order changes a timestamp.
+ *
+ * Timebase Synchronization:
+ *  - After both timers are running, writing the SYNCT0 and SYNCT2 fields of the GPTM SYNC
+ *    register (in Timer 0) reloads Timer 0A and Timer 2A in the same clock cycle
+ *  - Both timers then count in lockstep and take the same time-outs, so their extended
+ *    tick counts are equal and captures on SW1 and SW2 compare to a single clock cycle
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Timer_0A_Capture.h"
+#include "Profile.h"
+#include "HAL.h"
+
+// Timer 0A Bit Masks
+#define TIMER_0A_TATO_BIT_MASK    0x01    // Time-out interrupt
+#define TIMER_0A_CAE_BIT_MASK     0x04    // Capture event interrupt
+
+// Counter values above this point are treated as "just reloaded" when a time-out is pending
+#define TIMER_0A_HALF_RANGE       0x00800000
+
+// Number of 24-bit counter wraps since initialization
+static volatile uint32_t timer_0A_wraps = 0;
+
+// Pointer to the user-defined task executed on every capture event
+static void (*Timer_0A_Task)(uint64_t capture_ticks);
+
+static uint64_t Timer_0A_Elapsed_Ticks(uint32_t wraps, uint32_t counter_value)
+{
+    // Elapsed ticks = (wraps * 2^24) + (ticks counted down since the last reload)
+    return ((uint64_t)wraps << 24) + (TIMER_0A_COUNTER_MASK - (counter_value & TIMER_0A_COUNTER_MASK));
+}
+
+void Timer_0A_Capture_Init(void (*task)(uint64_t capture_ticks))
+{
+    // Stores the user-defined task function
+    Timer_0A_Task = task;
+    
+    // Enables the clock to Timer 0 by setting the R0 bit (Bit 0) in the RCGCTIMER register
+    SYSCTL->RCGCTIMER |= 0x01;
+    
+    // Waits for the clock to stabilize
+    while ((SYSCTL->PRTIMER & 0x01) == 0);
+    
+    // Disables Timer 0A before configuration by clearing the TAEN bit (Bit 0) in the CTL register
+    TIMER0->CTL &= ~0x01;
+    
+    // Selects the 16-bit timer configuration by writing 0x4 to the CFG register
+    TIMER0->CFG = 0x4;
+    
+    // Configures Timer 0A for Capture mode (TAMR = 0x3), Edge-Time mode (TACMR = 1),
+    // and counting down (TACDIR = 0)
+    TIMER0->TAMR = 0x07;
+    
+    // Captures on both edges by writing 0x3 to the TAEVENT field (Bits 3 to 2)
+    TIMER0->CTL |= 0x0C;
+    
+    // Uses the prescaler as an 8-bit extension of the 16-bit counter (24 bits total)
+    TIMER0->TAILR = 0xFFFF;
+    TIMER0->TAPR = 0xFF;
+    
+    // Clears any pending interrupts and enables the time-out interrupt used to extend the timebase
+    TIMER0->ICR = TIMER_0A_TATO_BIT_MASK | TIMER_0A_CAE_BIT_MASK;
+    TIMER0->IMR = TIMER_0A_TATO_BIT_MASK;
+    
+    // Enables the Timer 0A interrupt (IRQ 19) in NVIC
+    NVIC->ISER[0] |= 1 << 19;
+    
+    // Starts Timer 0A
+    TIMER0->CTL |= 0x01;
+    
+    // Reloads Timer 0A and Timer 2A together by writing 0x1 (Timer A time-out) to the
+    // SYNCT0 field (Bits 1 to 0) and the SYNCT2 field (Bits 5 to 4) of the SYNC register
+    TIMER0->SYNC = 0x11;
+}
+
+void Timer_0A_Capture_Enable(void)
+{
+    // Discards any edge latched while the capture was disarmed
+    TIMER0->ICR = TIMER_0A_CAE_BIT_MASK;
+    TIMER0->IMR |= TIMER_0A_CAE_BIT_MASK;
+}
+
+void Timer_0A_Capture_Disable(void)
+{
+    TIMER0->IMR &= ~TIMER_0A_CAE_BIT_MASK;
+}
+
+// Timer 0A Interrupt Handler - extends the timebase and delivers capture events
+void Timer0A_Handler(void)
+{
+    PROFILE_START(profile_start);
+    uint32_t status = TIMER0->MIS;
+    uint32_t wraps = timer_0A_wraps;
+    uint32_t capture_wraps = wraps;
+    
+    if (status & TIMER_0A_TATO_BIT_MASK)
+    {
+        TIMER0->ICR = TIMER_0A_TATO_BIT_MASK;
+        timer_0A_wraps = wraps + 1;
+    }
+    
+    if (status & TIMER_0A_CAE_BIT_MASK)
+    {
+        TIMER0->ICR = TIMER_0A_CAE_BIT_MASK;
+        uint32_t capture_value = TIMER0->TAR & TIMER_0A_COUNTER_MASK;
+        
+        // If the counter wrapped in the same interrupt, a capture near the top of the range
+        // was latched after the reload and belongs to the new wrap
+        if ((status & TIMER_0A_TATO_BIT_MASK) && (capture_value > TIMER_0A_HALF_RANGE))
+        {
+            capture_wraps = wraps + 1;
+        }
+        
+        if (Timer_0A_Task)
+        {
+            (*Timer_0A_Task)(Timer_0A_Elapsed_Ticks(capture_wraps, capture_value));
+        }
+    }
+    PROFILE_STOP(profile_start, PROFILE_TIMER_0A_HANDLER);
+}
@@ -0,0 +1,28 @@
+/**
+ * @file Timer_0A_Capture.h
+ *
+ * @brief Header file for the Timer 0A Input Edge-Time Capture driver.
+ *
+ * This file contains the function prototypes and definitions for the Timer 0A
+ * capture driver. Timer 0A latches the SW2 (PF0 / T0CCP0) edges in hardware for
+ * the second player in two-player mode. It is configured exactly like Timer 2A
+ * and synchronized with it, so its timestamps are in the Timer 2A timebase.
+ *
+ * @note Timer_2A_Capture_Init must be called first.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+#include "System_Clock.h"
+
+// Timer 0A tick rate (SYSTEM_CLOCK_HZ / 1,000,000, see System_Clock.h)
+#define TIMER_0A_TICKS_PER_US    SYSTEM_CLOCK_TICKS_PER_US
+
+// Timer 0A counts down through the full 24-bit range (16-bit counter + 8-bit prescaler)
+#define TIMER_0A_COUNTER_MASK    0x00FFFFFF
+
+// Function Prototypes
+void Timer_0A_Capture_Init(void (*task)(uint64_t capture_ticks));
+void Timer_0A_Capture_Enable(void);
+void Timer_0A_Capture_Disable(void);
@@ -0,0 +1,83 @@
+/**
+ * @file Timer_1A_OneShot.c
+ *
+ * @brief Source code for the Timer 1A One-Shot driver.
+ *
+ * This file contains the function definitions for the Timer 1A one-shot driver.
+ *
+ * Timer 1A Configuration:
+ *  - Mode: 32-bit One-Shot, count down
+ *  - Interrupt: Time-out, which calls the user-defined task once per start
+ *
+ * Timer_1A_OneShot_Start may be called from another interrupt handler of the same
+ * priority, since the Timer 1A interrupt cannot preempt it.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Timer_1A_OneShot.h"
+#include "Profile.h"
+#include "HAL.h"
+
+// Timer 1A Bit Masks
+#define TIMER_1A_TATO_BIT_MASK    0x01    // Time-out interrupt
+
+// Pointer to the user-defined task executed when the one-shot expires
+static void (*Timer_1A_Task)(void);
+
+void Timer_1A_OneShot_Init(void (*task)(void))
+{
+    // Stores the user-defined task function
+    Timer_1A_Task = task;
+    
+    // Enables the clock to Timer 1 by setting the R1 bit (Bit 1) in the RCGCTIMER register
+    SYSCTL->RCGCTIMER |= 0x02;
+    
+    // Waits for the clock to stabilize
+    while ((SYSCTL->PRTIMER & 0x02) == 0);
+    
+    // Disables Timer 1A before configuration by clearing the TAEN bit (Bit 0) in the CTL register
+    TIMER1->CTL &= ~0x01;
+    
+    // Selects the 32-bit timer configuration by writing 0x0 to the CFG register
+    TIMER1->CFG = 0x0;
+    
+    // Configures Timer 1A for One-Shot mode (TAMR = 0x1), counting down (TACDIR = 0)
+    TIMER1->TAMR = 0x01;
+    
+    // Clears any pending time-out and enables the time-out interrupt
+    TIMER1->ICR = TIMER_1A_TATO_BIT_MASK;
+    TIMER1->IMR = TIMER_1A_TATO_BIT_MASK;
+    
+    // Enables the Timer 1A interrupt (IRQ 21) in NVIC
+    NVIC->ISER[0] |= 1 << 21;
+}
+
+void Timer_1A_OneShot_Start(uint32_t duration_us)
+{
+    // Restarts the count from the new load value
+    TIMER1->CTL &= ~0x01;
+    TIMER1->ICR = TIMER_1A_TATO_BIT_MASK;
+    TIMER1->TAILR = (duration_us * TIMER_1A_TICKS_PER_US) - 1;
+    TIMER1->CTL |= 0x01;
+}
+
+void Timer_1A_OneShot_Stop(void)
+{
+    // Disables Timer 1A and discards a time-out that has not been serviced yet
+    TIMER1->CTL &= ~0x01;
+    TIMER1->ICR = TIMER_1A_TATO_BIT_MASK;
+}
+
+// Timer 1A Interrupt Handler - runs the user-defined task when the one-shot expires
+void Timer1A_Handler(void)
+{
+    PROFILE_START(profile_start);
+    TIMER1->ICR = TIMER_1A_TATO_BIT_MASK;
+    
+    if (Timer_1A_Task)
+    {
+        (*Timer_1A_Task)();
+    }
+    PROFILE_STOP(profile_start, PROFILE_TIMER_1A_HANDLER);
+}
@@ -0,0 +1,22 @@
+/**
+ * @file Timer_1A_OneShot.h
+ *
+ * @brief Header file for the Timer 1A One-Shot driver.
+ *
+ * This file contains the function prototypes and definitions for the Timer 1A
+ * one-shot driver. Timer 1A times the button debounce lockout windows and calls a
+ * user-defined task when the earliest window expires.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+#include "System_Clock.h"
+
+// Timer 1A tick rate (SYSTEM_CLOCK_HZ / 1,000,000, see System_Clock.h)
+#define TIMER_1A_TICKS_PER_US    SYSTEM_CLOCK_TICKS_PER_US
+
+// Function Prototypes
+void Timer_1A_OneShot_Init(void (*task)(void));
+void Timer_1A_OneShot_Start(uint32_t duration_us);
+void Timer_1A_OneShot_Stop(void);
@@ -0,0 +1,167 @@
+/**
+ * @file Timer_2A_Capture.c
+ *
+ * @brief Source code for the Timer 2A Input Edge-Time Capture driver.
+ *
+ * This file contains the function definitions for the Timer 2A capture driver.
+ *
+ * Timer 2A Configuration:
+ *  - Mode: 16-bit Input Edge-Time, count down, with the 8-bit prescaler as a counter extension
+ *  - Range: 24 bits (0xFFFFFF ticks, about 0.21 s at 80 MHz) extended in software on every time-out
+ *  - Event: Both edges on T2CCP0 (PF4 / SW1), so press and release edges are both timestamped
+ *  - Interrupts: Time-out (always on) and Capture Event (armed by Timer_2A_Capture_Enable)
+ *
+ * The free-running value (TAV) and the captured value (TAR) come from the same counter,
+ * so the stimulus onset and the press edge share one timebase. The press is latched by
+ * the hardware at the edge, so interrupt entry latency does not add to the result.
+ * Timer 0A captures SW2 with the same configuration and is restarted in the same clock
+ * cycle as Timer 2A (see Timer_0A_Capture.c), so the two timebases count in lockstep.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Timer_2A_Capture.h"
+#include "Profile.h"
+#include "HAL.h"
+
+// Timer 2A Bit Masks
+#define TIMER_2A_TATO_BIT_MASK    0x01    // Time-out interrupt
+#define TIMER_2A_CAE_BIT_MASK     0x04    // Capture event interrupt
+
+// Counter values above this point are treated as "just reloaded" when a time-out is pending
+#define TIMER_2A_HALF_RANGE       0x00800000
+
+// Number of 24-bit counter wraps since initialization
+static volatile uint32_t timer_2A_wraps = 0;
+
+// Pointer to the user-defined task executed on every capture event
+static void (*Timer_2A_Task)(uint64_t capture_ticks);
+
+static uint64_t Timer_2A_Elapsed_Ticks(uint32_t wraps, uint32_t counter_value)
+{
+    // Elapsed ticks = (wraps * 2^24) + (ticks counted down since the last reload)
+    return ((uint64_t)wraps << 24) + (TIMER_2A_COUNTER_MASK - (counter_value & TIMER_2A_COUNTER_MASK));
+}
+
+void Timer_2A_Capture_Init(void (*task)(uint64_t capture_ticks))
+{
+    // Stores the user-defined task function
+    Timer_2A_Task = task;
+    
+    // Enables the clock to Timer 2 by setting the R2 bit (Bit 2) in the RCGCTIMER register
+    SYSCTL->RCGCTIMER |= 0x04;
+    
+    // Waits for the clock to stabilize
+    while ((SYSCTL->PRTIMER & 0x04) == 0);
+    
+    // Disables Timer 2A before configuration by clearing the TAEN bit (Bit 0) in the CTL register
+    TIMER2->CTL &= ~0x01;
+    
+    // Selects the 16-bit timer configuration by writing 0x4 to the CFG register
+    TIMER2->CFG = 0x4;
+    
+    // Configures Timer 2A for Capture mode (TAMR = 0x3), Edge-Time mode (TACMR = 1),
+    // and counting down (TACDIR = 0)
+    TIMER2->TAMR = 0x07;
+    
+    // Captures on both edges by writing 0x3 to the TAEVENT field (Bits 3 to 2)
+    TIMER2->CTL |= 0x0C;
+    
+    // Uses the prescaler as an 8-bit extension of the 16-bit counter (24 bits total)
+    TIMER2->TAILR = 0xFFFF;
+    TIMER2->TAPR = 0xFF;
+    
+    // Clears any pending interrupts and enables the time-out interrupt used to extend the timebase
+    TIMER2->ICR = TIMER_2A_TATO_BIT_MASK | TIMER_2A_CAE_BIT_MASK;
+    TIMER2->IMR = TIMER_2A_TATO_BIT_MASK;
+    
+    // Enables the Timer 2A interrupt (IRQ 23) in NVIC
+    NVIC->ISER[0] |= 1 << 23;
+    
+    // Starts Timer 2A
+    TIMER2->CTL |= 0x01;
+}
+
+void Timer_2A_Capture_Enable(void)
+{
+    // Discards any edge latched while the capture was disarmed
+    TIMER2->ICR = TIMER_2A_CAE_BIT_MASK;
+    TIMER2->IMR |= TIMER_2A_CAE_BIT_MASK;
+}
+
+void Timer_2A_Capture_Disable(void)
+{
+    TIMER2->IMR &= ~TIMER_2A_CAE_BIT_MASK;
+}
+
+uint64_t Timer_2A_Get_Time_Ticks(void)
+{
+    uint32_t wraps;
+    uint32_t counter_value;
+    
+    // Re-reads if the time-out interrupt updated the wrap count in the middle of the read
+    do
+    {
+        wraps = timer_2A_wraps;
+        counter_value = TIMER2->TAV & TIMER_2A_COUNTER_MASK;
+    } while (wraps != timer_2A_wraps);
+    
+    // A pending time-out with a freshly reloaded counter has not been counted yet
+    if ((TIMER2->RIS & TIMER_2A_TATO_BIT_MASK) && (counter_value > TIMER_2A_HALF_RANGE))
+    {
+        wraps++;
+    }
+    
+    return Timer_2A_Elapsed_Ticks(wraps, counter_value);
+}
+
+uint64_t Timer_2A_Get_Time_Ticks_At(uint32_t counter_value)
+{
+    uint64_t now = Timer_2A_Get_Time_Ticks();
+    uint32_t elapsed_low = TIMER_2A_COUNTER_MASK - (counter_value & TIMER_2A_COUNTER_MASK);
+    
+    // Signed 24-bit distance from the counter value to now, so values up to half the range
+    // on either side of now are placed correctly
+    int32_t distance = (int32_t)((((uint32_t)now - elapsed_low) & TIMER_2A_COUNTER_MASK) << 8) >> 8;
+    
+    return now - (uint64_t)(int64_t)distance;
+}
+
+uint32_t Timer_2A_Get_Time_Us(void)
+{
+    return (uint32_t)(Timer_2A_Get_Time_Ticks() / TIMER_2A_TICKS_PER_US);
+}
+
+// Timer 2A Interrupt Handler - extends the timebase and delivers capture events
+void Timer2A_Handler(void)
+{
+    PROFILE_START(profile_start);
+    uint32_t status = TIMER2->MIS;
+    uint32_t wraps = timer_2A_wraps;
+    uint32_t capture_wraps = wraps;
+    
+    if (status & TIMER_2A_TATO_BIT_MASK)
+    {
+        TIMER2->ICR = TIMER_2A_TATO_BIT_MASK;
+        timer_2A_wraps = wraps + 1;
+    }
+    
+    if (status & TIMER_2A_CAE_BIT_MASK)
+    {
+        TIMER2->ICR = TIMER_2A_CAE_BIT_MASK;
+        uint32_t capture_value = TIMER2->TAR & TIMER_2A_COUNTER_MASK;
+        
+        // If the counter wrapped in the same interrupt, a capture near the top of the range
+        // was latched after the reload and belongs to the new wrap
+        if ((status & TIMER_2A_TATO_BIT_MASK) && (capture_value > TIMER_2A_HALF_RANGE))
+        {
+            capture_wraps = wraps + 1;
+        }
+        
+        if (Timer_2A_Task)
+        {
+            (*Timer_2A_Task)(Timer_2A_Elapsed_Ticks(capture_wraps, capture_value));
+        }
+    }
+    PROFILE_STOP(profile_start, PROFILE_TIMER_2A_HANDLER);
+}
@@ -0,0 +1,30 @@
+/**
+ * @file Timer_2A_Capture.h
+ *
+ * @brief Header file for the Timer 2A Input Edge-Time Capture driver.
+ *
+ * This file contains the function prototypes and definitions for the Timer 2A
+ * capture driver. Timer 2A latches the SW1 (PF4 / T2CCP0) edges in hardware
+ * and also serves as the timebase for stimulus onset stamping. Timestamps are
+ * 64-bit tick counts (one tick per system clock cycle). Timers restarted in lockstep
+ * with Timer 2A share its timebase through Timer_2A_Get_Time_Ticks_At.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+#include "System_Clock.h"
+
+// Timer 2A tick rate (SYSTEM_CLOCK_HZ / 1,000,000, see System_Clock.h)
+#define TIMER_2A_TICKS_PER_US    SYSTEM_CLOCK_TICKS_PER_US
+
+// Timer 2A counts down through the full 24-bit range (16-bit counter + 8-bit prescaler)
+#define TIMER_2A_COUNTER_MASK    0x00FFFFFF
+
+// Function Prototypes
+void Timer_2A_Capture_Init(void (*task)(uint64_t capture_ticks));
+void Timer_2A_Capture_Enable(void);
+void Timer_2A_Capture_Disable(void);
+uint64_t Timer_2A_Get_Time_Ticks(void);
+uint64_t Timer_2A_Get_Time_Ticks_At(uint32_t counter_value);    // For timers in lockstep with Timer 2A
+uint32_t Timer_2A_Get_Time_Us(void);
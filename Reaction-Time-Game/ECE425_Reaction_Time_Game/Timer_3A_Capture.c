@@ -0,0 +1,82 @@
+/**
+ * @file Timer_3A_Capture.c
+ *
+ * @brief Source code for the Timer 3A Input Edge-Time Capture driver.
+ *
+ * This file contains the function definitions for the Timer 3A capture driver.
+ *
+ * Timer 3A Configuration:
+ *  - Mode: 16-bit Input Edge-Time, count down, with the 8-bit prescaler as a counter extension
+ *  - Event: Both edges on T3CCP0 (PB2, the calibration loopback input)
+ *  - Interrupts: none, the Capture Event raw status is polled
+ *
+ * Timebase Synchronization:
+ *  - Writing the SYNCT0, SYNCT2 and SYNCT3 fields of the GPTM SYNC register reloads
+ *    Timer 0A, Timer 2A and Timer 3A in the same clock cycle
+ *  - Timer 0A and Timer 2A each take one extra time-out from the reload, so they stay in
+ *    lockstep with each other, and Timer 3A then holds the low 24 bits of their tick count
+ *  - Timer 3A does not count its own wraps: a capture read within half the counter range
+ *    (about 0.1 s) is placed in the Timer 2A timebase by Timer_2A_Get_Time_Ticks_At
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include "Timer_3A_Capture.h"
+#include "HAL.h"
+
+// Timer 3A Bit Masks
+#define TIMER_3A_TATO_BIT_MASK    0x01    // Time-out interrupt
+#define TIMER_3A_CAE_BIT_MASK     0x04    // Capture event interrupt
+
+void Timer_3A_Capture_Init(void)
+{
+    // Enables the clock to Timer 3 by setting the R3 bit (Bit 3) in the RCGCTIMER register
+    SYSCTL->RCGCTIMER |= 0x08;
+    
+    // Waits for the clock to stabilize
+    while ((SYSCTL->PRTIMER & 0x08) == 0);
+    
+    // Disables Timer 3A before configuration by clearing the TAEN bit (Bit 0) in the CTL register
+    TIMER3->CTL &= ~0x01;
+    
+    // Selects the 16-bit timer configuration by writing 0x4 to the CFG register
+    TIMER3->CFG = 0x4;
+    
+    // Configures Timer 3A for Capture mode (TAMR = 0x3), Edge-Time mode (TACMR = 1),
+    // and counting down (TACDIR = 0)
+    TIMER3->TAMR = 0x07;
+    
+    // Captures on both edges by writing 0x3 to the TAEVENT field (Bits 3 to 2)
+    TIMER3->CTL |= 0x0C;
+    
+    // Uses the prescaler as an 8-bit extension of the 16-bit counter (24 bits total)
+    TIMER3->TAILR = 0xFFFF;
+    TIMER3->TAPR = 0xFF;
+    
+    // Masks all Timer 3A interrupts, since the capture is polled
+    TIMER3->IMR = 0;
+    
+    // Starts Timer 3A
+    TIMER3->CTL |= 0x01;
+    
+    // Reloads Timer 0A, Timer 2A and Timer 3A together by writing 0x1 (Timer A time-out) to the
+    // SYNCT0 field (Bits 1 to 0), the SYNCT2 field (Bits 5 to 4) and the SYNCT3 field (Bits 7 to 6)
+    // of the SYNC register
+    TIMER0->SYNC = 0x51;
+    
+    // Discards the time-out from the reload and any edge latched during configuration
+    TIMER3->ICR = TIMER_3A_TATO_BIT_MASK | TIMER_3A_CAE_BIT_MASK;
+}
+
+uint8_t Timer_3A_Capture_Read(uint32_t *counter_value)
+{
+    // Checks the CAERIS bit (Bit 2) in the RIS register for a latched edge
+    if ((TIMER3->RIS & TIMER_3A_CAE_BIT_MASK) == 0)
+    {
+        return 0;
+    }
+    
+    *counter_value = TIMER3->TAR & TIMER_3A_COUNTER_MASK;
+    TIMER3->ICR = TIMER_3A_CAE_BIT_MASK;
+    return 1;
+}
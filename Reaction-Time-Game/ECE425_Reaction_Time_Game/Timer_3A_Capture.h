@@ -0,0 +1,26 @@
+/**
+ * @file Timer_3A_Capture.h
+ *
+ * @brief Header file for the Timer 3A Input Edge-Time Capture driver.
+ *
+ * This file contains the function prototypes and definitions for the Timer 3A
+ * capture driver. Timer 3A latches the edges of the calibration loopback input
+ * (PB2 / T3CCP0). It is configured like Timer 2A and counts in lockstep with it,
+ * so a captured counter value converts to the Timer 2A timebase with
+ * Timer_2A_Get_Time_Ticks_At.
+ *
+ * @note Timer_0A_Capture_Init must be called first. The capture is polled rather than
+ * interrupt-driven, since the latency calibration reads it right after driving the edge.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stdint.h>
+#include "System_Clock.h"
+
+// Timer 3A counts down through the full 24-bit range (16-bit counter + 8-bit prescaler)
+#define TIMER_3A_COUNTER_MASK    0x00FFFFFF
+
+// Function Prototypes
+void Timer_3A_Capture_Init(void);
+uint8_t Timer_3A_Capture_Read(uint32_t *counter_value);    // Returns 1 when an edge was latched
@@ -0,0 +1,231 @@
+/**
+ * @file Timer_Wheel.c
+ *
+ * @brief Source code for the software timer wheel.
+ *
+ * This file contains the function definitions for the software timer wheel.
+ *
+ * @note Timers must only be started, stopped and processed from the main loop.
+ *
+ * Timer Wheel Configuration:
+ *  - Level 0: 256 slots of 1 ms (deadlines less than 256 ms away)
+ *  - Level 1: 64 slots of 256 ms (deadlines up to about 16 s away)
+ *  - Level 2: 64 slots of 16.384 s (deadlines up to about 17 minutes away)
+ *  - Overflow list for anything further out, re-examined every level 2 rotation
+ *
+ * Starting or stopping a timer is O(1). When the wheel reaches the start of a level 1 or
+ * level 2 slot, the timers in that slot are cascaded down to the finer level, so each timer
+ * is moved at most a few times before it expires.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#include <stddef.h>
+#include "Timer_Wheel.h"
+#include "SysTick_Delay.h"
+
+#define LEVEL_0_BITS      8
+#define LEVEL_N_BITS      6
+#define LEVEL_0_SIZE      (1 << LEVEL_0_BITS)
+#define LEVEL_N_SIZE      (1 << LEVEL_N_BITS)
+#define LEVEL_0_MASK      (LEVEL_0_SIZE - 1)
+#define LEVEL_N_MASK      (LEVEL_N_SIZE - 1)
+#define LEVEL_1_SHIFT     LEVEL_0_BITS
+#define LEVEL_2_SHIFT     (LEVEL_0_BITS + LEVEL_N_BITS)
+
+// Timer wheel slots
+static Soft_Timer *wheel_level_0[LEVEL_0_SIZE];
+static Soft_Timer *wheel_level_1[LEVEL_N_SIZE];
+static Soft_Timer *wheel_level_2[LEVEL_N_SIZE];
+static Soft_Timer *wheel_overflow;
+
+// Last millisecond processed by the wheel
+static uint64_t wheel_time = 0;
+
+static void Timer_Wheel_Link(Soft_Timer **slot, Soft_Timer *timer)
+{
+    timer->next = *slot;
+    timer->previous_next = slot;
+    
+    if (*slot)
+    {
+        (*slot)->previous_next = &timer->next;
+    }
+    *slot = timer;
+}
+
+static void Timer_Wheel_Unlink(Soft_Timer *timer)
+{
+    *timer->previous_next = timer->next;
+    
+    if (timer->next)
+    {
+        timer->next->previous_next = timer->previous_next;
+    }
+    timer->next = NULL;
+    timer->previous_next = NULL;
+}
+
+// Places a timer in the finest level that can hold its deadline
+static void Timer_Wheel_Insert(Soft_Timer *timer)
+{
+    uint64_t expiry = timer->expiry_ms;
+    
+    if ((expiry - wheel_time) < LEVEL_0_SIZE)
+    {
+        Timer_Wheel_Link(&wheel_level_0[expiry & LEVEL_0_MASK], timer);
+    }
+    else if (((expiry >> LEVEL_1_SHIFT) - (wheel_time >> LEVEL_1_SHIFT)) <= LEVEL_N_SIZE)
+    {
+        Timer_Wheel_Link(&wheel_level_1[(expiry >> LEVEL_1_SHIFT) & LEVEL_N_MASK], timer);
+    }
+    else if (((expiry >> LEVEL_2_SHIFT) - (wheel_time >> LEVEL_2_SHIFT)) <= LEVEL_N_SIZE)
+    {
+        Timer_Wheel_Link(&wheel_level_2[(expiry >> LEVEL_2_SHIFT) & LEVEL_N_MASK], timer);
+    }
+    else
+    {
+        Timer_Wheel_Link(&wheel_overflow, timer);
+    }
+}
+
+// Earliest deadline in a slot, or the given bound if none is earlier
+static uint64_t Timer_Wheel_Earliest(Soft_Timer *timer, uint64_t earliest)
+{
+    for (; timer; timer = timer->next)
+    {
+        if (timer->expiry_ms < earliest)
+        {
+            earliest = timer->expiry_ms;
+        }
+    }
+    return earliest;
+}
+
+// Moves every timer in a slot down to the level that now fits its deadline
+static void Timer_Wheel_Cascade(Soft_Timer **slot)
+{
+    Soft_Timer *timer = *slot;
+    *slot = NULL;
+    
+    while (timer)
+    {
+        Soft_Timer *next = timer->next;
+        Timer_Wheel_Insert(timer);
+        timer = next;
+    }
+}
+
+void Timer_Wheel_Init(void)
+{
+    for (uint16_t i = 0; i < LEVEL_0_SIZE; i++)
+    {
+        wheel_level_0[i] = NULL;
+    }
+    
+    for (uint8_t i = 0; i < LEVEL_N_SIZE; i++)
+    {
+        wheel_level_1[i] = NULL;
+        wheel_level_2[i] = NULL;
+    }
+    
+    wheel_overflow = NULL;
+    wheel_time = SysTick_Get_Time_Ms64();
+}
+
+void Timer_Wheel_Start(Soft_Timer *timer, uint32_t delay_ms, uint32_t period_ms, void (*task)(void))
+{
+    // Restarting an active timer moves its deadline
+    Timer_Wheel_Stop(timer);
+    
+    timer->expiry_ms = SysTick_Get_Time_Ms64() + delay_ms;
+    timer->period_ms = period_ms;
+    timer->task = task;
+    
+    // A deadline in a millisecond the wheel has already processed expires on the next one
+    if (timer->expiry_ms <= wheel_time)
+    {
+        timer->expiry_ms = wheel_time + 1;
+    }
+    
+    Timer_Wheel_Insert(timer);
+}
+
+void Timer_Wheel_Stop(Soft_Timer *timer)
+{
+    if (timer->previous_next)
+    {
+        Timer_Wheel_Unlink(timer);
+    }
+}
+
+uint8_t Timer_Wheel_Is_Active(Soft_Timer *timer)
+{
+    return timer->previous_next != NULL;
+}
+
+uint64_t Timer_Wheel_Next_Expiry(void)
+{
+    // Visits every slot, so it is meant for entering deep sleep rather than every loop
+    uint64_t earliest = Timer_Wheel_Earliest(wheel_overflow, UINT64_MAX);
+    
+    for (uint16_t i = 0; i < LEVEL_0_SIZE; i++)
+    {
+        earliest = Timer_Wheel_Earliest(wheel_level_0[i], earliest);
+    }
+    
+    for (uint8_t i = 0; i < LEVEL_N_SIZE; i++)
+    {
+        earliest = Timer_Wheel_Earliest(wheel_level_1[i], earliest);
+        earliest = Timer_Wheel_Earliest(wheel_level_2[i], earliest);
+    }
+    
+    return earliest;
+}
+
+void Timer_Wheel_Process(void)
+{
+    uint64_t now = SysTick_Get_Time_Ms64();
+    
+    // Catches up one millisecond at a time if the main loop fell behind
+    while (wheel_time < now)
+    {
+        wheel_time++;
+        
+        if ((wheel_time & ((1 << LEVEL_2_SHIFT) - 1)) == 0)
+        {
+            if (((wheel_time >> LEVEL_2_SHIFT) & LEVEL_N_MASK) == 0)
+            {
+                Timer_Wheel_Cascade(&wheel_overflow);
+            }
+            Timer_Wheel_Cascade(&wheel_level_2[(wheel_time >> LEVEL_2_SHIFT) & LEVEL_N_MASK]);
+        }
+        
+        if ((wheel_time & LEVEL_0_MASK) == 0)
+        {
+            Timer_Wheel_Cascade(&wheel_level_1[(wheel_time >> LEVEL_1_SHIFT) & LEVEL_N_MASK]);
+        }
+        
+        // Every timer in the current level 0 slot expires now. Timers are removed one at a
+        // time, so tasks may safely start or stop any timer, including the one that expired.
+        Soft_Timer **slot = &wheel_level_0[wheel_time & LEVEL_0_MASK];
+        
+        while (*slot)
+        {
+            Soft_Timer *timer = *slot;
+            Timer_Wheel_Unlink(timer);
+            
+            // Periodic timers are re-armed from their previous deadline so they do not drift
+            if (timer->period_ms > 0)
+            {
+                timer->expiry_ms += timer->period_ms;
+                Timer_Wheel_Insert(timer);
+            }
+            
+            if (timer->task)
+            {
+                (*timer->task)();
+            }
+        }
+    }
+}
@@ -0,0 +1,39 @@
+/**
+ * @file Timer_Wheel.h
+ *
+ * @brief Header file for the software timer wheel.
+ *
+ * This file contains the function prototypes and definitions for the software timer wheel.
+ * Any number of one-shot and periodic timers can be armed against the 64-bit SysTick
+ * clock without busy-waiting. Expired timers run their task from Timer_Wheel_Process,
+ * which is called by the main loop.
+ *
+ * @note Timers must only be started, stopped and processed from the main loop.
+ *
+ * @author Benjamin Nguyen
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+
+// Software timer, allocated by the caller and linked into the wheel while active
+typedef struct Soft_Timer
+{
+    struct Soft_Timer *next;
+    struct Soft_Timer **previous_next;    // Points to the link that points to this timer
+    uint64_t expiry_ms;
+    uint32_t period_ms;                   // 0 for one-shot timers
+    void (*task)(void);
+} Soft_Timer;
+
+// Function Prototypes
+void Timer_Wheel_Init(void);
+void Timer_Wheel_Start(Soft_Timer *timer, uint32_t delay_ms, uint32_t period_ms, void (*task)(void));
+void Timer_Wheel_Stop(Soft_Timer *timer);
+uint8_t Timer_Wheel_Is_Active(Soft_Timer *timer);
+uint64_t Timer_Wheel_Next_Expiry(void);    // Earliest deadline in ms, UINT64_MAX when none is active
+void Timer_Wheel_Process(void);
+
+#endif
@@ -5,21 +5,196 @@
  *
  * This file contains the function definitions for the UART0 driver.
  *
- * @note Assumes that the frequency of the system clock is 50 MHz.
- *
  * UART0 Configuration:
  *  - Baud Rate: 115200
  *  - Data Length: 8 bits
  *  - Stop Bit: 1
  *  - Parity: Disabled
- *  - Clock Source: System Clock / 16
+ *  - Clock Source: PIOSC / 16, so the baud rate holds in deep sleep (CS = 0x5 in UARTCC)
  *  - Pins: PA1 (U0TX), PA0 (U0RX)
+ *  - TX Interrupt: Enabled while the ring buffer holds data (FIFO level 1/8)
+ *  - RX Interrupts: FIFO level 1/2 and receive time-out, always enabled
+ *
+ * Output characters are queued in a ring buffer written only by the main loop (head)
+ * and read only by UART0_Handler (tail). When the ring is full, the configured policy
+ * either waits for space (UART0_TX_POLICY_BLOCK) or drops the character (UART0_TX_POLICY_DROP).
+ *
+ * Received characters are moved by UART0_Handler from the RX FIFO into a second ring
+ * buffer, which the main loop reads. The ring holds UART0_RX_BUFFER_SIZE characters, so
+ * input sent at line rate is kept while the main loop is busy with a long report.
+ * Characters that arrive with the ring full are dropped and counted. Each receive interrupt
+ * also posts a timestamped event with the number of characters it took (see Event_Queue.h).
+ *
+ * Bulk output written with UART0_Write_DMA is copied into one of two staging buffers and
+ * sent by uDMA channel 9, so the core is free while large reports go out at line rate.
+ * Each staged transfer records the ring position at the time it was queued, so ring
+ * and DMA output always leave the UART in the order they were written.
  *
  * @author Benjamin Nguyen
  */
 
+#include <stdarg.h>
+#include <stddef.h>
 #include "UART.h"
-#include "TM4C123GH6PM.h"
+#include "Event_Queue.h"
+#include "Format.h"
+#include "Power.h"
+#include "Profile.h"
+#include "HAL.h"
+
+#define UART0_TX_BUFFER_MASK    (UART0_TX_BUFFER_SIZE - 1)
+#define UART0_RX_BUFFER_MASK    (UART0_RX_BUFFER_SIZE - 1)
+
+// uDMA channel 9 (encoding 0) is the UART0 TX request
+#define UART0_DMA_CHANNEL           9
+#define UART0_DMA_CHANNEL_BIT_MASK  (1 << UART0_DMA_CHANNEL)
+#define UART0_DMA_STAGE_COUNT       2
+
+// uDMA channel control word: 8-bit source increment, fixed destination,
+// arbitration size of 4 transfers, basic transfer mode
+#define UDMA_CONTROL_DSTINC_NONE    0xC0000000
+#define UDMA_CONTROL_ARBSIZE_4      0x00008000
+#define UDMA_CONTROL_XFERMODE_BASIC 0x00000001
+
+// uDMA channel control structure entry
+typedef struct
+{
+    void * volatile Source_End_Pointer;
+    void * volatile Destination_End_Pointer;
+    volatile uint32_t Control_Word;
+    volatile uint32_t Unused;
+} UDMA_Control_Entry;
+
+// DMA staging buffer states
+#define UART0_DMA_STAGE_FREE      0
+#define UART0_DMA_STAGE_PENDING   1
+#define UART0_DMA_STAGE_ACTIVE    2
+
+// DMA staging buffer
+typedef struct
+{
+    volatile char data[UART0_DMA_STAGE_SIZE];
+    volatile uint16_t length;
+    volatile uint8_t state;
+    volatile uint32_t ring_mark;    // Ring head when staged, ring data before it is sent first
+} UART0_DMA_Stage;
+
+// Primary uDMA control table, which must be aligned on a 1024-byte boundary
+static UDMA_Control_Entry udma_control_table[32] __attribute__((aligned(1024)));
+
+// Transmit ring buffer
+static volatile char uart0_tx_buffer[UART0_TX_BUFFER_SIZE];
+static volatile uint32_t uart0_tx_head = 0;
+static volatile uint32_t uart0_tx_tail = 0;
+static volatile uint32_t uart0_tx_dropped = 0;
+static uint8_t uart0_tx_policy = UART0_TX_POLICY_BLOCK;
+
+// Receive ring buffer, written only by UART0_Handler (head) and read only by the main loop (tail)
+static volatile char uart0_rx_buffer[UART0_RX_BUFFER_SIZE];
+static volatile uint32_t uart0_rx_head = 0;
+static volatile uint32_t uart0_rx_tail = 0;
+static volatile uint32_t uart0_rx_dropped = 0;
+
+// Double-buffered DMA staging, filled and sent in alternating order
+static UART0_DMA_Stage uart0_dma_stages[UART0_DMA_STAGE_COUNT];
+static uint8_t uart0_dma_fill_index = 0;
+static volatile uint8_t uart0_dma_send_index = 0;
+
+// Pointer to the user-defined task executed when a DMA transfer completes
+static void (*UART0_DMA_Task)(void);
+
+// Moves characters from the ring buffer into the TX FIFO until the limit or a full FIFO is reached
+static void UART0_Fill_Transmit_FIFO(uint32_t limit)
+{
+    while ((uart0_tx_tail != limit) && ((UART0->FR & UART0_TRANSMIT_FIFO_FULL_BIT_MASK) == 0))
+    {
+        HAL_UART0_Write_Data(uart0_tx_buffer[uart0_tx_tail & UART0_TX_BUFFER_MASK]);
+        uart0_tx_tail++;
+    }
+}
+
+// Starts the uDMA transfer of a staging buffer into the UART0 data register
+static void UART0_Start_DMA(UART0_DMA_Stage *stage)
+{
+    UDMA_Control_Entry *entry = &udma_control_table[UART0_DMA_CHANNEL];
+    
+    entry->Source_End_Pointer = (void *)&stage->data[stage->length - 1];
+    entry->Destination_End_Pointer = (void *)&UART0->DR;
+    entry->Control_Word = UDMA_CONTROL_DSTINC_NONE | UDMA_CONTROL_ARBSIZE_4 |
+                          ((uint32_t)(stage->length - 1) << 4) | UDMA_CONTROL_XFERMODE_BASIC;
+    
+    stage->state = UART0_DMA_STAGE_ACTIVE;
+    UDMA->ENASET = UART0_DMA_CHANNEL_BIT_MASK;
+}
+
+// Advances the transmitter, keeping ring and DMA output in the order it was queued.
+// Must run in UART0_Handler or with the UART0 interrupt masked.
+static void UART0_Service_Transmit(void)
+{
+    UART0_DMA_Stage *stage = &uart0_dma_stages[uart0_dma_send_index];
+    
+    // Ring data queued after the active DMA transfer waits for its completion
+    if (stage->state == UART0_DMA_STAGE_ACTIVE)
+    {
+        UART0->IM &= ~UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+        return;
+    }
+    
+    // Ring data is only drained up to the point where the next DMA transfer was staged
+    uint32_t limit = (stage->state == UART0_DMA_STAGE_PENDING) ? stage->ring_mark : uart0_tx_head;
+    UART0_Fill_Transmit_FIFO(limit);
+    
+    if ((stage->state == UART0_DMA_STAGE_PENDING) && (uart0_tx_tail == limit))
+    {
+        UART0->IM &= ~UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+        UART0_Start_DMA(stage);
+    }
+    else if (uart0_tx_tail != limit)
+    {
+        // The TX interrupt only fires when the FIFO level falls through the
+        // trigger level, so it is enabled after the FIFO has been primed
+        UART0->IM |= UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+    }
+    else
+    {
+        UART0->IM &= ~UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+    }
+}
+
+// Starts draining queued output if the transmitter is idle
+static void UART0_Start_Transmit(void)
+{
+    // Masks the UART0 interrupt (IRQ 5) while the transmitter state is updated
+    NVIC->ICER[0] = 1 << 5;
+    
+    UART0_Service_Transmit();
+    
+    NVIC->ISER[0] = 1 << 5;
+}
+
+// Configures uDMA channel 9 for UART0 TX
+static void UART0_DMA_Init(void)
+{
+    // Enables the clock to the uDMA module and waits for it to stabilize
+    SYSCTL->RCGCDMA |= 0x01;
+    while ((SYSCTL->PRDMA & 0x01) == 0);
+    
+    // Enables the uDMA controller and sets the control table base address
+    UDMA->CFG = 0x01;
+    UDMA->CTLBASE = (uintptr_t)udma_control_table;
+    
+    // Selects encoding 0 (UART0 TX) for channel 9 in the CH9SEL field (Bits 7 to 4) of CHMAP1
+    UDMA->CHMAP1 &= ~0x000000F0;
+    
+    // Uses default priority, the primary control structure, single and burst requests, and unmasked requests
+    UDMA->PRIOCLR = UART0_DMA_CHANNEL_BIT_MASK;
+    UDMA->ALTCLR = UART0_DMA_CHANNEL_BIT_MASK;
+    UDMA->USEBURSTCLR = UART0_DMA_CHANNEL_BIT_MASK;
+    UDMA->REQMASKCLR = UART0_DMA_CHANNEL_BIT_MASK;
+    
+    // Enables TX DMA requests by setting the TXDMAE bit (Bit 1) in the DMACTL register
+    UART0->DMACTL |= 0x02;
+}
 
 void UART0_Init(void)
 {
@@ -35,19 +210,25 @@ void UART0_Init(void)
     // the UARTEN bit (Bit 0) in the CTL register
     UART0->CTL &= ~0x0001;
     
-    // Configures the UART0 module to use the system clock (50 MHz)
+    // Configures the UART0 module to use its clock
     // divided by 16 by clearing the HSE bit (Bit 5) in the CTL register
     UART0->CTL &= ~0x0020;
     
+    // Clocks the UART0 module from the PIOSC by writing 0x5 to the CS field (Bits 3 to 0)
+    // in the CC register. The PIOSC keeps running in deep sleep, while the system clock
+    // drops from the PLL to the deep-sleep clock
+    UART0->CC = 0x05;
+    
     // Sets the baud rate by writing the DIVINT field (Bits 15 to 0)
     // and the DIVFRAC field (Bits 5 to 0) in the IBRD and FBRD registers, respectively.
     // The integer part of the calculated constant will be written to the IBRD register,
     // while the fractional part will be written to the FBRD register.
-    // BRD = (System Clock Frequency) / (16 * Baud Rate)
-    // BRDI = (50,000,000) / (16 * 115200) = 27.12673611 (IBRD = 27)
-    // BRDF = ((0.12673611 * 64 + 0.5) = 8.611 (FBRD = 8)
-    UART0->IBRD = 27;
-    UART0->FBRD = 8;
+    // BRD = (UART Clock Frequency) / (16 * Baud Rate)
+    // BRDI = (16,000,000) / (16 * 115200) = 8.68055556 (IBRD = 8)
+    // BRDF = ((0.68055556 * 64 + 0.5) = 44.056 (FBRD = 44)
+    // Both are computed from UART0_CLOCK_HZ at compile time (see System_Clock.h)
+    UART0->IBRD = UART0_IBRD_VALUE;
+    UART0->FBRD = UART0_FBRD_VALUE;
     
     // Configures the data length to 8 bits by
     // writing 0x3 to WLEN (Bits 6 to 5) in the LCRH register
@@ -63,6 +244,22 @@ void UART0_Init(void)
     // Disables the parity by clearing PEN bit (Bit 1) in the LCRH register
     UART0->LCRH &= ~0x02;
     
+    // Triggers the TX interrupt when the TX FIFO is at or below 1/8 full
+    // by clearing the TXIFLSEL field (Bits 2 to 0) in the IFLS register
+    UART0->IFLS &= ~0x07;
+    
+    // Triggers the RX interrupt when the RX FIFO is at or above 1/2 full
+    // by writing 0x2 to the RXIFLSEL field (Bits 5 to 3) in the IFLS register
+    UART0->IFLS = (UART0->IFLS & ~0x38) | 0x10;
+    
+    // Starts with the TX interrupt disabled, it is enabled when data is queued
+    UART0->IM &= ~UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+    
+    // Enables the RX and receive time-out interrupts by setting the RXIM bit (Bit 4) and
+    // the RTIM bit (Bit 6) in the IM register. The time-out fires 32 bit periods after the
+    // last character, so a character short of the FIFO level is not held back
+    UART0->IM |= UART0_RECEIVE_INTERRUPT_BIT_MASK;
+    
     // Re-enables the UART0 module by setting UARTEN bit (Bit 0) in the CTL register
     UART0->CTL |= 0x01;
     
@@ -82,29 +279,70 @@ void UART0_Init(void)
     // Enables digital functionality for PA1 and PA0 by
     // setting Bits 1 to 0 in the DEN register
     GPIOA->DEN |= 0x03;
+    
+    // Configures uDMA for bulk transmit
+    UART0_DMA_Init();
+    
+    // Enables the UART0 interrupt (IRQ 5) in NVIC
+    NVIC->ISER[0] = 1 << 5;
 }
 
 char UART0_Input_Character(void)
 {
-    // Waits until RX FIFO is not empty
-    while ((UART0->FR & UART0_RECEIVE_FIFO_EMPTY_BIT_MASK) != 0);
+    // Sleeps until the RX interrupt has put a character in the ring buffer
+    while (uart0_rx_tail == uart0_rx_head)
+    {
+        Power_Sleep();
+    }
     
-    return (char)(UART0->DR & 0xFF);
+    char data = uart0_rx_buffer[uart0_rx_tail & UART0_RX_BUFFER_MASK];
+    uart0_rx_tail++;
+    return data;
+}
+
+uint8_t UART0_Character_Available(void)
+{
+    return uart0_rx_tail != uart0_rx_head;
 }
 
 void UART0_Output_Character(char data)
 {
-    // Waits until TX FIFO is not full
-    while ((UART0->FR & UART0_TRANSMIT_FIFO_FULL_BIT_MASK) != 0);
+    PROFILE_START(profile_start);
     
-    UART0->DR = data;
+    // Applies the backpressure policy when the ring buffer is full
+    if ((uart0_tx_head - uart0_tx_tail) >= UART0_TX_BUFFER_SIZE)
+    {
+        if (uart0_tx_policy == UART0_TX_POLICY_DROP)
+        {
+            uart0_tx_dropped++;
+            PROFILE_STOP(profile_start, PROFILE_UART0_OUTPUT_CHAR);
+            return;
+        }
+        
+        while ((uart0_tx_head - uart0_tx_tail) >= UART0_TX_BUFFER_SIZE)
+        {
+            Power_Sleep();
+        }
+    }
+    
+    uart0_tx_buffer[uart0_tx_head & UART0_TX_BUFFER_MASK] = data;
+    uart0_tx_head++;
+    
+    UART0_Start_Transmit();
+    PROFILE_STOP(profile_start, PROFILE_UART0_OUTPUT_CHAR);
 }
 
 void UART0_Input_String(char *buffer_pointer, uint16_t buffer_size)
 {
-    int length = 0;
-    char character = UART0_Input_Character();
+    uint16_t length = 0;
+    
+    // A buffer of size 0 has no room even for the terminating null
+    if (buffer_size == 0)
+    {
+        return;
+    }
     
+    char character = UART0_Input_Character();
     while (character != UART0_CR)
     {
         if (character == UART0_BS)
@@ -116,7 +354,8 @@ void UART0_Input_String(char *buffer_pointer, uint16_t buffer_size)
                 UART0_Output_Character(UART0_BS);
             }
         }
-        else if (length < buffer_size)
+        // Keeps the last byte for the terminating null
+        else if (length < (buffer_size - 1))
         {
             *buffer_pointer = character;
             buffer_pointer++;
@@ -130,11 +369,28 @@ void UART0_Input_String(char *buffer_pointer, uint16_t buffer_size)
 
 void UART0_Output_String(char *pt)
 {
+    PROFILE_START(profile_start);
+    
     while (*pt)
     {
-        UART0_Output_Character(*pt);
+        // Queues as much of the string as fits before starting the transmitter once. A full
+        // ring is handed to the transmitter first, so the backpressure policy waits for it to
+        // drain instead of for a transmitter that was never started
+        if ((uart0_tx_head - uart0_tx_tail) >= UART0_TX_BUFFER_SIZE)
+        {
+            UART0_Start_Transmit();
+            UART0_Output_Character(*pt);
+        }
+        else
+        {
+            uart0_tx_buffer[uart0_tx_head & UART0_TX_BUFFER_MASK] = *pt;
+            uart0_tx_head++;
+        }
         pt++;
     }
+    
+    UART0_Start_Transmit();
+    PROFILE_STOP(profile_start, PROFILE_UART0_OUTPUT_STRING);
 }
 
 uint32_t UART0_Input_Unsigned_Decimal(void)
@@ -146,9 +402,10 @@ uint32_t UART0_Input_Unsigned_Decimal(void)
     // Accepts until <enter> is typed
     while (character != UART0_CR)
     {
-        if ((character >= '0') && (character <= '9'))
+        // Digits that would take the number above 4,294,967,295 are ignored
+        if ((character >= '0') && (character <= '9') &&
+            (number <= ((UINT32_MAX - (uint32_t)(character - '0')) / 10)))
         {
-            // The "number" will overflow if it is above 4,294,967,295
             number = (10 * number) + (character - '0');
             length++;
             UART0_Output_Character(character);
@@ -169,18 +426,17 @@ uint32_t UART0_Input_Unsigned_Decimal(void)
     return number;
 }
 
-void UART0_Output_Unsigned_Decimal(uint32_t n)
+void UART0_Printf(const char *format, ...)
 {
-    // Uses recursion to convert a decimal number
-    // of unspecified length as an ASCII string
-    if (n >= 10)
-    {
-        UART0_Output_Unsigned_Decimal(n / 10);
-        n = n % 10;
-    }
+    char line[UART0_PRINTF_LINE_SIZE];
+    va_list args;
+    
+    // Renders the whole line first, then queues it with a single transmitter start
+    va_start(args, format);
+    Format_Vector(line, sizeof(line), format, args);
+    va_end(args);
     
-    // n is between 0 and 9
-    UART0_Output_Character(n + '0');
+    UART0_Output_String(line);
 }
 
 void UART0_Output_Newline(void)
@@ -193,4 +449,158 @@ void UART0_Clear_Screen(void)
 {
     // ANSI escape codes to clear screen and move the cursor to the home position
     UART0_Output_String("\033[2J\033[H");
+}
+
+void UART0_Set_TX_Policy(uint8_t policy)
+{
+    uart0_tx_policy = policy;
+}
+
+uint32_t UART0_Get_RX_Dropped_Count(void)
+{
+    return uart0_rx_dropped;
+}
+
+uint32_t UART0_Get_TX_Dropped_Count(void)
+{
+    return uart0_tx_dropped;
+}
+
+void UART0_Write_DMA(const char *buffer, uint16_t length)
+{
+    PROFILE_START(profile_start);
+    
+    while (length > 0)
+    {
+        UART0_DMA_Stage *stage = &uart0_dma_stages[uart0_dma_fill_index];
+        
+        // Appends to the newest staged transfer if it has not started and
+        // no ring output has been queued since it was staged
+        UART0_DMA_Stage *previous = &uart0_dma_stages[uart0_dma_fill_index ^ 1];
+        if ((previous->state == UART0_DMA_STAGE_PENDING) && (previous->ring_mark == uart0_tx_head) &&
+            (previous->length < UART0_DMA_STAGE_SIZE))
+        {
+            stage = previous;
+            NVIC->ICER[0] = 1 << 5;
+            
+            // Re-checks with the UART0 interrupt masked in case the transfer just started
+            if (stage->state != UART0_DMA_STAGE_PENDING)
+            {
+                NVIC->ISER[0] = 1 << 5;
+                continue;
+            }
+        }
+        else
+        {
+            // Waits for the staging buffer to be released by the previous transfer
+            while (stage->state != UART0_DMA_STAGE_FREE)
+            {
+                Power_Sleep();
+            }
+            
+            NVIC->ICER[0] = 1 << 5;
+            stage->length = 0;
+            stage->ring_mark = uart0_tx_head;
+            uart0_dma_fill_index ^= 1;
+        }
+        
+        uint16_t chunk = UART0_DMA_STAGE_SIZE - stage->length;
+        if (chunk > length)
+        {
+            chunk = length;
+        }
+        
+        for (uint16_t i = 0; i < chunk; i++)
+        {
+            stage->data[stage->length + i] = buffer[i];
+        }
+        stage->length += chunk;
+        stage->state = UART0_DMA_STAGE_PENDING;
+        buffer += chunk;
+        length -= chunk;
+        
+        UART0_Service_Transmit();
+        NVIC->ISER[0] = 1 << 5;
+    }
+    PROFILE_STOP(profile_start, PROFILE_UART0_WRITE_DMA);
+}
+
+uint8_t UART0_DMA_Busy(void)
+{
+    return (uart0_dma_stages[0].state != UART0_DMA_STAGE_FREE) ||
+           (uart0_dma_stages[1].state != UART0_DMA_STAGE_FREE);
+}
+
+void UART0_Set_DMA_Task(void (*task)(void))
+{
+    UART0_DMA_Task = task;
+}
+
+void UART0_Flush(void)
+{
+    // Waits until the ring buffer and DMA staging buffers are drained
+    // and the last character has left the shift register
+    while ((uart0_tx_tail != uart0_tx_head) || UART0_DMA_Busy())
+    {
+        Power_Sleep();
+    }
+    while ((UART0->FR & UART0_BUSY_BIT_MASK) != 0);
+}
+
+// UART0 Interrupt Handler - fills the receive ring buffer, drains the transmit ring buffer
+// and completes DMA transfers
+void UART0_Handler(void)
+{
+    PROFILE_START(profile_start);
+    uint32_t status = UART0->MIS;
+    
+    if (status & UART0_TRANSMIT_INTERRUPT_BIT_MASK)
+    {
+        UART0->ICR = UART0_TRANSMIT_INTERRUPT_BIT_MASK;
+    }
+    
+    // Empties the RX FIFO, which also clears the RX and receive time-out interrupts
+    if (status & UART0_RECEIVE_INTERRUPT_BIT_MASK)
+    {
+        uint32_t received = 0;
+        
+        UART0->ICR = UART0_RECEIVE_INTERRUPT_BIT_MASK;
+        while ((UART0->FR & UART0_RECEIVE_FIFO_EMPTY_BIT_MASK) == 0)
+        {
+            char data = (char)(HAL_UART0_Read_Data() & 0xFF);
+            
+            if ((uart0_rx_head - uart0_rx_tail) < UART0_RX_BUFFER_SIZE)
+            {
+                uart0_rx_buffer[uart0_rx_head & UART0_RX_BUFFER_MASK] = data;
+                uart0_rx_head++;
+                received++;
+            }
+            else
+            {
+                uart0_rx_dropped++;
+            }
+        }
+        
+        // Posts the burst with the time it was taken from the FIFO
+        if (received > 0)
+        {
+            Event_Queue_Post_Now(EVENT_SOURCE_UART_RX, EVENT_UART_RX, (received > 0xFF) ? 0xFF : (uint8_t)received);
+        }
+    }
+    
+    // The uDMA completion interrupt is delivered on the UART0 vector
+    if (UDMA->CHIS & UART0_DMA_CHANNEL_BIT_MASK)
+    {
+        UDMA->CHIS = UART0_DMA_CHANNEL_BIT_MASK;
+        uart0_dma_stages[uart0_dma_send_index].state = UART0_DMA_STAGE_FREE;
+        uart0_dma_send_index ^= 1;
+        
+        if (UART0_DMA_Task)
+        {
+            (*UART0_DMA_Task)();
+        }
+    }
+    
+    UART0_Service_Transmit();
+    PROFILE_STOP(profile_start, PROFILE_UART0_HANDLER);
 }
\ No newline at end of file
@@ -5,12 +5,16 @@
  *
  * This file contains the function prototypes and definitions for the UART0 driver.
  *
- * @note Assumes that the frequency of the system clock is 50 MHz.
+ * Transmission is interrupt-driven: output functions copy characters into a ring buffer
+ * and return immediately, while the UART0 TX interrupt drains the ring into the hardware FIFO.
+ * Reception is interrupt-driven as well: the RX interrupts move characters from the hardware
+ * FIFO into a receive ring buffer, so UART0_Character_Available never waits.
  *
  * @author Benjamin Nguyen
  */
 
 #include <stdint.h>
+#include "System_Clock.h"
 
 // ASCII Character Definitions
 #define UART0_CR   0x0D    // Carriage Return
@@ -20,14 +24,41 @@
 // UART0 Status Bit Masks
 #define UART0_RECEIVE_FIFO_EMPTY_BIT_MASK    0x10
 #define UART0_TRANSMIT_FIFO_FULL_BIT_MASK    0x20
+#define UART0_BUSY_BIT_MASK                  0x08
+#define UART0_TRANSMIT_INTERRUPT_BIT_MASK    0x20
+#define UART0_RECEIVE_INTERRUPT_BIT_MASK     0x50    // RX (Bit 4) and receive time-out (Bit 6)
+
+// Transmit ring buffer size (must be a power of two)
+#define UART0_TX_BUFFER_SIZE    256
+
+// Receive ring buffer size (must be a power of two)
+#define UART0_RX_BUFFER_SIZE    256
+
+// Transmit backpressure policies for a full ring buffer
+#define UART0_TX_POLICY_BLOCK   0    // Waits for the TX interrupt to free space (default)
+#define UART0_TX_POLICY_DROP    1    // Discards the character and counts it
+
+// Longest line UART0_Printf renders (longer output is truncated)
+#define UART0_PRINTF_LINE_SIZE  128
+
+// Size of each of the two uDMA staging buffers (at most 1024, the uDMA transfer limit)
+#define UART0_DMA_STAGE_SIZE    512
 
 // Function Prototypes
 void UART0_Init(void);
 char UART0_Input_Character(void);
+uint8_t UART0_Character_Available(void);
 void UART0_Output_Character(char data);
 void UART0_Input_String(char *buffer_pointer, uint16_t buffer_size);
 void UART0_Output_String(char *pt);
 uint32_t UART0_Input_Unsigned_Decimal(void);
-void UART0_Output_Unsigned_Decimal(uint32_t n);
+void UART0_Printf(const char *format, ...);    // See Format.h for the conversions
 void UART0_Output_Newline(void);
-void UART0_Clear_Screen(void);
\ No newline at end of file
+void UART0_Clear_Screen(void);
+void UART0_Set_TX_Policy(uint8_t policy);
+uint32_t UART0_Get_RX_Dropped_Count(void);
+uint32_t UART0_Get_TX_Dropped_Count(void);
+void UART0_Write_DMA(const char *buffer, uint16_t length);
+uint8_t UART0_DMA_Busy(void);
+void UART0_Set_DMA_Task(void (*task)(void));
+void UART0_Flush(void);
\ No newline at end of file
@@ -7,331 +7,2408 @@
  * The game measures how fast a user can press a button in response to a visual stimulus.
  *
  * Features:
- *  - Configurable number of rounds
- *  - UART-based menu system
- *  - Reaction time measurement with validation
+ *  - Configurable number of rounds (up to 1000), with streaming statistics (mean, standard
+ *    deviation, median and percentiles) in constant memory (see Statistics.h)
+ *  - Log-linear reaction time histograms of the last game and of every game since power-up,
+ *    exported bucket by bucket with the histogram command (see Histogram.h)
+ *  - Non-blocking game engine driven by software timers from a single main loop
+ *  - UART-based menu system, plus a command line (rounds, start, abort, stats, dump,
+ *    calibrate, dashboard, histogram, pvt, pace) that is read without blocking, so commands are
+ *    accepted mid-game (see Command.h)
+ *  - Microsecond reaction time measurement with validation (Timer 2A edge-time capture),
+ *    corrected by a loopback calibration of the stimulus-to-capture latency (see Calibration.h)
+ *  - False-start detection: SW1 is armed for the whole round, and presses before the
+ *    stimulus are recorded as false starts (debounced with a Timer 1A lockout window)
+ *  - Two-player mode: SW1 against SW2, both captured in hardware by timers running in
+ *    lockstep, with the round won by the earlier valid press to one clock cycle
+ *  - Choice mode: the stimulus is red (press SW1), green (press SW2) or blue (do not
+ *    press), drawn from a schedule generated at the start of the session, with accuracy
+ *    and reaction time kept per color
+ *  - Psychomotor vigilance (PVT) mode: red stimuli for a set number of minutes, 2 to 10 s
+ *    apart with no countdown or pause between trials, with lapses and false starts counted
+ *  - Foreperiods drawn from a uniform or a non-aging exponential distribution (see
+ *    Foreperiod.h), with a generator seeded from hardware entropy at power-up (see Random.h)
+ *  - Pacing of the LED test, countdown, feedback and pause between rounds set per session
+ *    (standard, rapid or custom), with the LED test and countdown optional
  *  - Performance rating system
- *  - Results display via UART
+ *  - Results display via UART, with menus and reports rendered a line at a time by a
+ *    printf-style formatter (see Format.h) and sent in bulk through uDMA
+ *  - Diagnostics menu with DWT cycle counts for the ISRs, UART output and game phases
+ *  - Timestamped events from the button, SysTick and UART RX interrupts, passed to the main
+ *    loop through lock-free queues and summarised on the Diagnostics screen (see Event_Queue.h)
+ *  - Low-power idle: every wait sleeps until the next interrupt, and the menu enters deep
+ *    sleep after POWER_DEEP_SLEEP_TIMEOUT_MS without a key (see Power.h)
+ *  - Telemetry mode: game output replaced by compact binary records (see Telemetry.h)
+ *  - Dashboard mode: game output replaced by a live dashboard (round, last reaction time,
+ *    running mean and median, reaction time histogram) that only sends the cells that
+ *    changed after each trial (see Dashboard.h)
+ *  - Persistent session log and settings in the on-chip EEPROM (see Session_Log.h), with
+ *    recent session history on the results screen
  *
  * Hardware Configuration:
  *  - LEDs: PF1 (Red), PF2 (Blue), PF3 (Green)
- *  - Buttons: PF4 (SW1 - Reaction), PF0 (SW2 - Menu)
+ *  - Buttons: PF4 (SW1 - Reaction), PF0 (SW2 - Menu, player 2 in two-player mode, or the
+ *    green response in choice mode)
  *  - UART: PA0 (RX), PA1 (TX) - 115200 baud configuration
+ *  - Calibration loopback: PB3 (output) wired to PB2 (T3CCP0), only needed to calibrate
  *
- * @note Assumes 50 MHz system clock frequency.
+ * @note The system clock runs from the PLL at SYSTEM_CLOCK_HZ (80 MHz, see System_Clock.h).
  *
  * @author Benjamin Nguyen
  */
 
+#include <stdarg.h>
 #include <stdint.h>
+#include "Calibration.h"
+#include "Command.h"
+#include "Dashboard.h"
+#include "Event_Queue.h"
+#include "Foreperiod.h"
+#include "Format.h"
 #include "GPIO.h"
+#include "Histogram.h"
+#include "Power.h"
+#include "Profile.h"
+#include "Random.h"
+#include "Session_Log.h"
+#include "Statistics.h"
+#include "Stimulus_Schedule.h"
 #include "SysTick_Delay.h"
+#include "System_Clock.h"
+#include "Telemetry.h"
+#include "Timer_2A_Capture.h"
+#include "Timer_Wheel.h"
 #include "UART.h"
-#include "TM4C123GH6PM.h"
+#include "HAL.h"
 
 // Game constants
-#define MAX_ROUNDS 10
-#define MIN_DELAY_MS 1000
-#define MAX_DELAY_MS 3000
+#define MAX_ROUNDS 1000
+#define RECENT_ROUNDS 10
 #define TIMEOUT_MS 2000
+#define TIMEOUT_US (TIMEOUT_MS * 1000)
 #define ANTICIPATION_THRESHOLD_MS 100
+#define ANTICIPATION_THRESHOLD_US (ANTICIPATION_THRESHOLD_MS * 1000)
 
-// Game result structure
+// Arguments for "%u.%03u ms": a time in microseconds as milliseconds with three decimal places
+#define US_AS_MS(time_us) (uint32_t)((time_us) / 1000), (uint32_t)((time_us) % 1000)
+#define COUNTDOWN_START 3
+#define HISTORY_SESSIONS 5
+
+// Standard pacing (the defaults), and the rapid preset, which skips the LED test and the
+// countdown. A step of 0 ms skips the LED test or the countdown
+#define LED_TEST_STEP_MS 500
+#define COUNTDOWN_STEP_MS 2000
+#define FEEDBACK_MS 2000
+#define INTERTRIAL_MS 2000
+#define RAPID_FEEDBACK_MS 500
+#define RAPID_INTERTRIAL_MS 500
+#define PACING_MAX_MS 10000
+
+// PVT mode: the interval from a response (or the timeout) to the next stimulus is drawn
+// uniformly from PVT_INTERVAL_MIN_MS to PVT_INTERVAL_MAX_MS, and its first PVT_FEEDBACK_MS
+// shows the result. A false start can end a trial one feedback period after the last, so a
+// run has at most one trial per PVT_FEEDBACK_MS
+#define PVT_DEFAULT_MINUTES 5
+#define PVT_MAX_MINUTES 10
+#define PVT_INTERVAL_MIN_MS 2000
+#define PVT_INTERVAL_MAX_MS 10000
+#define PVT_FEEDBACK_MS 1000
+#define PVT_MAX_TRIALS(minutes) (((minutes) * 60000) / PVT_FEEDBACK_MS)
+
+// Dashboard reaction time histogram: 25 ms bins from 100 ms, the last bin open-ended
+#define DASHBOARD_HISTOGRAM_BINS 20
+#define DASHBOARD_HISTOGRAM_MIN_US 100000
+#define DASHBOARD_HISTOGRAM_BIN_US 25000
+#define DASHBOARD_HISTOGRAM_LAST_US (DASHBOARD_HISTOGRAM_MIN_US + ((DASHBOARD_HISTOGRAM_BINS - 1) * DASHBOARD_HISTOGRAM_BIN_US))
+
+// Game engine states
+typedef enum
+{
+    GAME_IDLE,
+    GAME_LED_TEST,
+    GAME_COUNTDOWN,
+    GAME_FOREPERIOD,
+    GAME_STIMULUS,
+    GAME_FEEDBACK,
+    GAME_INTERTRIAL
+} GameState;
+
+// Game modes (also stored in the session log)
+typedef enum
+{
+    GAME_MODE_SIMPLE,
+    GAME_MODE_TWO_PLAYER,
+    GAME_MODE_CHOICE,
+    GAME_MODE_PVT,
+    GAME_MODE_COUNT
+} GameMode;
+
+// Durations of the phases around each trial, in milliseconds (PVT runs use their own)
 typedef struct
 {
-    uint32_t reaction_time;
-    uint8_t valid;
+    uint16_t led_test_step_ms;     // Each of the three LED test steps, 0 skips the test
+    uint16_t countdown_step_ms;    // Each of the COUNTDOWN_START steps, 0 skips the countdown
+    uint16_t feedback_ms;
+    uint16_t intertrial_ms;
+} GamePacing;
+
+// Game result structure, with the players side by side
+typedef struct
+{
+    uint32_t reaction_time[PLAYER_COUNT];    // In microseconds
+    uint8_t outcome[PLAYER_COUNT];           // RoundOutcome
+    uint8_t winner;                          // Two-player rounds: PLAYER_1, PLAYER_2 or PLAYER_TIE
+    uint8_t stimulus;                        // Stimulus code from the schedule
+    uint16_t foreperiod_ms;
+    uint32_t onset_time_us;                  // Timer 2A timebase, 0 when there was no stimulus
 } RoundResult;
 
-// Global variables
-static RoundResult game_results[MAX_ROUNDS];
-static uint8_t current_round = 0;
-static uint8_t total_rounds = 5;
+// Global variables: the last RECENT_ROUNDS rounds are kept for the results screen,
+// indexed by round number modulo RECENT_ROUNDS
+static RoundResult game_results[RECENT_ROUNDS];
+static uint16_t current_round = 0;
+static uint16_t total_rounds = 5;
+static uint16_t session_rounds = 0;    // Rounds planned for the game on the results screen
+
+// Mode of the next game (menu setting), and mode and players of the game on the results screen
+static GameMode game_mode = GAME_MODE_SIMPLE;
+static uint8_t foreperiod_distribution = FOREPERIOD_UNIFORM;
+static GameMode session_mode = GAME_MODE_SIMPLE;
+static uint8_t session_player_count = 1;
+static uint16_t round_wins[PLAYER_COUNT];
+static uint16_t round_ties = 0;
+static uint8_t announced_false_starts = 0;
+
+// Pacing of the next game (menu setting) and of the game in progress
+static const GamePacing standard_pacing = { LED_TEST_STEP_MS, COUNTDOWN_STEP_MS, FEEDBACK_MS, INTERTRIAL_MS };
+static const GamePacing rapid_pacing = { 0, 0, RAPID_FEEDBACK_MS, RAPID_INTERTRIAL_MS };
+static GamePacing game_pacing = { LED_TEST_STEP_MS, COUNTDOWN_STEP_MS, FEEDBACK_MS, INTERTRIAL_MS };
+static GamePacing session_pacing = { LED_TEST_STEP_MS, COUNTDOWN_STEP_MS, FEEDBACK_MS, INTERTRIAL_MS };
+
+// PVT run length (menu setting), and the SysTick time the run in progress ends
+static uint8_t pvt_minutes = PVT_DEFAULT_MINUTES;
+static uint32_t pvt_end_time = 0;
+static uint32_t pvt_feedback_start = 0;    // Start of the current interval, in ms
+
+// Game engine state
+static GameState game_state = GAME_IDLE;
+static Soft_Timer game_timer;    // Expires when the current state is over
+static uint8_t countdown_value = 0;
+static uint8_t led_test_step = 0;
+static uint8_t awaiting_key = 0;
+static uint8_t sw2_previous_state = 0;
+static uint8_t rounds_prompt = 0;       // The next line is the number of rounds
+static uint32_t menu_idle_start = 0;    // SysTick time of the last key or game activity
+
+// Stimulus LEDs, expected responses (no-go: PLAYER_TIE) and prompts by stimulus code
+static const uint8_t stimulus_leds[STIMULUS_COUNT] = { RED_LED, GREEN_LED, BLUE_LED };
+static const uint8_t stimulus_buttons[STIMULUS_COUNT] = { PLAYER_1, PLAYER_2, PLAYER_TIE };
+static char *const stimulus_prompts[STIMULUS_COUNT] = { "Red LED on! Press SW1!\r\n", "Green LED on! Press SW2!\r\n",
+                                                        "Blue LED on! Do not press!\r\n" };
+static char *const stimulus_names[STIMULUS_COUNT] = { "Red", "Green", "Blue" };
+static char *const game_mode_names[GAME_MODE_COUNT] = { "Simple", "Two-Player", "Choice", "PVT" };
+
+// Telemetry mode sends binary records instead of the game's text output
+static uint8_t telemetry_mode = 0;
+
+// Dashboard mode redraws a live dashboard instead of the game's text output (telemetry
+// mode takes precedence), with the last outcome per statistics channel and a histogram
+// of the session's valid reaction times
+static uint8_t dashboard_mode = 0;
+static uint8_t dashboard_last_outcome[STIMULUS_COUNT];
+static uint32_t dashboard_last_time_us[STIMULUS_COUNT];
+static uint16_t dashboard_histogram[DASHBOARD_HISTOGRAM_BINS];
+static const char dashboard_levels[] = " .:-=+*#%@";
+static char *const dashboard_outcome_names[] = { "", "miss", "early", "false", "wrong", "no-go", "held" };
+
+// Reaction time histograms of the valid responses in the current or last game, and in
+// every game since power-up (including the last game restored from the session log)
+static Histogram session_histogram;
+static Histogram all_histogram;
+
+// Event queue consumer: the longest time an event waited to be drained (button events
+// stamped at a capture only), the button events by type, and the period of SysTick ticks
+static char *const event_source_names[EVENT_SOURCE_COUNT] = { "Buttons", "SysTick", "UART RX" };
+static uint64_t event_drain_ticks = 0;
+static uint32_t event_wait_max_ticks[EVENT_SOURCE_COUNT];
+static uint32_t button_event_counts[EVENT_BUTTON_GLITCH + 1];
+static uint64_t systick_event_ticks = 0;
+static uint8_t systick_event_sequence = 0;
+static uint8_t systick_event_seen = 0;
+static uint32_t systick_period_min_ticks = 0;
+static uint32_t systick_period_max_ticks = 0;
+
+// Report buffer for bulk output through uDMA
+static char report_buffer[UART0_DMA_STAGE_SIZE];
+static uint16_t report_length = 0;
 
 // Function prototypes
 void Display_Menu(void);
 void Get_Number_Of_Rounds(void);
+void Set_Number_Of_Rounds(const char *text);
+uint8_t Handle_Input(char input);
+uint8_t Handle_Line(void);
+void Handle_Help_Command(uint8_t argc, char *argv[]);
+void Handle_Rounds_Command(uint8_t argc, char *argv[]);
+void Handle_Start_Command(uint8_t argc, char *argv[]);
+void Handle_Abort_Command(uint8_t argc, char *argv[]);
+void Handle_Stats_Command(uint8_t argc, char *argv[]);
+void Handle_Dump_Command(uint8_t argc, char *argv[]);
+void Handle_Calibrate_Command(uint8_t argc, char *argv[]);
+void Handle_Dashboard_Command(uint8_t argc, char *argv[]);
+void Handle_Histogram_Command(uint8_t argc, char *argv[]);
+void Handle_PVT_Command(uint8_t argc, char *argv[]);
+void Handle_Pace_Command(uint8_t argc, char *argv[]);
+void Set_Pacing(const GamePacing *pacing);
+uint16_t Load_Pacing_Setting(uint8_t id, uint16_t default_ms);
+uint8_t Pacing_Equal(const GamePacing *a, const GamePacing *b);
+const char *Get_Pacing_Name(const GamePacing *pacing);
+void Report_Pacing(const GamePacing *pacing);
+void Process_Events(void);
+void Handle_Button_Event(const Event *event);
+void Handle_SysTick_Event(const Event *event);
+void Handle_UART_RX_Event(const Event *event);
+void Record_Event_Wait(uint8_t source, const Event *event);
 void Play_Game(void);
-void Display_Results(void);
-void Declare_Winner(uint32_t average_time);
+void Game_Update(void);
+void Game_Timer_Task(void);
+void Enter_State(GameState state, uint32_t duration_ms, uint32_t period_ms);
+void Begin_Round(void);
+void Next_Round(void);
+void Reset_Round_Result(void);
+uint8_t Session_Time_Up(void);
+void PVT_Feedback_False_Start(void);
+void Begin_Foreperiod(void);
+void Evaluate_Response(void);
+void No_Response(void);
+void False_Start(void);
+void Evaluate_Head_To_Head(void);
+void Evaluate_Choice(void);
+void Show_Feedback(uint8_t correct);
+uint8_t Classify_Response(uint8_t player, uint32_t *reaction_time_us);
+void Announce_False_Starts(uint8_t flags);
+void Record_Result(uint8_t player, uint8_t outcome, uint32_t reaction_time_us);
+void Record_Winner(uint8_t winner);
+uint8_t All_Players(void);
+uint8_t Round_Complete(uint8_t flags);
+void Abort_Game(void);
+void End_Session(uint8_t aborted);
+void Restore_Last_Session(void);
+void Display_Results(uint8_t include_history);
+void Report_Session_Statistics(uint8_t rate_performance);
+void Display_History(void);
+void Display_Diagnostics(void);
+void Display_Power_Stats(void);
+void Report_Calibration(void);
+void Report_Event_Queues(void);
+void Report_Dashboard(void);
+void Draw_Dashboard(void);
+void Declare_Winner(const Statistics_Summary *summary);
+uint8_t Game_Text_Enabled(void);
+void Game_Output_String(char *pt);
+void Game_Printf(const char *format, ...);
+void Game_Output_Newline(void);
+void Game_Output_Clear_Screen(void);
+void Report_String(char *pt);
+void Report_Printf(const char *format, ...);
+void Report_Outcome(uint8_t outcome, uint32_t reaction_time_us);
+void Report_Summary(const Statistics_Summary *summary);
+void Report_Choice_Summary(uint8_t stimulus, const Statistics_Summary *summary);
+void Report_Send(void);
+
+// Command line commands
+static const Command commands[] =
+{
+    { "help",      "help",                0, 0, &Handle_Help_Command },
+    { "rounds",    "rounds <1-1000>",     1, 1, &Handle_Rounds_Command },
+    { "start",     "start",               0, 0, &Handle_Start_Command },
+    { "abort",     "abort",               0, 0, &Handle_Abort_Command },
+    { "stats",     "stats",               0, 0, &Handle_Stats_Command },
+    { "dump",      "dump",                0, 0, &Handle_Dump_Command },
+    { "calibrate", "calibrate",           0, 0, &Handle_Calibrate_Command },
+    { "dashboard", "dashboard <on|off>",  1, 1, &Handle_Dashboard_Command },
+    { "histogram", "histogram [all]",     0, 1, &Handle_Histogram_Command },
+    { "pvt",       "pvt <1-10 minutes>",  1, 1, &Handle_PVT_Command },
+    { "pace",      "pace <preset|phase> [ms]", 1, 2, &Handle_Pace_Command }
+};
+#define COMMAND_COUNT (sizeof(commands) / sizeof(commands[0]))
 
 int main(void)
 {
+    // Switches to the PLL first, since the peripheral timing is derived from its frequency
+    System_Clock_Init();
+    
     // Initializes all peripherals
+    Profile_Init();
     SysTick_Init();
+    Timer_Wheel_Init();
     GPIO_Init();
     UART0_Init();
+    Random_Init();
+    Power_Init();
     
     // Enables interrupts globally
-    __asm(" CPSIE I");  // Assembly instruction to enable interrupts
+    __enable_irq();
+    
+    // Restores the saved settings and the last session from the EEPROM log
+    Statistics_Reset();
+    Session_Log_Init();
+    total_rounds = Session_Log_Load_Setting(SESSION_LOG_SETTING_TOTAL_ROUNDS, total_rounds);
+    if ((total_rounds < 1) || (total_rounds > MAX_ROUNDS))
+    {
+        total_rounds = 5;
+    }
+    game_mode = (GameMode)Session_Log_Load_Setting(SESSION_LOG_SETTING_GAME_MODE, GAME_MODE_SIMPLE);
+    if (game_mode >= GAME_MODE_COUNT)
+    {
+        game_mode = GAME_MODE_SIMPLE;
+    }
+    foreperiod_distribution = (uint8_t)Session_Log_Load_Setting(SESSION_LOG_SETTING_FOREPERIOD, FOREPERIOD_UNIFORM);
+    if (foreperiod_distribution >= FOREPERIOD_COUNT)
+    {
+        foreperiod_distribution = FOREPERIOD_UNIFORM;
+    }
+    dashboard_mode = (Session_Log_Load_Setting(SESSION_LOG_SETTING_DASHBOARD, 0) == 1);
+    pvt_minutes = (uint8_t)Session_Log_Load_Setting(SESSION_LOG_SETTING_PVT_MINUTES, PVT_DEFAULT_MINUTES);
+    if ((pvt_minutes < 1) || (pvt_minutes > PVT_MAX_MINUTES))
+    {
+        pvt_minutes = PVT_DEFAULT_MINUTES;
+    }
+    game_pacing.led_test_step_ms = Load_Pacing_Setting(SESSION_LOG_SETTING_LED_TEST_MS, LED_TEST_STEP_MS);
+    game_pacing.countdown_step_ms = Load_Pacing_Setting(SESSION_LOG_SETTING_COUNTDOWN_MS, COUNTDOWN_STEP_MS);
+    game_pacing.feedback_ms = Load_Pacing_Setting(SESSION_LOG_SETTING_FEEDBACK_MS, FEEDBACK_MS);
+    game_pacing.intertrial_ms = Load_Pacing_Setting(SESSION_LOG_SETTING_INTERTRIAL_MS, INTERTRIAL_MS);
+    Calibration_Init();
+    Restore_Last_Session();
     
     // Displays starting message
     UART0_Clear_Screen();
     UART0_Output_String("--- Reaction Time Game ---\r\n\r\n");
     UART0_Output_String("ECE 425 Final Project\r\n\r\n");
+    Display_Menu();
     
+    // Main loop: runs expired timers, drains the interrupt events, advances the game engine
+    // and handles inputs, sleeping between events
     while (1)
     {
-        Display_Menu();
+        Timer_Wheel_Process();
+        Process_Events();
+        Game_Update();
         
-        char choice = UART0_Input_Character();
-        UART0_Output_Character(choice);
-        UART0_Output_Newline();
+        // EEPROM writes stall the flash, so the log is only written outside the timed phases
+        Session_Log_Process((game_state != GAME_FOREPERIOD) && (game_state != GAME_STIMULUS));
         
-        switch (choice)
+        // Takes every received character, so scripted input keeps up with the line rate
+        while (UART0_Character_Available())
         {
-            case '1':
-                Get_Number_Of_Rounds();
-                break;
-                
-            case '2':
-                Play_Game();
-                break;
-                
-            case '3':
-                Display_Results();
-                break;
-                
-            case '4':
+            menu_idle_start = SysTick_Get_Current_Time();
+            if (Handle_Input(UART0_Input_Character()))
+            {
+                Session_Log_Flush();
                 UART0_Output_String("Exiting...\r\n");
+                UART0_Flush();
                 return 0;
-                
-            default:
-                UART0_Output_String("\r\nInvalid choice, try again.\r\n");
+            }
+        }
+        
+        // SW2 returns to the menu during a simple game or a PVT run (it is a response button in the
+        // other modes)
+        uint8_t sw2_state = SW2_Pressed();
+        if (sw2_state && !sw2_previous_state && (game_state != GAME_IDLE) &&
+            ((session_mode == GAME_MODE_SIMPLE) || (session_mode == GAME_MODE_PVT)))
+        {
+            Abort_Game();
+        }
+        sw2_previous_state = sw2_state;
+        
+        // The menu is idle from the last key or the end of the last game
+        uint8_t menu_idle = (game_state == GAME_IDLE) && !Timer_Wheel_Is_Active(&game_timer);
+        if (!menu_idle)
+        {
+            menu_idle_start = SysTick_Get_Current_Time();
+        }
+        
+        // Sleeps until the next interrupt (SysTick wakes the core every 1 ms). Once the menu
+        // has waited long enough for a key, the pending output is finished and the core
+        // stays in deep sleep until a key arrives or the next timer is due
+        if (menu_idle && ((SysTick_Get_Current_Time() - menu_idle_start) >= POWER_DEEP_SLEEP_TIMEOUT_MS))
+        {
+            Session_Log_Flush();
+            UART0_Flush();
+            Power_Deep_Sleep(&UART0_Character_Available, Timer_Wheel_Next_Expiry());
+        }
+        else
+        {
+            Power_Sleep();
         }
     }
 }
 
-void Display_Menu(void)
+uint8_t Handle_Input(char input)
 {
+    // Letters start a command line. Once a line has started, and while the number of rounds
+    // is entered, every key goes to the line editor. Line feeds always do, so the line feed
+    // of a CRLF ending is not taken as a key
+    uint8_t letter = ((input >= 'a') && (input <= 'z')) || ((input >= 'A') && (input <= 'Z'));
+    if (rounds_prompt || Command_Line_Pending() || letter || (input == UART0_LF))
+    {
+        return Command_Edit(input) ? Handle_Line() : 0;
+    }
+    
+    // Any other key aborts a game in progress
+    if (game_state != GAME_IDLE)
+    {
+        Abort_Game();
+        return 0;
+    }
+    
+    // The key after a results screen returns to the menu
+    if (awaiting_key)
+    {
+        awaiting_key = 0;
+        UART0_Output_Newline();
+        Display_Menu();
+        return 0;
+    }
+    
+    UART0_Output_Character(input);
     UART0_Output_Newline();
-    UART0_Output_String("--- Main Menu ---\r\n\r\n");
-    UART0_Output_String("1. Set Number of Rounds (Current: ");
-    UART0_Output_Unsigned_Decimal(total_rounds);
-    UART0_Output_String(")\r\n\r\n");
-    UART0_Output_String("2. Start Game\r\n\r\n");
-    UART0_Output_String("3. View Previous Results\r\n\r\n");
-    UART0_Output_String("4. Exit\r\n\r\n");
-    UART0_Output_String("Enter your choice: ");
+    
+    switch (input)
+    {
+        case '1':
+            Get_Number_Of_Rounds();
+            return 0;
+            
+        case '2':
+            Play_Game();
+            return 0;
+            
+        case '3':
+            Display_Results(1);
+            return 0;
+            
+        case '4':
+            Display_Diagnostics();
+            return 0;
+            
+        case '5':
+            telemetry_mode = !telemetry_mode;
+            UART0_Output_String(telemetry_mode ? "\r\nTelemetry mode on: games are reported as binary frames.\r\n" :
+                                                 "\r\nTelemetry mode off.\r\n");
+            break;
+            
+        case '6':
+            // Steps through the game modes
+            game_mode = (GameMode)((game_mode + 1) % GAME_MODE_COUNT);
+            Session_Log_Save_Setting(SESSION_LOG_SETTING_GAME_MODE, game_mode);
+            UART0_Output_String("\r\nGame mode: ");
+            UART0_Output_String(game_mode_names[game_mode]);
+            UART0_Output_Newline();
+            break;
+            
+        case '7':
+            // Steps through the foreperiod distributions
+            foreperiod_distribution = (foreperiod_distribution + 1) % FOREPERIOD_COUNT;
+            Session_Log_Save_Setting(SESSION_LOG_SETTING_FOREPERIOD, foreperiod_distribution);
+            UART0_Output_String("\r\nForeperiod: ");
+            UART0_Output_String((char *)Foreperiod_Get_Name(foreperiod_distribution));
+            UART0_Output_Newline();
+            break;
+            
+        case '8':
+            // Steps between the presets (a custom pacing steps to the standard one)
+            Set_Pacing(Pacing_Equal(&game_pacing, &standard_pacing) ? &rapid_pacing : &standard_pacing);
+            UART0_Printf("\r\nPacing: %s\r\n", Get_Pacing_Name(&game_pacing));
+            break;
+            
+        case '9':
+            return 1;
+            
+        default:
+            UART0_Output_String("\r\nInvalid choice, try again.\r\n");
+    }
+    
+    Display_Menu();
+    return 0;
 }
 
-void Get_Number_Of_Rounds(void)
+void Display_Menu(void)
+{
+    Report_String("\r\n--- Main Menu ---\r\n\r\n");
+    Report_Printf("1. Set Number of Rounds (Current: %u)\r\n\r\n", total_rounds);
+    Report_String("2. Start Game\r\n\r\n");
+    Report_String("3. View Previous Results\r\n\r\n");
+    Report_String("4. Diagnostics\r\n\r\n");
+    Report_Printf("5. Telemetry Mode (Current: %s)\r\n\r\n", telemetry_mode ? "On" : "Off");
+    if (game_mode == GAME_MODE_PVT)
+    {
+        Report_Printf("6. Game Mode (Current: PVT, %u min)\r\n\r\n", pvt_minutes);
+    }
+    else
+    {
+        Report_Printf("6. Game Mode (Current: %s)\r\n\r\n", game_mode_names[game_mode]);
+    }
+    Report_Printf("7. Foreperiod (Current: %s)\r\n\r\n", Foreperiod_Get_Name(foreperiod_distribution));
+    Report_Printf("8. Pacing (Current: %s)\r\n   ", Get_Pacing_Name(&game_pacing));
+    Report_Pacing(&game_pacing);
+    Report_String("\r\n");
+    Report_String("9. Exit\r\n\r\n");
+    Report_String("Enter your choice: ");
+    Report_Send();
+}
+
+uint8_t Handle_Line(void)
 {
     UART0_Output_Newline();
-    UART0_Output_String("Enter number of rounds (1-");
-    UART0_Output_Unsigned_Decimal(MAX_ROUNDS);
-    UART0_Output_String("): ");
     
-    uint32_t rounds = UART0_Input_Unsigned_Decimal();
-    UART0_Output_Newline();
+    // The number of rounds is entered on its own line after menu choice 1
+    if (rounds_prompt)
+    {
+        rounds_prompt = 0;
+        Set_Number_Of_Rounds(Command_Get_Line());
+        Display_Menu();
+        return 0;
+    }
+    
+    Command_Execute(commands, COMMAND_COUNT);
+    return 0;
+}
+
+void Handle_Help_Command(uint8_t argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
     
-    if ((rounds >= 1) && (rounds <= MAX_ROUNDS))
+    UART0_Output_String("Commands (menu keys act at once, letters start a command):\r\n");
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++)
     {
-        total_rounds = rounds;
-        UART0_Output_String("Number of rounds set to: ");
-        UART0_Output_Unsigned_Decimal(total_rounds);
-        UART0_Output_Newline();
+        UART0_Printf("  %s\r\n", commands[i].usage);
     }
-    else
+}
+
+void Handle_Rounds_Command(uint8_t argc, char *argv[])
+{
+    (void)argc;
+    
+    if (game_state != GAME_IDLE)
     {
-        UART0_Output_String("Invalid number, using default: ");
-        UART0_Output_Unsigned_Decimal(total_rounds);
-        UART0_Output_Newline();
+        UART0_Output_String("Not during a game.\r\n");
+        return;
     }
+    
+    Set_Number_Of_Rounds(argv[1]);
 }
 
-void Play_Game(void)
+void Handle_Start_Command(uint8_t argc, char *argv[])
 {
-    UART0_Clear_Screen();
-    UART0_Output_String("--- Game Starting ---\r\n\r\n");
-    UART0_Output_String("Get ready to press SW1 when the red LED turns on.\r\n\r\n");
+    (void)argc;
+    (void)argv;
     
-    current_round = 0;
+    if (game_state != GAME_IDLE)
+    {
+        UART0_Output_String("A game is already in progress.\r\n");
+        return;
+    }
     
-    // TEST: Checks if GPIO is working
-    UART0_Output_String("Testing LEDs... ");
-    LED_On(RED_LED);
-    SysTick_Delay_Milliseconds(500);
-    LED_On(BLUE_LED);
-    SysTick_Delay_Milliseconds(500);
-    LED_On(GREEN_LED);
-    SysTick_Delay_Milliseconds(500);
-    LED_Off(RED_LED | BLUE_LED | GREEN_LED);
-    UART0_Output_String("LED test complete.\r\n\r\n");
+    awaiting_key = 0;
+    Play_Game();
+}
+
+void Handle_Abort_Command(uint8_t argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
     
-    for (uint8_t i = 0; i < total_rounds; i++)
+    if (game_state == GAME_IDLE)
     {
-        UART0_Output_String("Round ");
-        UART0_Output_Unsigned_Decimal(i + 1);
-        UART0_Output_String(" of ");
-        UART0_Output_Unsigned_Decimal(total_rounds);
-        UART0_Output_String(" - ");
-        
-        // Resets game state
-        Clear_Button_Flag();
-        LED_Off(RED_LED | BLUE_LED | GREEN_LED);
-        
-        // Countdown from 3
-        UART0_Output_String("Countdown: ");
-        for (int j = 3; j > 0; j--)
+        UART0_Output_String("No game in progress.\r\n");
+        return;
+    }
+    
+    Abort_Game();
+}
+
+void Handle_Stats_Command(uint8_t argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    
+    // Statistics of the game in progress, or of the last game
+    Report_Printf("--- Statistics after %u rounds%s ---\r\n", current_round,
+                  (game_state != GAME_IDLE) ? " (in progress)" : "");
+    Report_Session_Statistics(0);
+    Report_Send();
+}
+
+void Handle_Dump_Command(uint8_t argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    
+    // Reading the whole log takes too long for a timed round
+    if (game_state != GAME_IDLE)
+    {
+        UART0_Output_String("Not during a game.\r\n");
+        return;
+    }
+    
+    Session_Log_Flush();
+    if (!Session_Log_Available())
+    {
+        UART0_Output_String("Session log unavailable (EEPROM error).\r\n");
+        return;
+    }
+    
+    // One line per record, oldest first, with the codes stored in the log (see Session_Log.h)
+    Report_Printf("--- Session Log (%u records) ---\r\n", Session_Log_Get_Count());
+    Report_String("S,sequence,total rounds,game mode,players\r\n");
+    Report_String("R,sequence,round mod 16,player,stimulus,result,foreperiod ms,reaction time us\r\n");
+    
+    Session_Log_Record record;
+    for (uint16_t index = 0; index < Session_Log_Get_Count(); index++)
+    {
+        if (!Session_Log_Read(index, &record))
         {
-            UART0_Output_Unsigned_Decimal(j);
-            UART0_Output_String(" ");
-            SysTick_Delay_Milliseconds(2000);
+            continue;
         }
-        UART0_Output_Newline();
-        
-        // Random delay before turning on LED
-        uint32_t random_delay = Generate_Random_Delay(MIN_DELAY_MS, MAX_DELAY_MS);
-        UART0_Output_String("Random delay: ");
-        UART0_Output_Unsigned_Decimal(random_delay);
-        UART0_Output_String(" ms\r\n");
-        SysTick_Delay_Milliseconds(random_delay);
         
-        // Turns on RED LED and starts timing
-        UART0_Output_String("Red LED on! Press SW1!\r\n");
-        LED_On(RED_LED);
-        Set_Start_Time(SysTick_Get_Current_Time());
-        GPIO_Enable_Interrupt();
-        
-        // Waits for button press with timeout
-				uint32_t start_wait = SysTick_Get_Current_Time();
-				// Already in milliseconds
-
-				while (!Get_Button_Flag())
-				{
-					uint32_t current_time = SysTick_Get_Current_Time();
-					if ((current_time - start_wait) > TIMEOUT_MS)  // Direct comparison in ms
-					{
-							// Timeout - no response
-							game_results[i].valid = 0;
-							game_results[i].reaction_time = 0;
-							UART0_Output_String("Too slow! No response.\r\n");
-							LED_Off(RED_LED);
-							LED_On(BLUE_LED);
-							SysTick_Delay_Milliseconds(2000);
-							LED_Off(BLUE_LED);
-					break;
+        if (record.type == SESSION_LOG_SESSION)
+        {
+            Report_Printf("S,%u,%u,%u,%u\r\n", record.sequence, record.total_rounds, record.game_mode,
+                          record.player_count);
+        }
+        else
+        {
+            Report_Printf("R,%u,%u,%u,%u,%u,%u,%u\r\n", record.sequence, record.round_index, record.player + 1,
+                          record.stimulus, record.result, record.foreperiod_ms, record.reaction_time_us);
+        }
     }
+    Report_Send();
 }
-        
-        GPIO_Disable_Interrupt();
-        
-        if (Get_Button_Flag())
+
+void Handle_Calibrate_Command(uint8_t argc, char *argv[])
 {
-    // Valid response is received
-    uint32_t reaction_time_ms = Get_Reaction_Time();  // Already in milliseconds
+    (void)argc;
+    (void)argv;
     
-    // Checks for anticipation (too fast)
-    if (reaction_time_ms < ANTICIPATION_THRESHOLD_MS)
+    // The calibration drives its own stimuli, and the loopback edges are not button presses
+    if (game_state != GAME_IDLE)
     {
-        game_results[i].valid = 0;
-        game_results[i].reaction_time = reaction_time_ms;
-        UART0_Output_String("Too fast! Anticipated too early.\r\n");
-        LED_Off(RED_LED);
-        LED_On(BLUE_LED);
+        UART0_Output_String("Not during a game.\r\n");
+        return;
     }
-    else
+    
+    UART0_Printf("Calibrating with %u stimulus/response pairs (PB3 wired to PB2)...\r\n", CALIBRATION_PAIRS);
+    if (!Calibration_Run())
     {
-        game_results[i].valid = 1;
-        game_results[i].reaction_time = reaction_time_ms;
-        UART0_Output_String("Reaction time: ");
-        UART0_Output_Unsigned_Decimal(reaction_time_ms);
-        UART0_Output_String(" ms\r\n");
-        LED_Off(RED_LED);
-        LED_On(GREEN_LED);
+        UART0_Output_String("No loopback edge on PB2: check the PB3 to PB2 wire. Offset unchanged.\r\n");
+        return;
     }
     
-    SysTick_Delay_Milliseconds(2000);
-    LED_Off(GREEN_LED | BLUE_LED);
+    Report_Calibration();
+    Report_Send();
 }
-        
-        Clear_Button_Flag();
-        
-        // Short delay between rounds
-        UART0_Output_String("Round complete. Next round starting...\r\n\r\n");
-        SysTick_Delay_Milliseconds(2000);
+
+void Handle_Dashboard_Command(uint8_t argc, char *argv[])
+{
+    (void)argc;
+    
+    uint8_t on;
+    if (!Command_Parse_On_Off(argv[1], &on))
+    {
+        UART0_Output_String("Usage: dashboard <on|off>\r\n");
+        return;
+    }
+    
+    // The screen is laid out for one mode from the start of a game
+    if (game_state != GAME_IDLE)
+    {
+        UART0_Output_String("Not during a game.\r\n");
+        return;
     }
     
-    current_round = total_rounds;
-    Display_Results();
+    dashboard_mode = on;
+    Session_Log_Save_Setting(SESSION_LOG_SETTING_DASHBOARD, dashboard_mode);
+    UART0_Output_String(dashboard_mode ? "Dashboard on: games are shown on a live dashboard.\r\n" :
+                                         "Dashboard off.\r\n");
 }
 
-void Display_Results(void)
+void Handle_Histogram_Command(uint8_t argc, char *argv[])
 {
-    UART0_Clear_Screen();
-    UART0_Output_String("--- Game Results ---\r\n\r\n");
+    // The last game by default, or every game since power-up
+    uint8_t all = (argc > 1);
+    if (all && !Command_Strings_Equal(argv[1], "all"))
+    {
+        UART0_Output_String("Usage: histogram [all]\r\n");
+        return;
+    }
     
-    uint32_t total_valid_time = 0;
-    uint8_t valid_responses = 0;
+    // Up to a line per bucket takes too long for a timed round
+    if (game_state != GAME_IDLE)
+    {
+        UART0_Output_String("Not during a game.\r\n");
+        return;
+    }
+    
+    // One line per non-empty bucket, fastest first, with the bucket's range in milliseconds
+    const Histogram *histogram = all ? &all_histogram : &session_histogram;
+    Report_Printf("--- Reaction Time Histogram (%s, %u valid responses) ---\r\n",
+                  all ? "all games" : "last game", histogram->count);
+    Report_String("from ms,below ms,count\r\n");
     
-    for (uint8_t i = 0; i < current_round; i++)
+    for (uint16_t index = 0; index < HISTOGRAM_BUCKETS; index++)
     {
-        UART0_Output_String("Round ");
-        UART0_Output_Unsigned_Decimal(i + 1);
-        UART0_Output_String(": ");
-        
-        if (game_results[i].valid)
+        if (histogram->buckets[index] != 0)
+        {
+            uint16_t lower_ms = Histogram_Bucket_Lower_Ms(index);
+            Report_Printf("%u,%u,%u\r\n", lower_ms, lower_ms + Histogram_Bucket_Width_Ms(index),
+                          histogram->buckets[index]);
+        }
+    }
+    Report_Send();
+}
+
+void Handle_PVT_Command(uint8_t argc, char *argv[])
+{
+    (void)argc;
+    
+    uint32_t minutes = 0;
+    if (!Command_Parse_Unsigned(argv[1], &minutes) || (minutes < 1) || (minutes > PVT_MAX_MINUTES))
+    {
+        UART0_Printf("Usage: pvt <1-%u minutes> (5 or 10 for the standard tests)\r\n", PVT_MAX_MINUTES);
+        return;
+    }
+    
+    if (game_state != GAME_IDLE)
+    {
+        UART0_Output_String("Not during a game.\r\n");
+        return;
+    }
+    
+    // Selects PVT mode as well, since the length only applies to it
+    pvt_minutes = (uint8_t)minutes;
+    game_mode = GAME_MODE_PVT;
+    Session_Log_Save_Setting(SESSION_LOG_SETTING_PVT_MINUTES, pvt_minutes);
+    Session_Log_Save_Setting(SESSION_LOG_SETTING_GAME_MODE, game_mode);
+    UART0_Printf("Game mode: PVT, %u minutes.\r\n", pvt_minutes);
+}
+
+void Handle_Pace_Command(uint8_t argc, char *argv[])
+{
+    GamePacing pacing = game_pacing;
+    uint32_t duration_ms = 0;
+    uint8_t valid = 0;
+    
+    // A preset, or one phase's duration
+    if (argc == 2)
+    {
+        valid = 1;
+        if (Command_Strings_Equal(argv[1], "standard"))
+        {
+            pacing = standard_pacing;
+        }
+        else if (Command_Strings_Equal(argv[1], "rapid"))
         {
-            UART0_Output_Unsigned_Decimal(game_results[i].reaction_time);
-            UART0_Output_String(" ms\r\n");
-            total_valid_time += game_results[i].reaction_time;
-            valid_responses++;
+            pacing = rapid_pacing;
         }
         else
         {
-            if (game_results[i].reaction_time == 0)
-            {
-                UART0_Output_String("No response\r\n");
-            }
-            else if (game_results[i].reaction_time < ANTICIPATION_THRESHOLD_MS)
-            {
-                UART0_Output_String("Anticipated too early\r\n");
-            }
+            valid = 0;
+        }
+    }
+    else if (Command_Parse_Unsigned(argv[2], &duration_ms) && (duration_ms <= PACING_MAX_MS))
+    {
+        valid = 1;
+        if (Command_Strings_Equal(argv[1], "led"))
+        {
+            pacing.led_test_step_ms = (uint16_t)duration_ms;
+        }
+        else if (Command_Strings_Equal(argv[1], "countdown"))
+        {
+            pacing.countdown_step_ms = (uint16_t)duration_ms;
+        }
+        else if (Command_Strings_Equal(argv[1], "feedback"))
+        {
+            pacing.feedback_ms = (uint16_t)duration_ms;
+        }
+        else if (Command_Strings_Equal(argv[1], "intertrial"))
+        {
+            pacing.intertrial_ms = (uint16_t)duration_ms;
+        }
+        else
+        {
+            valid = 0;
         }
     }
     
-    if (valid_responses > 0)
+    if (!valid)
     {
-        uint32_t average_time = total_valid_time / valid_responses;
-        UART0_Output_String("\r\nAverage reaction time: ");
-        UART0_Output_Unsigned_Decimal(average_time);
-        UART0_Output_String(" ms\r\n");
-        Declare_Winner(average_time);
+        UART0_Output_String("Usage: pace <standard|rapid>\r\n"
+                            "       pace <led|countdown|feedback|intertrial> <0-10000 ms>\r\n");
+        return;
     }
-    else
+    
+    if (game_state != GAME_IDLE)
     {
-        UART0_Output_String("\r\nNo valid responses recorded.\r\n");
+        UART0_Output_String("Not during a game.\r\n");
+        return;
     }
     
-    UART0_Output_String("\r\nPress any key to continue...");
-    UART0_Input_Character();
-    UART0_Output_Newline();
+    Set_Pacing(&pacing);
+    Report_Printf("Pacing: %s - ", Get_Pacing_Name(&game_pacing));
+    Report_Pacing(&game_pacing);
+    Report_Send();
+}
+
+void Set_Pacing(const GamePacing *pacing)
+{
+    game_pacing = *pacing;
+    Session_Log_Save_Setting(SESSION_LOG_SETTING_LED_TEST_MS, game_pacing.led_test_step_ms);
+    Session_Log_Save_Setting(SESSION_LOG_SETTING_COUNTDOWN_MS, game_pacing.countdown_step_ms);
+    Session_Log_Save_Setting(SESSION_LOG_SETTING_FEEDBACK_MS, game_pacing.feedback_ms);
+    Session_Log_Save_Setting(SESSION_LOG_SETTING_INTERTRIAL_MS, game_pacing.intertrial_ms);
+}
+
+uint16_t Load_Pacing_Setting(uint8_t id, uint16_t default_ms)
+{
+    uint32_t duration_ms = Session_Log_Load_Setting(id, default_ms);
+    return (duration_ms <= PACING_MAX_MS) ? (uint16_t)duration_ms : default_ms;
+}
+
+uint8_t Pacing_Equal(const GamePacing *a, const GamePacing *b)
+{
+    return (a->led_test_step_ms == b->led_test_step_ms) && (a->countdown_step_ms == b->countdown_step_ms) &&
+           (a->feedback_ms == b->feedback_ms) && (a->intertrial_ms == b->intertrial_ms);
+}
+
+const char *Get_Pacing_Name(const GamePacing *pacing)
+{
+    return Pacing_Equal(pacing, &standard_pacing) ? "Standard" : Pacing_Equal(pacing, &rapid_pacing) ? "Rapid" : "Custom";
+}
+
+void Report_Pacing(const GamePacing *pacing)
+{
+    // One line: the LED test and the countdown have three steps each, or are skipped
+    if (pacing->led_test_step_ms > 0)
+    {
+        Report_Printf("LED test 3 x %u ms, ", pacing->led_test_step_ms);
+    }
+    else
+    {
+        Report_String("no LED test, ");
+    }
+    if (pacing->countdown_step_ms > 0)
+    {
+        Report_Printf("countdown %u x %u ms, ", COUNTDOWN_START, pacing->countdown_step_ms);
+    }
+    else
+    {
+        Report_String("no countdown, ");
+    }
+    Report_Printf("feedback %u ms, next round after %u ms\r\n", pacing->feedback_ms, pacing->intertrial_ms);
 }
 
-void Declare_Winner(uint32_t average_time)
+void Get_Number_Of_Rounds(void)
 {
     UART0_Output_Newline();
-    UART0_Output_String("--- Performance Rating ---\r\n\r\n");
+    UART0_Printf("Enter number of rounds (1-%u): ", MAX_ROUNDS);
     
-    if (average_time < 150)
+    // The main loop collects the line and passes it to Set_Number_Of_Rounds
+    rounds_prompt = 1;
+}
+
+void Set_Number_Of_Rounds(const char *text)
+{
+    uint32_t rounds = 0;
+    
+    if (Command_Parse_Unsigned(text, &rounds) && (rounds >= 1) && (rounds <= MAX_ROUNDS))
     {
-        UART0_Output_String("Excellent! Pro gamer level!\r\n");
+        total_rounds = rounds;
+        Session_Log_Save_Setting(SESSION_LOG_SETTING_TOTAL_ROUNDS, total_rounds);
+        UART0_Printf("Number of rounds set to: %u\r\n", total_rounds);
     }
-    else if (average_time < 200)
+    else
     {
-        UART0_Output_String("Very good! Above average!\r\n");
+        UART0_Printf("Invalid number, using default: %u\r\n", total_rounds);
     }
-    else if (average_time < 250)
+}
+
+void Process_Events(void)
+{
+    // One timestamp for the whole drain, so an event posted during it waited no time
+    event_drain_ticks = Timer_2A_Get_Time_Ticks();
+    
+    Event_Queue_Drain(EVENT_SOURCE_BUTTON, &Handle_Button_Event);
+    Event_Queue_Drain(EVENT_SOURCE_SYSTICK, &Handle_SysTick_Event);
+    Event_Queue_Drain(EVENT_SOURCE_UART_RX, &Handle_UART_RX_Event);
+}
+
+void Handle_Button_Event(const Event *event)
+{
+    if (event->type > EVENT_BUTTON_GLITCH)
     {
-        UART0_Output_String("Good! Average human reaction time.\r\n");
+        return;
     }
-    else if (average_time < 300)
+    
+    button_event_counts[event->type]++;
+    
+    // Presses, releases and glitches carry the time of their first edge, not of the post
+    if ((event->type == EVENT_BUTTON_EDGE) || (event->type == EVENT_BUTTON_BOUNCE))
     {
-        UART0_Output_String("Ok. Not too bad.\r\n");
+        Record_Event_Wait(EVENT_SOURCE_BUTTON, event);
     }
-    else
+}
+
+void Handle_SysTick_Event(const Event *event)
+{
+    Record_Event_Wait(EVENT_SOURCE_SYSTICK, event);
+    
+    // Only consecutive ticks give a period, so ticks lost to a full queue or to deep sleep
+    // do not show up as a long one
+    if (systick_event_seen && (event->data == (uint8_t)(systick_event_sequence + 1)))
+    {
+        uint32_t period = (uint32_t)(event->ticks - systick_event_ticks);
+        
+        if ((systick_period_max_ticks == 0) || (period < systick_period_min_ticks))
+        {
+            systick_period_min_ticks = period;
+        }
+        if (period > systick_period_max_ticks)
+        {
+            systick_period_max_ticks = period;
+        }
+    }
+    
+    systick_event_ticks = event->ticks;
+    systick_event_sequence = event->data;
+    systick_event_seen = 1;
+}
+
+void Handle_UART_RX_Event(const Event *event)
+{
+    // The characters themselves are read from the UART0 receive ring by the main loop
+    Record_Event_Wait(EVENT_SOURCE_UART_RX, event);
+}
+
+void Record_Event_Wait(uint8_t source, const Event *event)
+{
+    if (event_drain_ticks <= event->ticks)
+    {
+        return;
+    }
+    
+    uint64_t wait = event_drain_ticks - event->ticks;
+    if (wait > 0xFFFFFFFF)
+    {
+        wait = 0xFFFFFFFF;
+    }
+    if ((uint32_t)wait > event_wait_max_ticks[source])
+    {
+        event_wait_max_ticks[source] = (uint32_t)wait;
+    }
+}
+
+void Play_Game(void)
+{
+    Game_Output_Clear_Screen();
+    Game_Output_String("--- Game Starting ---\r\n\r\n");
+    if (game_mode == GAME_MODE_TWO_PLAYER)
+    {
+        Game_Output_String("Player 1 on SW1, player 2 on SW2: press when the red LED turns on.\r\n");
+        Game_Output_String("Press Enter to abort.\r\n\r\n");
+    }
+    else if (game_mode == GAME_MODE_CHOICE)
+    {
+        Game_Output_String("Red LED: press SW1. Green LED: press SW2. Blue LED: do not press.\r\n");
+        Game_Output_String("Press Enter to abort.\r\n\r\n");
+    }
+    else if (game_mode == GAME_MODE_PVT)
+    {
+        Game_Printf("Vigilance test for %u minutes: press SW1 as soon as the red LED turns on.\r\n", pvt_minutes);
+        Game_Output_String("Press Enter or SW2 to abort.\r\n\r\n");
+    }
+    else
+    {
+        Game_Output_String("Get ready to press SW1 when the red LED turns on.\r\n");
+        Game_Output_String("Press Enter or SW2 to abort.\r\n\r\n");
+    }
+    
+    current_round = 0;
+    session_mode = game_mode;
+    session_player_count = (game_mode == GAME_MODE_TWO_PLAYER) ? 2 : 1;
+    session_rounds = (game_mode == GAME_MODE_PVT) ? PVT_MAX_TRIALS(pvt_minutes) : total_rounds;
+    session_pacing = game_pacing;
+    round_wins[PLAYER_1] = 0;
+    round_wins[PLAYER_2] = 0;
+    round_ties = 0;
+    Statistics_Reset();
+    Histogram_Reset(&session_histogram);
+    for (uint8_t channel = 0; channel < STIMULUS_COUNT; channel++)
+    {
+        dashboard_last_outcome[channel] = RESULT_NO_RESPONSE;
+        dashboard_last_time_us[channel] = 0;
+    }
+    for (uint8_t bin = 0; bin < DASHBOARD_HISTOGRAM_BINS; bin++)
+    {
+        dashboard_histogram[bin] = 0;
+    }
+    Session_Log_Append_Session(session_rounds, session_mode, session_player_count);
+    
+    // Draws the whole stimulus sequence now, so a trial only looks up its stimulus
+    Stimulus_Schedule_Generate(session_rounds, session_mode == GAME_MODE_CHOICE);
+    
+    if (telemetry_mode)
+    {
+        Telemetry_Send_Session_Header(session_rounds, session_mode, session_player_count, Get_Current_Time_Us());
+    }
+    
+    // The dashboard replaces the text from here on, starting from a cleared screen
+    if (dashboard_mode && !telemetry_mode)
+    {
+        Dashboard_Begin();
+        Draw_Dashboard();
+    }
+    
+    // A PVT run starts its clock and its first interval at once
+    if (session_mode == GAME_MODE_PVT)
+    {
+        pvt_end_time = SysTick_Get_Current_Time() + (pvt_minutes * 60000);
+        Begin_Round();
+        return;
+    }
+    
+    // A pacing without the LED test starts the first round at once
+    if (session_pacing.led_test_step_ms == 0)
+    {
+        Begin_Round();
+        return;
+    }
+    
+    // TEST: Checks if GPIO is working
+    Game_Output_String("Testing LEDs... ");
+    LED_On(RED_LED);
+    led_test_step = 0;
+    Enter_State(GAME_LED_TEST, session_pacing.led_test_step_ms, session_pacing.led_test_step_ms);
+}
+
+void Game_Update(void)
+{
+    if (game_state == GAME_IDLE)
+    {
+        return;
+    }
+    
+    uint8_t flags = Get_Button_Flag();
+    if (!flags)
+    {
+        return;
+    }
+    
+    // PVT keeps the button armed through the feedback, which is the start of the next interval,
+    // so a press there is a false start of the next trial
+    if ((session_mode == GAME_MODE_PVT) && (game_state == GAME_FEEDBACK))
+    {
+        PVT_Feedback_False_Start();
+        return;
+    }
+    
+    // In two-player mode a false start only ends the round for that player
+    if ((game_state == GAME_COUNTDOWN) || (game_state == GAME_FOREPERIOD))
+    {
+        Announce_False_Starts(flags);
+    }
+    
+    // The round ends once every player has pressed (choice mode: either button), before
+    // the stimulus as a false start, and during the stimulus with the responses evaluated
+    if (!Round_Complete(flags))
+    {
+        return;
+    }
+    
+    if ((game_state == GAME_COUNTDOWN) || (game_state == GAME_FOREPERIOD))
+    {
+        False_Start();
+    }
+    else if (game_state == GAME_STIMULUS)
+    {
+        Evaluate_Response();
+    }
+}
+
+void Game_Timer_Task(void)
+{
+    PROFILE_START(profile_start);
+    
+    switch (game_state)
+    {
+        case GAME_LED_TEST:
+            led_test_step++;
+            if (led_test_step == 1)
+            {
+                LED_On(BLUE_LED);
+            }
+            else if (led_test_step == 2)
+            {
+                LED_On(GREEN_LED);
+            }
+            else
+            {
+                LED_Off(RED_LED | BLUE_LED | GREEN_LED);
+                Game_Output_String("LED test complete.\r\n\r\n");
+                Begin_Round();
+            }
+            PROFILE_STOP(profile_start, PROFILE_PHASE_LED_TEST);
+            break;
+            
+        case GAME_COUNTDOWN:
+            countdown_value--;
+            if (countdown_value > 0)
+            {
+                Game_Printf("%u ", countdown_value);
+            }
+            else
+            {
+                Game_Output_Newline();
+                Begin_Foreperiod();
+            }
+            PROFILE_STOP(profile_start, PROFILE_PHASE_COUNTDOWN);
+            break;
+            
+        case GAME_FOREPERIOD:
+        {
+            // Presses captured before the deadline are false starts
+            if (Round_Complete(Get_Button_Flag()))
+            {
+                False_Start();
+                PROFILE_STOP(profile_start, PROFILE_PHASE_FOREPERIOD);
+                break;
+            }
+            
+            // Turns on the scheduled LED and starts timing before the message is queued,
+            // so the stimulus onset does not depend on console output
+            uint8_t stimulus = game_results[current_round % RECENT_ROUNDS].stimulus;
+            PROFILE_START(onset_start);
+            LED_Set(stimulus_leds[stimulus]);
+            uint32_t onset_time_us = Mark_Start_Time();
+            PROFILE_STOP(onset_start, PROFILE_STIMULUS_ONSET);
+            game_results[current_round % RECENT_ROUNDS].onset_time_us = onset_time_us;
+            Game_Output_String((session_player_count == 2) ? "Red LED on! Press!\r\n" : stimulus_prompts[stimulus]);
+            
+            // Waits one debounce window past the timeout for a press that started in time
+            Enter_State(GAME_STIMULUS, TIMEOUT_MS + (BUTTON_DEBOUNCE_US / 1000), 0);
+            PROFILE_STOP(profile_start, PROFILE_PHASE_FOREPERIOD);
+            break;
+        }
+            
+        case GAME_STIMULUS:
+            // Presses captured before the deadline win over the timeout
+            if (Get_Button_Flag())
+            {
+                Evaluate_Response();
+                PROFILE_STOP(profile_start, PROFILE_PHASE_STIMULUS);
+                break;
+            }
+            
+            // Timeout - no response
+            No_Response();
+            PROFILE_STOP(profile_start, PROFILE_PHASE_STIMULUS);
+            break;
+            
+        case GAME_FEEDBACK:
+            LED_Off(RED_LED | BLUE_LED | GREEN_LED);
+            Clear_Button_Flag();
+            
+            // PVT trials follow each other at once, the feedback being part of the interval
+            if (session_mode == GAME_MODE_PVT)
+            {
+                Next_Round();
+                PROFILE_STOP(profile_start, PROFILE_PHASE_FEEDBACK);
+                break;
+            }
+            
+            // Short delay between rounds
+            Game_Output_String("Round complete. Next round starting...\r\n\r\n");
+            Enter_State(GAME_INTERTRIAL, session_pacing.intertrial_ms, 0);
+            PROFILE_STOP(profile_start, PROFILE_PHASE_FEEDBACK);
+            break;
+            
+        case GAME_INTERTRIAL:
+            Next_Round();
+            PROFILE_STOP(profile_start, PROFILE_PHASE_INTERTRIAL);
+            break;
+            
+        default:
+            Timer_Wheel_Stop(&game_timer);
+            game_state = GAME_IDLE;
+    }
+}
+
+void Enter_State(GameState state, uint32_t duration_ms, uint32_t period_ms)
+{
+    // Periodic states (LED test steps, countdown ticks) re-run the timer task every period
+    game_state = state;
+    Timer_Wheel_Start(&game_timer, duration_ms, period_ms, &Game_Timer_Task);
+}
+
+void Begin_Round(void)
+{
+    if (session_mode == GAME_MODE_PVT)
+    {
+        Game_Printf("Trial %u, %u s left\r\n", current_round + 1, (pvt_end_time - SysTick_Get_Current_Time()) / 1000);
+    }
+    else
+    {
+        Game_Printf("Round %u of %u - ", current_round + 1, session_rounds);
+    }
+    
+    Reset_Round_Result();
+    Draw_Dashboard();
+    
+    // Resets game state and arms the buttons for the whole round, so early presses are caught
+    LED_Off(RED_LED | BLUE_LED | GREEN_LED);
+    announced_false_starts = 0;
+    GPIO_Enable_Interrupt((session_mode == GAME_MODE_CHOICE) ? PLAYER_COUNT : session_player_count);
+    
+    // PVT: no countdown, the stimulus comes at the end of the interval (less the feedback
+    // already shown), and presses before it are false starts as in the other modes
+    if (session_mode == GAME_MODE_PVT)
+    {
+        uint32_t interval_ms = PVT_INTERVAL_MIN_MS + Random_Below(PVT_INTERVAL_MAX_MS - PVT_INTERVAL_MIN_MS + 1);
+        game_results[current_round % RECENT_ROUNDS].foreperiod_ms = interval_ms;
+        Enter_State(GAME_FOREPERIOD, interval_ms - PVT_FEEDBACK_MS, 0);
+        return;
+    }
+    
+    // A pacing without the countdown goes straight to the foreperiod
+    if (session_pacing.countdown_step_ms == 0)
+    {
+        Begin_Foreperiod();
+        return;
+    }
+    
+    // Countdown from 3
+    countdown_value = COUNTDOWN_START;
+    Game_Printf("Countdown: %u ", countdown_value);
+    Enter_State(GAME_COUNTDOWN, session_pacing.countdown_step_ms, session_pacing.countdown_step_ms);
+}
+
+void Begin_Foreperiod(void)
+{
+    // Random delay before turning on LED
+    uint32_t random_delay = Foreperiod_Draw(foreperiod_distribution);
+    Game_Printf("Random delay: %u ms\r\n", random_delay);
+    game_results[current_round % RECENT_ROUNDS].foreperiod_ms = random_delay;
+    Enter_State(GAME_FOREPERIOD, random_delay, 0);
+}
+
+void Next_Round(void)
+{
+    current_round++;
+    if ((current_round < session_rounds) && !Session_Time_Up())
+    {
+        Begin_Round();
+    }
+    else
+    {
+        game_state = GAME_IDLE;
+        End_Session(0);
+    }
+}
+
+void Reset_Round_Result(void)
+{
+    game_results[current_round % RECENT_ROUNDS].foreperiod_ms = 0;
+    game_results[current_round % RECENT_ROUNDS].onset_time_us = 0;
+    game_results[current_round % RECENT_ROUNDS].winner = PLAYER_TIE;
+    game_results[current_round % RECENT_ROUNDS].stimulus = Stimulus_Schedule_Get(current_round);
+}
+
+uint8_t Session_Time_Up(void)
+{
+    // A PVT run ends with the first trial that would start after its time is up
+    return (session_mode == GAME_MODE_PVT) && ((int32_t)(SysTick_Get_Current_Time() - pvt_end_time) >= 0);
+}
+
+void PVT_Feedback_False_Start(void)
+{
+    // The press ends the next trial as soon as it starts, so that trial gets no banner or drawn
+    // interval: its foreperiod is the time since the feedback (the interval) began
+    LED_Off(RED_LED | BLUE_LED | GREEN_LED);
+    current_round++;
+    if ((current_round >= session_rounds) || Session_Time_Up())
+    {
+        game_state = GAME_IDLE;
+        End_Session(0);
+        return;
+    }
+    
+    Reset_Round_Result();
+    game_results[current_round % RECENT_ROUNDS].foreperiod_ms = SysTick_Get_Current_Time() - pvt_feedback_start;
+    False_Start();
+}
+
+void Evaluate_Response(void)
+{
+    PROFILE_START(profile_start);
+    GPIO_Disable_Interrupt();
+    
+    if ((session_mode == GAME_MODE_TWO_PLAYER) || (session_mode == GAME_MODE_CHOICE))
+    {
+        if (session_mode == GAME_MODE_TWO_PLAYER)
+        {
+            Evaluate_Head_To_Head();
+        }
+        else
+        {
+            Evaluate_Choice();
+        }
+        PROFILE_STOP(profile_start, PROFILE_PHASE_RESPONSE);
+        return;
+    }
+    
+    uint32_t reaction_time_us;
+    uint8_t outcome = Classify_Response(PLAYER_1, &reaction_time_us);
+    
+    // A press that settled after the onset but started before it is a false start,
+    // and a press that started after the timeout only settled inside the debounce window
+    if (outcome == RESULT_FALSE_START)
+    {
+        False_Start();
+    }
+    else if (outcome == RESULT_NO_RESPONSE)
+    {
+        No_Response();
+    }
+    else if (outcome == RESULT_ANTICIPATED)
+    {
+        Record_Result(PLAYER_1, RESULT_ANTICIPATED, reaction_time_us);
+        Game_Output_String("Too fast! Anticipated too early.\r\n");
+        Show_Feedback(0);
+    }
+    else
+    {
+        Record_Result(PLAYER_1, RESULT_VALID, reaction_time_us);
+        if (Game_Text_Enabled())
+        {
+            Report_Printf("Reaction time: %u.%03u ms\r\n", US_AS_MS(reaction_time_us));
+            Report_Send();
+        }
+        Show_Feedback(1);
+    }
+    
+    PROFILE_STOP(profile_start, PROFILE_PHASE_RESPONSE);
+}
+
+void Evaluate_Head_To_Head(void)
+{
+    uint32_t reaction_time_us[PLAYER_COUNT];
+    uint8_t outcome[PLAYER_COUNT];
+    
+    for (uint8_t player = 0; player < PLAYER_COUNT; player++)
+    {
+        outcome[player] = Classify_Response(player, &reaction_time_us[player]);
+        Record_Result(player, outcome[player], reaction_time_us[player]);
+        
+        if (Game_Text_Enabled())
+        {
+            Report_Printf("Player %u - ", player + 1);
+            Report_Outcome(outcome[player], reaction_time_us[player]);
+            Report_String("\r\n");
+            Report_Send();
+        }
+    }
+    
+    // Both valid: the earlier press edge wins, compared in timer ticks rather than microseconds
+    uint8_t winner = PLAYER_TIE;
+    if ((outcome[PLAYER_1] == RESULT_VALID) && (outcome[PLAYER_2] == RESULT_VALID))
+    {
+        winner = Get_First_Player();
+    }
+    else if (outcome[PLAYER_1] == RESULT_VALID)
+    {
+        winner = PLAYER_1;
+    }
+    else if (outcome[PLAYER_2] == RESULT_VALID)
+    {
+        winner = PLAYER_2;
+    }
+    Record_Winner(winner);
+    
+    if (winner == PLAYER_TIE)
+    {
+        Game_Output_String(((outcome[PLAYER_1] == RESULT_VALID) && (outcome[PLAYER_2] == RESULT_VALID)) ?
+                           "Dead heat! Both presses in the same clock cycle.\r\n" : "No winner this round.\r\n");
+    }
+    else
+    {
+        Game_Printf("Player %u wins the round!\r\n", winner + 1);
+    }
+    
+    Show_Feedback(winner != PLAYER_TIE);
+}
+
+void Evaluate_Choice(void)
+{
+    uint8_t stimulus = game_results[current_round % RECENT_ROUNDS].stimulus;
+    
+    // The first button pressed is the response (both in the same clock cycle is a wrong button)
+    uint8_t button = Get_First_Player();
+    uint32_t reaction_time_us;
+    uint8_t outcome = Classify_Response((button == PLAYER_TIE) ? PLAYER_1 : button, &reaction_time_us);
+    
+    if (outcome == RESULT_FALSE_START)
+    {
+        False_Start();
+        return;
+    }
+    if (outcome == RESULT_NO_RESPONSE)
+    {
+        No_Response();
+        return;
+    }
+    
+    // Any press in time is an error for the no-go stimulus, and so is the wrong button
+    if (stimulus_buttons[stimulus] == PLAYER_TIE)
+    {
+        outcome = RESULT_NO_GO_PRESS;
+    }
+    else if (button != stimulus_buttons[stimulus])
+    {
+        outcome = RESULT_WRONG_BUTTON;
+    }
+    Record_Result(PLAYER_1, outcome, reaction_time_us);
+    
+    if (outcome == RESULT_VALID)
+    {
+        if (Game_Text_Enabled())
+        {
+            Report_Printf("Correct! Reaction time: %u.%03u ms\r\n", US_AS_MS(reaction_time_us));
+            Report_Send();
+        }
+    }
+    else
+    {
+        Game_Output_String((outcome == RESULT_NO_GO_PRESS) ? "Wrong! Blue means do not press.\r\n" :
+                           (outcome == RESULT_WRONG_BUTTON) ? "Wrong button!\r\n" :
+                                                              "Too fast! Anticipated too early.\r\n");
+    }
+    
+    Show_Feedback(outcome == RESULT_VALID);
+}
+
+void Show_Feedback(uint8_t correct)
+{
+    // Choice stimuli use every color, so choice feedback uses mixed colors instead:
+    // white when correct, magenta otherwise
+    if (session_mode == GAME_MODE_CHOICE)
+    {
+        LED_Set(correct ? (RED_LED | BLUE_LED | GREEN_LED) : (RED_LED | BLUE_LED));
+    }
+    else
+    {
+        LED_Set(correct ? GREEN_LED : BLUE_LED);
+    }
+    Draw_Dashboard();
+    
+    // The PVT interval starts with the feedback, so presses during it are caught too
+    if (session_mode == GAME_MODE_PVT)
+    {
+        pvt_feedback_start = SysTick_Get_Current_Time();
+        GPIO_Enable_Interrupt(1);
+    }
+    Enter_State(GAME_FEEDBACK, (session_mode == GAME_MODE_PVT) ? PVT_FEEDBACK_MS : session_pacing.feedback_ms, 0);
+}
+
+uint8_t Classify_Response(uint8_t player, uint32_t *reaction_time_us)
+{
+    *reaction_time_us = 0;
+    
+    if (!(Get_Button_Flag() & (1 << player)))
+    {
+        return RESULT_NO_RESPONSE;
+    }
+    
+    if (Is_False_Start(player))
+    {
+        return RESULT_FALSE_START;
+    }
+    
+    uint32_t reaction_time = Get_Reaction_Time(player);  // In microseconds
+    if (reaction_time >= TIMEOUT_US)
+    {
+        return RESULT_NO_RESPONSE;
+    }
+    
+    *reaction_time_us = reaction_time;
+    
+    // Checks for anticipation (too fast)
+    return (reaction_time < ANTICIPATION_THRESHOLD_US) ? RESULT_ANTICIPATED : RESULT_VALID;
+}
+
+void No_Response(void)
+{
+    GPIO_Disable_Interrupt();
+    
+    // No press is the correct response to the no-go stimulus
+    if ((session_mode == GAME_MODE_CHOICE) &&
+        (stimulus_buttons[game_results[current_round % RECENT_ROUNDS].stimulus] == PLAYER_TIE))
+    {
+        Record_Result(PLAYER_1, RESULT_WITHHELD, 0);
+        Game_Output_String("Correct! No press.\r\n");
+        Show_Feedback(1);
+        return;
+    }
+    
+    for (uint8_t player = 0; player < session_player_count; player++)
+    {
+        Record_Result(player, RESULT_NO_RESPONSE, 0);
+    }
+    Record_Winner(PLAYER_TIE);
+    Game_Output_String("Too slow! No response.\r\n");
+    Show_Feedback(0);
+}
+
+void False_Start(void)
+{
+    // Ends the round without a stimulus
+    GPIO_Disable_Interrupt();
+    game_results[current_round % RECENT_ROUNDS].onset_time_us = 0;
+    for (uint8_t player = 0; player < session_player_count; player++)
+    {
+        Record_Result(player, RESULT_FALSE_START, 0);
+    }
+    Record_Winner(PLAYER_TIE);
+    Game_Output_String((session_mode == GAME_MODE_TWO_PLAYER) ? "\r\nBoth players jumped the gun! No winner this round.\r\n" :
+                       (session_mode == GAME_MODE_CHOICE) ? "\r\nFalse start! A button was pressed before the LED.\r\n" :
+                                                            "\r\nFalse start! SW1 was pressed before the red LED.\r\n");
+    Show_Feedback(0);
+}
+
+void Announce_False_Starts(uint8_t flags)
+{
+    // Reports each two-player false start once, while the other player's round goes on
+    if (session_player_count < 2)
+    {
+        return;
+    }
+    
+    for (uint8_t player = 0; player < PLAYER_COUNT; player++)
+    {
+        uint8_t bit = 1 << player;
+        if ((flags & bit) && !(announced_false_starts & bit))
+        {
+            announced_false_starts |= bit;
+            Game_Printf("\r\nFalse start by player %u!\r\n", player + 1);
+        }
+    }
+}
+
+void Record_Result(uint8_t player, uint8_t outcome, uint32_t reaction_time_us)
+{
+    RoundResult *result = &game_results[current_round % RECENT_ROUNDS];
+    
+    result->outcome[player] = outcome;
+    result->reaction_time[player] = reaction_time_us;
+    
+    // Choice mode keeps statistics per stimulus color, the other modes per player
+    Statistics_Add_Trial((session_mode == GAME_MODE_CHOICE) ? result->stimulus : player, outcome, reaction_time_us);
+    Session_Log_Append_Round(current_round, player, result->stimulus, outcome, result->foreperiod_ms, reaction_time_us);
+    if (outcome == RESULT_VALID)
+    {
+        Histogram_Record(&session_histogram, reaction_time_us);
+    }
+    
+    // The dashboard has a row per statistics channel
+    uint8_t channel = (session_mode == GAME_MODE_CHOICE) ? result->stimulus : player;
+    dashboard_last_outcome[channel] = outcome;
+    dashboard_last_time_us[channel] = reaction_time_us;
+    if (outcome == RESULT_VALID)
+    {
+        uint32_t bin = (reaction_time_us > DASHBOARD_HISTOGRAM_MIN_US) ?
+                       ((reaction_time_us - DASHBOARD_HISTOGRAM_MIN_US) / DASHBOARD_HISTOGRAM_BIN_US) : 0;
+        dashboard_histogram[(bin < DASHBOARD_HISTOGRAM_BINS) ? bin : (DASHBOARD_HISTOGRAM_BINS - 1)]++;
+    }
+    
+    if (telemetry_mode)
+    {
+        Telemetry_Send_Round(current_round, player, result->stimulus, outcome, result->foreperiod_ms,
+                             result->onset_time_us, reaction_time_us);
+    }
+}
+
+void Record_Winner(uint8_t winner)
+{
+    game_results[current_round % RECENT_ROUNDS].winner = winner;
+    
+    if (session_player_count < 2)
+    {
+        return;
+    }
+    
+    if (winner == PLAYER_TIE)
+    {
+        round_ties++;
+    }
+    else
+    {
+        round_wins[winner]++;
+    }
+}
+
+uint8_t All_Players(void)
+{
+    // Button flag mask with a bit for every player in the game
+    return (1 << session_player_count) - 1;
+}
+
+uint8_t Round_Complete(uint8_t flags)
+{
+    // Choice mode takes the first press on either button, the other modes wait for every player
+    return (session_mode == GAME_MODE_CHOICE) ? (flags != 0) : (flags == All_Players());
+}
+
+void Abort_Game(void)
+{
+    Timer_Wheel_Stop(&game_timer);
+    GPIO_Disable_Interrupt();
+    Clear_Button_Flag();
+    LED_Off(RED_LED | BLUE_LED | GREEN_LED);
+    game_state = GAME_IDLE;
+    
+    // Keeps the rounds completed before the abort
+    Game_Output_String("\r\nGame aborted.\r\n");
+    End_Session(1);
+}
+
+void End_Session(uint8_t aborted)
+{
+    Histogram_Merge(&all_histogram, &session_histogram);
+    
+    // Telemetry sessions end with a record instead of the results screen
+    if (telemetry_mode)
+    {
+        Telemetry_Send_Session_End(current_round, aborted);
+        Display_Menu();
+    }
+    else
+    {
+        Display_Results(0);
+    }
+}
+
+void Restore_Last_Session(void)
+{
+    uint16_t count = Session_Log_Get_Count();
+    Session_Log_Record record;
+    
+    // Finds the newest session record
+    uint16_t index = count;
+    while (index > 0)
+    {
+        index--;
+        if (Session_Log_Read(index, &record) && (record.type == SESSION_LOG_SESSION))
+        {
+            break;
+        }
+    }
+    
+    if ((index == count) || (record.type != SESSION_LOG_SESSION))
+    {
+        return;
+    }
+    
+    // Replays its rounds into the results table and the statistics
+    current_round = 0;
+    session_player_count = (record.player_count == 2) ? 2 : 1;
+    session_mode = ((record.game_mode == GAME_MODE_CHOICE) || (record.game_mode == GAME_MODE_PVT)) ?
+                   (GameMode)record.game_mode : (session_player_count == 2) ? GAME_MODE_TWO_PLAYER : GAME_MODE_SIMPLE;
+    session_rounds = record.total_rounds;
+    round_wins[PLAYER_1] = 0;
+    round_wins[PLAYER_2] = 0;
+    round_ties = 0;
+    
+    for (index++; index < count; index++)
+    {
+        if (!Session_Log_Read(index, &record) || (record.type != SESSION_LOG_ROUND) ||
+            (record.round_index != (current_round & 0x0F)) || (record.player >= session_player_count))
+        {
+            break;
+        }
+        
+        RoundResult *result = &game_results[current_round % RECENT_ROUNDS];
+        result->outcome[record.player] = record.result;
+        result->reaction_time[record.player] = record.reaction_time_us;
+        result->foreperiod_ms = record.foreperiod_ms;
+        result->onset_time_us = 0;
+        result->stimulus = record.stimulus;
+        Statistics_Add_Trial((session_mode == GAME_MODE_CHOICE) ? record.stimulus : record.player, record.result,
+                             record.reaction_time_us);
+        if (record.result == RESULT_VALID)
+        {
+            Histogram_Record(&session_histogram, record.reaction_time_us);
+        }
+        
+        // A round is complete after its last player's record
+        if (record.player == (session_player_count - 1))
+        {
+            if (session_player_count == 2)
+            {
+                // The tick order is not logged, so equal microseconds are restored as a tie
+                uint8_t winner = PLAYER_TIE;
+                uint8_t valid_1 = (result->outcome[PLAYER_1] == RESULT_VALID);
+                uint8_t valid_2 = (result->outcome[PLAYER_2] == RESULT_VALID);
+                if (valid_1 && (!valid_2 || (result->reaction_time[PLAYER_1] < result->reaction_time[PLAYER_2])))
+                {
+                    winner = PLAYER_1;
+                }
+                else if (valid_2 && (!valid_1 || (result->reaction_time[PLAYER_2] < result->reaction_time[PLAYER_1])))
+                {
+                    winner = PLAYER_2;
+                }
+                Record_Winner(winner);
+            }
+            current_round++;
+        }
+    }
+    
+    Histogram_Merge(&all_histogram, &session_histogram);
+}
+
+void Display_Results(uint8_t include_history)
+{
+    UART0_Clear_Screen();
+    Report_String("--- Game Results ---\r\n\r\n");
+    
+    // Lists the most recent rounds, then the statistics for the whole session
+    uint16_t first_round = (current_round > RECENT_ROUNDS) ? (current_round - RECENT_ROUNDS) : 0;
+    if (first_round > 0)
+    {
+        Report_Printf("Last %u of %u rounds:\r\n\r\n", RECENT_ROUNDS, current_round);
+    }
+    
+    for (uint16_t i = first_round; i < current_round; i++)
+    {
+        RoundResult *result = &game_results[i % RECENT_ROUNDS];
+        
+        Report_Printf("Round %u: ", i + 1);
+        
+        if (session_mode == GAME_MODE_CHOICE)
+        {
+            Report_Printf("%s - ", stimulus_names[result->stimulus]);
+            Report_Outcome(result->outcome[PLAYER_1], result->reaction_time[PLAYER_1]);
+            Report_String("\r\n");
+        }
+        else if (session_player_count == 2)
+        {
+            Report_String("P1 ");
+            Report_Outcome(result->outcome[PLAYER_1], result->reaction_time[PLAYER_1]);
+            Report_String(", P2 ");
+            Report_Outcome(result->outcome[PLAYER_2], result->reaction_time[PLAYER_2]);
+            if (result->winner == PLAYER_TIE)
+            {
+                Report_String(" - no winner\r\n");
+            }
+            else
+            {
+                Report_Printf(" - player %u wins\r\n", result->winner + 1);
+            }
+        }
+        else
+        {
+            Report_Outcome(result->outcome[PLAYER_1], result->reaction_time[PLAYER_1]);
+            Report_String("\r\n");
+        }
+    }
+    
+    Report_Session_Statistics(1);
+    
+    if (include_history)
+    {
+        Display_History();
+    }
+    
+    Report_String("\r\nPress Enter to continue...");
+    Report_Send();
+    
+    // The main loop returns to the menu on the next key
+    awaiting_key = 1;
+}
+
+void Report_Session_Statistics(uint8_t rate_performance)
+{
+    Statistics_Summary summary;
+    
+    if (session_mode == GAME_MODE_CHOICE)
+    {
+        uint32_t trials = 0;
+        uint32_t correct = 0;
+        
+        for (uint8_t stimulus = 0; stimulus < STIMULUS_COUNT; stimulus++)
+        {
+            Statistics_Get_Summary(stimulus, &summary);
+            Report_Choice_Summary(stimulus, &summary);
+            trials += summary.trials;
+            correct += summary.valid + summary.withheld;
+        }
+        
+        Report_Printf("\r\nOverall accuracy: %u of %u correct\r\n", correct, trials);
+    }
+    else if (session_player_count == 2)
+    {
+        for (uint8_t player = 0; player < PLAYER_COUNT; player++)
+        {
+            Statistics_Get_Summary(player, &summary);
+            Report_Printf("\r\n--- Player %u ---\r\n", player + 1);
+            Report_Summary(&summary);
+        }
+        
+        Report_Printf("\r\nRounds won - player 1: %u, player 2: %u, no winner: %u\r\n",
+                      round_wins[PLAYER_1], round_wins[PLAYER_2], round_ties);
+        
+        if (round_wins[PLAYER_1] == round_wins[PLAYER_2])
+        {
+            Report_String("The match is a draw!\r\n");
+        }
+        else
+        {
+            Report_Printf("Player %u wins the match!\r\n", (round_wins[PLAYER_1] > round_wins[PLAYER_2]) ? 1 : 2);
+        }
+    }
+    else
+    {
+        Statistics_Get_Summary(PLAYER_1, &summary);
+        Report_Summary(&summary);
+        if (session_mode == GAME_MODE_PVT)
+        {
+            // PVT scoring counts a missed stimulus as a lapse too
+            Report_Printf("PVT lapses (over %u ms or missed) - %u of %u stimuli\r\n", STATISTICS_LAPSE_US / 1000,
+                          summary.lapses + summary.no_responses, summary.trials - summary.false_starts);
+            
+            // It also counts a response faster than the anticipation threshold as a false start
+            Report_Printf("PVT false starts (before the stimulus or under %u ms) - %u\r\n",
+                          ANTICIPATION_THRESHOLD_US / 1000, summary.false_starts + summary.anticipations);
+        }
+        if (rate_performance && (summary.valid > 0))
+        {
+            Declare_Winner(&summary);
+        }
+    }
+}
+
+void Display_History(void)
+{
+    // Flushes pending records so the last game is included
+    Session_Log_Flush();
+    
+    Report_String("\r\n--- Recent Sessions (newest first) ---\r\n\r\n");
+    
+    if (!Session_Log_Available())
+    {
+        Report_String("Session log unavailable (EEPROM error).\r\n");
+        return;
+    }
+    
+    // Walks the log backwards, totalling each session's rounds until its session record
+    uint16_t index = Session_Log_Get_Count();
+    uint8_t sessions = 0;
+    uint16_t rounds = 0;
+    uint16_t valid_responses = 0;
+    uint32_t total_valid_time = 0;
+    Session_Log_Record record;
+    
+    while ((index > 0) && (sessions < HISTORY_SESSIONS))
+    {
+        index--;
+        if (!Session_Log_Read(index, &record))
+        {
+            break;
+        }
+        
+        if (record.type == SESSION_LOG_ROUND)
+        {
+            // Two-player rounds have a record per player, and the averages include both
+            if (record.player == PLAYER_1)
+            {
+                rounds++;
+            }
+            if (record.result == RESULT_VALID)
+            {
+                total_valid_time += record.reaction_time_us;
+                valid_responses++;
+            }
+            continue;
+        }
+        
+        sessions++;
+        // PVT runs are timed, so their planned rounds are only a limit
+        if (record.game_mode == GAME_MODE_PVT)
+        {
+            Report_Printf("Session %u - %u trials (PVT), %u valid", sessions, rounds, valid_responses);
+        }
+        else
+        {
+            Report_Printf("Session %u - %u of %u rounds%s, %u valid", sessions, rounds, record.total_rounds,
+                          (record.game_mode == GAME_MODE_CHOICE) ? " (choice)" : (record.player_count == 2) ? " (two players)" : "",
+                          valid_responses);
+        }
+        
+        if (valid_responses > 0)
+        {
+            Report_Printf(", average %u.%03u ms\r\n", US_AS_MS(total_valid_time / valid_responses));
+        }
+        else
+        {
+            Report_String("\r\n");
+        }
+        
+        rounds = 0;
+        valid_responses = 0;
+        total_valid_time = 0;
+    }
+    
+    if (sessions == 0)
+    {
+        Report_String("No sessions recorded.\r\n");
+    }
+    
+    if (Session_Log_Get_Dropped_Count() > 0)
+    {
+        Report_Printf("Records dropped (log queue full): %u\r\n", Session_Log_Get_Dropped_Count());
+    }
+}
+
+void Display_Diagnostics(void)
+{
+    UART0_Clear_Screen();
+    Report_String("--- Diagnostics ---\r\n\r\n");
+    Report_Printf("Random seed: %u\r\n\r\n", Random_Get_Seed());
+    Display_Power_Stats();
+    Report_Calibration();
+    Report_Event_Queues();
+    Report_Dashboard();
+    if (UART0_Get_RX_Dropped_Count() > 0)
+    {
+        Report_Printf("Received characters dropped (RX buffer full): %u\r\n\r\n", UART0_Get_RX_Dropped_Count());
+    }
+
+#if PROFILE_ENABLED
+    Report_String("Core clock cycles per call - count, min / mean / max\r\n\r\n");
+    
+    for (uint8_t i = 0; i < PROFILE_PROBE_COUNT; i++)
+    {
+        Profile_Stats stats;
+        Profile_Get_Stats(i, &stats);
+        
+        if (stats.count > 0)
+        {
+            Report_Printf("%s: %u, %u / %u / %u\r\n", Profile_Get_Name(i), stats.count, stats.min_cycles,
+                          (uint32_t)(stats.total_cycles / stats.count), stats.max_cycles);
+        }
+        else
+        {
+            Report_Printf("%s: 0\r\n", Profile_Get_Name(i));
+        }
+    }
+#else
+    Report_String("Profiling is disabled in this build (PROFILE_ENABLED = 0).\r\n");
+#endif
+    
+    Report_String("\r\nPress Enter to continue...");
+    Report_Send();
+    
+    // The main loop returns to the menu on the next key
+    awaiting_key = 1;
+}
+
+void Display_Power_Stats(void)
+{
+    Power_Stats stats;
+    Power_Get_Stats(&stats);
+    
+    // Active share of the elapsed core clock cycles, in thousandths of a percent
+    uint64_t elapsed_cycles = stats.elapsed_ms * (SYSTEM_CLOCK_HZ / 1000);
+    uint32_t active_share = (elapsed_cycles > 0) ? (uint32_t)((stats.active_cycles * 100000) / elapsed_cycles) : 0;
+    
+    Report_Printf("Power since reset: %u s\r\n", (uint32_t)(stats.elapsed_ms / 1000));
+    Report_Printf("Active: %u.%03u%%, asleep the rest, %u wake-ups\r\n", active_share / 1000, active_share % 1000,
+                  stats.sleep_count);
+    Report_Printf("Deep sleep: %u s in %u periods\r\n\r\n", (uint32_t)(stats.deep_sleep_ms / 1000),
+                  stats.deep_sleep_count);
+}
+
+void Report_Calibration(void)
+{
+    Calibration_Stats stats;
+    Calibration_Get_Stats(&stats);
+    
+    if (!Calibration_Is_Calibrated())
+    {
+        Report_String("Latency calibration: none (run calibrate with PB3 wired to PB2)\r\n\r\n");
+        return;
+    }
+    
+    // One timer tick is one system clock cycle
+    Report_Printf("Latency offset: %d ticks (%d ns), subtracted from reaction times\r\n", stats.offset_ticks,
+                  (stats.offset_ticks * 1000) / SYSTEM_CLOCK_TICKS_PER_US);
+    if (stats.pairs == 0)
+    {
+        Report_String("(saved by an earlier calibration)\r\n\r\n");
+        return;
+    }
+    
+    uint32_t mean_magnitude = (stats.mean_ticks_x100 < 0) ? -stats.mean_ticks_x100 : stats.mean_ticks_x100;
+    Report_Printf("Pairs: %u, min / mean / max: %d / %s%u.%02u / %d ticks, std dev: %u.%02u ticks\r\n", stats.pairs,
+                  stats.min_ticks, (stats.mean_ticks_x100 < 0) ? "-" : "", mean_magnitude / 100,
+                  mean_magnitude % 100, stats.max_ticks, stats.std_dev_ticks_x100 / 100,
+                  stats.std_dev_ticks_x100 % 100);
+    Report_String("Jitter, pairs by distance from the offset in ticks -");
+    for (uint8_t bin = 0; bin < CALIBRATION_HISTOGRAM_BINS; bin++)
+    {
+        if (stats.histogram[bin] == 0)
+        {
+            continue;
+        }
+        
+        if (bin == 0)
+        {
+            Report_Printf(" 0: %u", stats.histogram[bin]);
+        }
+        else if (bin == (CALIBRATION_HISTOGRAM_BINS - 1))
+        {
+            Report_Printf(" %u+: %u", 1 << (bin - 1), stats.histogram[bin]);
+        }
+        else
+        {
+            Report_Printf(" %u-%u: %u", 1 << (bin - 1), (1 << bin) - 1, stats.histogram[bin]);
+        }
+    }
+    Report_String("\r\n\r\n");
+}
+
+void Report_Event_Queues(void)
+{
+    Report_String("Event queues - posted, dropped (queue full), most waiting, longest wait\r\n");
+    for (uint8_t source = 0; source < EVENT_SOURCE_COUNT; source++)
+    {
+        Event_Queue_Stats stats;
+        Event_Queue_Get_Stats(source, &stats);
+        
+        // One timer tick is one system clock cycle
+        uint32_t wait_ns = (uint32_t)(((uint64_t)event_wait_max_ticks[source] * 1000) / SYSTEM_CLOCK_TICKS_PER_US);
+        Report_Printf("%s: %u, %u, %u, %u.%03u us\r\n", event_source_names[source], stats.posted, stats.dropped,
+                      stats.peak_depth, wait_ns / 1000, wait_ns % 1000);
+    }
+    
+    Report_Printf("Button events - %u edges, %u bounces ignored, %u presses, %u releases, %u glitches\r\n",
+                  button_event_counts[EVENT_BUTTON_EDGE], button_event_counts[EVENT_BUTTON_BOUNCE],
+                  button_event_counts[EVENT_BUTTON_PRESS], button_event_counts[EVENT_BUTTON_RELEASE],
+                  button_event_counts[EVENT_BUTTON_GLITCH]);
+    if (systick_period_max_ticks > 0)
+    {
+        uint32_t min_ns = (uint32_t)(((uint64_t)systick_period_min_ticks * 1000) / SYSTEM_CLOCK_TICKS_PER_US);
+        uint32_t max_ns = (uint32_t)(((uint64_t)systick_period_max_ticks * 1000) / SYSTEM_CLOCK_TICKS_PER_US);
+        Report_Printf("SysTick period: %u.%03u to %u.%03u us\r\n", min_ns / 1000, min_ns % 1000, max_ns / 1000,
+                      max_ns % 1000);
+    }
+    Report_String("\r\n");
+}
+
+void Report_Dashboard(void)
+{
+    Dashboard_Stats stats;
+    Dashboard_Get_Stats(&stats);
+    
+    if (stats.redraws == 0)
+    {
+        return;
+    }
+    
+    Report_Printf("Dashboard: %u first frames, %u bytes on average\r\n", stats.redraws,
+                  stats.redraw_bytes / stats.redraws);
+    Report_Printf("Dashboard updates: %u, %u bytes on average, %u at most\r\n\r\n", stats.updates,
+                  (stats.updates > 0) ? (stats.total_bytes / stats.updates) : 0, stats.max_bytes);
+}
+
+void Draw_Dashboard(void)
+{
+    if (!dashboard_mode || telemetry_mode)
+    {
+        return;
+    }
+    
+    // Every field has a fixed width, so a changed value overwrites exactly its own cells
+    Dashboard_Clear();
+    Dashboard_Printf(0, 0, "--- Live Dashboard: %s ---", game_mode_names[session_mode]);
+    if (session_mode == GAME_MODE_PVT)
+    {
+        Dashboard_Printf(2, 0, "Trial %4u", current_round + 1);
+    }
+    else
+    {
+        Dashboard_Printf(2, 0, "Round %4u of %u", current_round + 1, session_rounds);
+    }
+    Dashboard_Printf(4, 0, "%-12s%9s%9s%9s%9s", "", "Last", "Mean", "Median", "Valid");
+    
+    uint8_t rows = (session_mode == GAME_MODE_CHOICE) ? STIMULUS_COUNT : session_player_count;
+    for (uint8_t channel = 0; channel < rows; channel++)
+    {
+        Statistics_Summary summary;
+        Statistics_Get_Summary(channel, &summary);
+        
+        uint8_t row = 5 + channel;
+        if (session_mode == GAME_MODE_CHOICE)
+        {
+            Dashboard_Printf(row, 0, "%s", stimulus_names[channel]);
+        }
+        else
+        {
+            Dashboard_Printf(row, 0, "Player %u", channel + 1);
+        }
+        
+        if (summary.trials == 0)
+        {
+            continue;
+        }
+        
+        if (dashboard_last_outcome[channel] == RESULT_VALID)
+        {
+            Dashboard_Printf(row, 12, "%5u.%03u", US_AS_MS(dashboard_last_time_us[channel]));
+        }
+        else
+        {
+            Dashboard_Printf(row, 12, "%9s", dashboard_outcome_names[dashboard_last_outcome[channel]]);
+        }
+        if (summary.valid > 0)
+        {
+            Dashboard_Printf(row, 21, "%5u.%03u%5u.%03u", US_AS_MS(summary.mean_us), US_AS_MS(summary.median_us));
+        }
+        // The no-go color counts withheld responses instead of valid ones
+        uint8_t no_go = (session_mode == GAME_MODE_CHOICE) && (stimulus_buttons[channel] == PLAYER_TIE);
+        Dashboard_Printf(row, 39, "%4u/%-4u", no_go ? summary.withheld : summary.valid, summary.trials);
+    }
+    
+    // Histogram as a sparkline: each bin's height relative to the tallest, with any
+    // non-empty bin at least one level up
+    uint16_t tallest = 0;
+    for (uint8_t bin = 0; bin < DASHBOARD_HISTOGRAM_BINS; bin++)
+    {
+        if (dashboard_histogram[bin] > tallest)
+        {
+            tallest = dashboard_histogram[bin];
+        }
+    }
+    
+    Dashboard_Printf(9, 0, "%u ms |", DASHBOARD_HISTOGRAM_MIN_US / 1000);
+    for (uint8_t bin = 0; bin < DASHBOARD_HISTOGRAM_BINS; bin++)
+    {
+        uint8_t level = 0;
+        if (dashboard_histogram[bin] > 0)
+        {
+            level = (uint8_t)(((dashboard_histogram[bin] * (sizeof(dashboard_levels) - 2)) + tallest - 1) / tallest);
+        }
+        Dashboard_Put(9, 8 + bin, dashboard_levels[level]);
+    }
+    Dashboard_Printf(9, 8 + DASHBOARD_HISTOGRAM_BINS, "| %u+ ms", DASHBOARD_HISTOGRAM_LAST_US / 1000);
+    Dashboard_Printf(10, 0, "%s", ((session_mode == GAME_MODE_SIMPLE) || (session_mode == GAME_MODE_PVT)) ?
+                                  "Press Enter or SW2 to abort." : "Press Enter to abort.");
+    
+    Dashboard_Update();
+}
+
+void Declare_Winner(const Statistics_Summary *summary)
+{
+    // Rates the session by its mean reaction time in ms
+    uint32_t average_time = summary->mean_us / 1000;
+    
+    Report_String("\r\n--- Performance Rating ---\r\n\r\n");
+    
+    if (average_time < 150)
+    {
+        Report_String("Excellent! Pro gamer level!\r\n");
+    }
+    else if (average_time < 200)
+    {
+        Report_String("Very good! Above average!\r\n");
+    }
+    else if (average_time < 250)
+    {
+        Report_String("Good! Average human reaction time.\r\n");
+    }
+    else if (average_time < 300)
+    {
+        Report_String("Ok. Not too bad.\r\n");
+    }
+    else
+    {
+        Report_String("Too slow. Try to be faster!\r\n");
+    }
+}
+
+uint8_t Game_Text_Enabled(void)
+{
+    return !telemetry_mode && !dashboard_mode;
+}
+
+void Game_Output_String(char *pt)
+{
+    if (Game_Text_Enabled())
+    {
+        UART0_Output_String(pt);
+    }
+}
+
+void Game_Printf(const char *format, ...)
+{
+    char line[UART0_PRINTF_LINE_SIZE];
+    va_list args;
+    
+    if (!Game_Text_Enabled())
+    {
+        return;
+    }
+    
+    va_start(args, format);
+    Format_Vector(line, sizeof(line), format, args);
+    va_end(args);
+    UART0_Output_String(line);
+}
+
+void Game_Output_Newline(void)
+{
+    if (Game_Text_Enabled())
+    {
+        UART0_Output_Newline();
+    }
+}
+
+void Game_Output_Clear_Screen(void)
+{
+    if (Game_Text_Enabled())
+    {
+        UART0_Clear_Screen();
+    }
+}
+
+void Report_String(char *pt)
+{
+    while (*pt)
+    {
+        if (report_length == sizeof(report_buffer))
+        {
+            Report_Send();
+        }
+        report_buffer[report_length++] = *pt;
+        pt++;
+    }
+}
+
+void Report_Printf(const char *format, ...)
+{
+    PROFILE_START(profile_start);
+    va_list args;
+    va_list retry;
+    
+    va_start(args, format);
+    va_copy(retry, args);
+    
+    // Renders straight into the report buffer, sending the buffer first if the line does not fit
+    uint16_t length = Format_Vector(&report_buffer[report_length], sizeof(report_buffer) - report_length, format, args);
+    if (length >= (sizeof(report_buffer) - report_length))
+    {
+        Report_Send();
+        length = Format_Vector(report_buffer, sizeof(report_buffer), format, retry);
+        if (length >= sizeof(report_buffer))
+        {
+            length = sizeof(report_buffer) - 1;
+        }
+    }
+    report_length += length;
+    
+    va_end(retry);
+    va_end(args);
+    PROFILE_STOP(profile_start, PROFILE_REPORT_PRINTF);
+}
+
+void Report_Outcome(uint8_t outcome, uint32_t reaction_time_us)
+{
+    switch (outcome)
+    {
+        case RESULT_VALID:
+            Report_Printf("%u.%03u ms", US_AS_MS(reaction_time_us));
+            break;
+            
+        case RESULT_ANTICIPATED:
+            Report_String("Anticipated too early");
+            break;
+            
+        case RESULT_FALSE_START:
+            Report_String("False start");
+            break;
+            
+        case RESULT_WRONG_BUTTON:
+            Report_String("Wrong button");
+            break;
+            
+        case RESULT_NO_GO_PRESS:
+            Report_String("Pressed on blue");
+            break;
+            
+        case RESULT_WITHHELD:
+            Report_String("Withheld");
+            break;
+            
+        default:
+            Report_String("No response");
+    }
+}
+
+void Report_Summary(const Statistics_Summary *summary)
+{
+    Report_Printf("\r\nValid responses: %u of %u (%u anticipated, %u false starts, %u missed)\r\n",
+                  summary->valid, summary->trials, summary->anticipations, summary->false_starts,
+                  summary->no_responses);
+    
+    if (summary->valid == 0)
+    {
+        Report_String("\r\nNo valid responses recorded.\r\n");
+        return;
+    }
+    
+    Report_Printf("\r\nAverage reaction time: %u.%03u ms\r\n", US_AS_MS(summary->mean_us));
+    Report_Printf("Standard deviation: %u.%03u ms\r\n", US_AS_MS(summary->std_dev_us));
+    Report_Printf("Fastest: %u.%03u ms\r\n", US_AS_MS(summary->min_us));
+    Report_Printf("Median: %u.%03u ms\r\n", US_AS_MS(summary->median_us));
+    Report_Printf("90th percentile: %u.%03u ms\r\n", US_AS_MS(summary->p90_us));
+    Report_Printf("99th percentile: %u.%03u ms\r\n", US_AS_MS(summary->p99_us));
+    Report_Printf("Slowest: %u.%03u ms\r\n", US_AS_MS(summary->max_us));
+    Report_Printf("Lapses (over %u ms) - %u\r\n", STATISTICS_LAPSE_US / 1000, summary->lapses);
+}
+
+void Report_Choice_Summary(uint8_t stimulus, const Statistics_Summary *summary)
+{
+    Report_Printf("\r\n--- %s %s ---\r\n", stimulus_names[stimulus],
+                  (stimulus_buttons[stimulus] == PLAYER_TIE) ? "(do not press)" :
+                  (stimulus_buttons[stimulus] == PLAYER_1) ? "(SW1)" : "(SW2)");
+    
+    // The no-go color has no reaction times, only withheld responses and errors
+    if (stimulus_buttons[stimulus] == PLAYER_TIE)
+    {
+        Report_Printf("\r\nWithheld: %u of %u (%u pressed, %u false starts)\r\n", summary->withheld, summary->trials,
+                      summary->no_go_presses, summary->false_starts);
+        return;
+    }
+    
+    Report_Printf("\r\nWrong button: %u\r\n", summary->wrong_buttons);
+    Report_Summary(summary);
+}
+
+void Report_Send(void)
+{
+    // Hands the report to the uDMA transmitter, which copies it into a staging buffer
+    if (report_length > 0)
     {
-        UART0_Output_String("Too slow. Try to be faster!\r\n");
+        UART0_Write_DMA(report_buffer, report_length);
+        report_length = 0;
     }
 }
\ No newline at end of file